@@ -5,6 +5,7 @@
 
 #include <gtest/gtest.h>
 
+#include "integration_test_helpers.h"
 #include "irata2/assembler/assembler.h"
 #include "irata2/sim/cpu.h"
 #include "irata2/sim/initialization.h"
@@ -30,19 +31,21 @@ sim::io::ImageBackend ExecuteAndRender(const std::string& source,
 
   // Create region factory for VGC
   sim::io::ImageBackend* backend_ptr = nullptr;
+  sim::io::VectorGraphicsCoprocessor* vgc_ptr = nullptr;
   std::vector<sim::memory::Memory::RegionFactory> factories;
 
-  factories.push_back([&backend_ptr](sim::memory::Memory& mem,
-                                     sim::LatchedProcessControl&)
+  factories.push_back([&backend_ptr, &vgc_ptr](sim::memory::Memory& mem,
+                                               sim::LatchedProcessControl&)
                           -> std::unique_ptr<sim::memory::Region> {
     return std::make_unique<sim::memory::Region>(
         "vgc", mem, base::Word{0x4100},
-        [&backend_ptr](sim::memory::Region& region)
+        [&backend_ptr, &vgc_ptr](sim::memory::Region& region)
             -> std::unique_ptr<sim::memory::Module> {
           auto backend = std::make_unique<sim::io::ImageBackend>();
           backend_ptr = backend.get();
           auto vgc = std::make_unique<sim::io::VectorGraphicsCoprocessor>(
               "vgc", region, std::move(backend));
+          vgc_ptr = vgc.get();
           return vgc;
         });
   });
@@ -57,8 +60,14 @@ sim::io::ImageBackend ExecuteAndRender(const std::string& source,
   cpu.controller().ir().set_value(cpu.memory().ReadAt(result.header.entry));
 
   // Run until halt
+  ScopedMicrocodeCoverage coverage(cpu);
   auto run_result = cpu.RunUntilHalt(max_cycles, false);
 
+  // Programs may halt mid-frame; push any batched commands to the backend.
+  if (vgc_ptr) {
+    vgc_ptr->Flush();
+  }
+
   // Return the backend (copy it out before CPU is destroyed)
   EXPECT_NE(backend_ptr, nullptr) << "VGC backend was not created";
   if (backend_ptr) {
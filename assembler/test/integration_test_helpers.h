@@ -2,16 +2,69 @@
 #define IRATA2_ASSEMBLER_TEST_INTEGRATION_TEST_HELPERS_H
 
 #include "irata2/assembler/assembler.h"
+#include "irata2/microcode/debug/profile.h"
 #include "irata2/sim/cpu.h"
 #include "irata2/sim/initialization.h"
 #include "irata2/base/types.h"
 #include <gtest/gtest.h>
+#include <algorithm>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
 #include <optional>
+#include <set>
 #include <string>
 #include <vector>
 
 namespace irata2::assembler::test {
 
+/**
+ * @brief Record the microcode entries a test executes.
+ *
+ * Does nothing unless IRATA2_MICROCODE_COVERAGE_DIR is set (the
+ * IRATA2_GUEST_COVERAGE build option sets it for ctest). Then the CPU's
+ * controller records a profile that is written to
+ * <dir>/<Suite>.<Test>.prof when this goes out of scope, for
+ * microcode_dump --coverage. The first write in a process replaces the
+ * file and later ones append, so a rerun does not add to old counts.
+ */
+class ScopedMicrocodeCoverage {
+ public:
+  explicit ScopedMicrocodeCoverage(sim::Cpu& cpu) : cpu_(cpu) {
+    const char* dir = std::getenv("IRATA2_MICROCODE_COVERAGE_DIR");
+    const auto* info = ::testing::UnitTest::GetInstance()->current_test_info();
+    if (!dir || *dir == '\0' || !info) {
+      return;
+    }
+    std::string name =
+        std::string(info->test_suite_name()) + "." + info->name() + ".prof";
+    std::replace(name.begin(), name.end(), '/', '_');
+    path_ = std::filesystem::path(dir) / name;
+    cpu_.controller().set_microcode_profile(&profile_);
+  }
+
+  ~ScopedMicrocodeCoverage() {
+    if (path_.empty()) {
+      return;
+    }
+    cpu_.controller().set_microcode_profile(nullptr);
+    std::filesystem::create_directories(path_.parent_path());
+    // Profiles read back summed, so several runs in one test can append.
+    static std::set<std::filesystem::path> written;
+    const bool first = written.insert(path_).second;
+    std::ofstream out(path_, first ? std::ios::trunc : std::ios::app);
+    profile_.Write(out);
+  }
+
+  ScopedMicrocodeCoverage(const ScopedMicrocodeCoverage&) = delete;
+  ScopedMicrocodeCoverage& operator=(const ScopedMicrocodeCoverage&) = delete;
+
+ private:
+  sim::Cpu& cpu_;
+  microcode::debug::MicrocodeProfile profile_;
+  std::filesystem::path path_;
+};
+
 /**
  * @brief Run assembled code with safety timeout.
  *
@@ -38,6 +91,7 @@ inline sim::Cpu::RunResult RunAsm(
 
   // Set entry point to ROM start (0x8000)
   cpu.pc().set_value(base::Word{0x8000});
+  ScopedMicrocodeCoverage coverage(cpu);
 
   // Run with timeout and capture state
   auto run_result = cpu.RunUntilHalt(max_cycles, /*capture_state=*/true);
@@ -0,0 +1,127 @@
+#ifndef IRATA2_BASE_SPSC_QUEUE_H
+#define IRATA2_BASE_SPSC_QUEUE_H
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <algorithm>
+#include <optional>
+#include <span>
+#include <utility>
+
+namespace irata2::base {
+
+/**
+ * @brief Bounded lock-free single-producer/single-consumer queue.
+ *
+ * Exactly one thread may call TryPush() and exactly one other thread may
+ * call TryPop(). Neither side ever blocks: a full queue rejects the push and
+ * an empty queue yields nothing, leaving the caller to decide whether to
+ * drop, retry, or reuse the previous value.
+ *
+ * Indices grow monotonically and are masked into the slot array, so
+ * Capacity must be a power of two. The producer and consumer indices live
+ * on separate cache lines to avoid false sharing.
+ *
+ * @tparam T Element type; must be default-constructible and movable
+ * @tparam Capacity Maximum number of queued elements (power of two)
+ */
+template <typename T, size_t Capacity>
+class SpscQueue {
+  static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0,
+                "SpscQueue capacity must be a power of two");
+
+ public:
+  static constexpr size_t kCapacity = Capacity;
+
+  /**
+   * @brief Enqueue a value (producer thread only).
+   * @return false if the queue was full; @p value is left untouched
+   */
+  bool TryPush(T&& value) {
+    const size_t head = head_.load(std::memory_order_relaxed);
+    if (head - tail_.load(std::memory_order_acquire) == Capacity) {
+      return false;
+    }
+    slots_[head & kMask] = std::move(value);
+    head_.store(head + 1, std::memory_order_release);
+    return true;
+  }
+
+  bool TryPush(const T& value) {
+    T copy = value;
+    return TryPush(std::move(copy));
+  }
+
+  /**
+   * @brief Dequeue the oldest value (consumer thread only).
+   * @return The value, or std::nullopt if the queue was empty
+   */
+  std::optional<T> TryPop() {
+    const size_t tail = tail_.load(std::memory_order_relaxed);
+    if (tail == head_.load(std::memory_order_acquire)) {
+      return std::nullopt;
+    }
+    std::optional<T> value(std::move(slots_[tail & kMask]));
+    tail_.store(tail + 1, std::memory_order_release);
+    return value;
+  }
+
+  /**
+   * @brief Enqueue as many of @p values as fit (producer thread only).
+   *
+   * Publishes the whole run with a single release store, so streaming
+   * small elements such as audio samples costs one synchronization per
+   * batch rather than per element.
+   *
+   * @return Number of leading elements of @p values that were enqueued
+   */
+  size_t PushSome(std::span<const T> values) {
+    const size_t head = head_.load(std::memory_order_relaxed);
+    const size_t free =
+        Capacity - (head - tail_.load(std::memory_order_acquire));
+    const size_t count = std::min(free, values.size());
+    for (size_t i = 0; i < count; ++i) {
+      slots_[(head + i) & kMask] = values[i];
+    }
+    head_.store(head + count, std::memory_order_release);
+    return count;
+  }
+
+  /**
+   * @brief Dequeue up to @p out.size() values (consumer thread only).
+   * @return Number of elements written to the front of @p out
+   */
+  size_t PopSome(std::span<T> out) {
+    const size_t tail = tail_.load(std::memory_order_relaxed);
+    const size_t available = head_.load(std::memory_order_acquire) - tail;
+    const size_t count = std::min(available, out.size());
+    for (size_t i = 0; i < count; ++i) {
+      out[i] = std::move(slots_[(tail + i) & kMask]);
+    }
+    tail_.store(tail + count, std::memory_order_release);
+    return count;
+  }
+
+  /**
+   * @brief Approximate element count; exact only when both sides are idle.
+   */
+  size_t size() const {
+    return head_.load(std::memory_order_acquire) -
+           tail_.load(std::memory_order_acquire);
+  }
+
+  bool empty() const { return size() == 0; }
+
+ private:
+  static constexpr size_t kMask = Capacity - 1;
+  static constexpr size_t kCacheLine = 64;
+
+  alignas(kCacheLine) std::atomic<size_t> head_{0};
+  alignas(kCacheLine) std::atomic<size_t> tail_{0};
+  alignas(kCacheLine) std::array<T, Capacity> slots_{};
+};
+
+}  // namespace irata2::base
+
+#endif  // IRATA2_BASE_SPSC_QUEUE_H
@@ -0,0 +1,99 @@
+#include "irata2/base/spsc_queue.h"
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <memory>
+#include <thread>
+
+using namespace irata2::base;
+
+TEST(SpscQueueTest, StartsEmpty) {
+  SpscQueue<int, 4> queue;
+  EXPECT_TRUE(queue.empty());
+  EXPECT_FALSE(queue.TryPop().has_value());
+}
+
+TEST(SpscQueueTest, PopsInFifoOrder) {
+  SpscQueue<int, 4> queue;
+  EXPECT_TRUE(queue.TryPush(1));
+  EXPECT_TRUE(queue.TryPush(2));
+  EXPECT_TRUE(queue.TryPush(3));
+  EXPECT_EQ(queue.size(), 3u);
+
+  EXPECT_EQ(queue.TryPop(), 1);
+  EXPECT_EQ(queue.TryPop(), 2);
+  EXPECT_EQ(queue.TryPop(), 3);
+  EXPECT_TRUE(queue.empty());
+}
+
+TEST(SpscQueueTest, RejectsPushWhenFullAndKeepsValue) {
+  SpscQueue<std::unique_ptr<int>, 2> queue;
+  EXPECT_TRUE(queue.TryPush(std::make_unique<int>(1)));
+  EXPECT_TRUE(queue.TryPush(std::make_unique<int>(2)));
+
+  auto extra = std::make_unique<int>(3);
+  EXPECT_FALSE(queue.TryPush(std::move(extra)));
+  ASSERT_NE(extra, nullptr);
+  EXPECT_EQ(*extra, 3);
+
+  EXPECT_EQ(*queue.TryPop().value(), 1);
+  EXPECT_TRUE(queue.TryPush(std::move(extra)));
+  EXPECT_EQ(*queue.TryPop().value(), 2);
+  EXPECT_EQ(*queue.TryPop().value(), 3);
+}
+
+TEST(SpscQueueTest, WrapsAroundManyTimes) {
+  SpscQueue<int, 4> queue;
+  for (int i = 0; i < 100; ++i) {
+    ASSERT_TRUE(queue.TryPush(i));
+    ASSERT_EQ(queue.TryPop(), i);
+  }
+}
+
+TEST(SpscQueueTest, BulkPushAndPopStopAtCapacity) {
+  SpscQueue<int16_t, 8> queue;
+  const int16_t samples[] = {1, 2, 3, 4, 5, 6, 7, 8, 9, 10};
+  EXPECT_EQ(queue.PushSome(samples), 8u);
+  EXPECT_EQ(queue.PushSome(samples), 0u);
+
+  int16_t out[5] = {};
+  EXPECT_EQ(queue.PopSome(out), 5u);
+  EXPECT_EQ(out[0], 1);
+  EXPECT_EQ(out[4], 5);
+
+  // Wraps past the end of the slot array.
+  EXPECT_EQ(queue.PushSome(std::span<const int16_t>(samples + 8, 2)), 2u);
+  int16_t rest[8] = {};
+  EXPECT_EQ(queue.PopSome(rest), 5u);
+  EXPECT_EQ(rest[0], 6);
+  EXPECT_EQ(rest[2], 8);
+  EXPECT_EQ(rest[3], 9);
+  EXPECT_EQ(rest[4], 10);
+  EXPECT_TRUE(queue.empty());
+}
+
+TEST(SpscQueueTest, TransfersAcrossThreadsInOrder) {
+  constexpr uint32_t kCount = 100000;
+  SpscQueue<uint32_t, 64> queue;
+
+  std::thread producer([&queue] {
+    for (uint32_t i = 0; i < kCount; ++i) {
+      while (!queue.TryPush(i)) {
+        std::this_thread::yield();
+      }
+    }
+  });
+
+  uint32_t expected = 0;
+  while (expected < kCount) {
+    if (auto value = queue.TryPop()) {
+      ASSERT_EQ(*value, expected);
+      ++expected;
+    } else {
+      std::this_thread::yield();
+    }
+  }
+  producer.join();
+  EXPECT_TRUE(queue.empty());
+}
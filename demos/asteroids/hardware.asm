@@ -28,6 +28,9 @@
 .equ CMD_CLEAR,     $01     ; Clear screen
 .equ CMD_POINT,     $02     ; Draw point
 .equ CMD_LINE,      $03     ; Draw line
+.equ CMD_SHAPE,     $04     ; Draw shape X1 at (X0, Y0), rotation Y1
+.equ CMD_GLYPH,     $05     ; Draw character X1 at (X0, Y0)
+.equ CMD_TEXT,      $06     ; Draw NUL-terminated string at X1/Y1 (lo/hi)
 
 ; VGC Colors
 .equ COLOR_BLACK,   $00     ; Black (background)
@@ -35,6 +38,34 @@
 .equ COLOR_MED,     $02     ; Medium (bullets, asteroids)
 .equ COLOR_WHITE,   $03     ; White (ship)
 
+.equ VGC_STREAM,    $4109   ; Packed command port (6 bytes per command)
+.equ VGC_DL_LO,     $410A   ; Display list address low byte
+.equ VGC_DL_HI,     $410B   ; Display list address high byte
+.equ VGC_DL_COUNT,  $410C   ; Run N packed commands from display list
+.equ VGC_SHAPE_LO,  $410D   ; Shape definition address low byte
+.equ VGC_SHAPE_HI,  $410E   ; Shape definition address high byte
+.equ VGC_SHAPE_LOAD, $410F  ; Copy definition into shape slot N (0-31)
+.equ VGC_SCALE,     $4110   ; Shape/text scale, 4.4 fixed ($10 = 1.0)
+
+; ----------------------------------------------------------------------------
+; DMA Controller Registers
+; ----------------------------------------------------------------------------
+.equ DMA_SRC_LO,    $4300   ; Source address low byte
+.equ DMA_SRC_HI,    $4301   ; Source address high byte
+.equ DMA_DST_LO,    $4302   ; Destination address low byte
+.equ DMA_DST_HI,    $4303   ; Destination address high byte
+.equ DMA_LEN_LO,    $4304   ; Length low byte
+.equ DMA_LEN_HI,    $4305   ; Length high byte
+.equ DMA_FILL,      $4306   ; Fill value
+.equ DMA_MODE,      $4307   ; Transfer mode
+.equ DMA_CONTROL,   $4308   ; Bit 0: start, bit 7: IRQ enable
+.equ DMA_STATUS,    $4309   ; Bit 0: busy, bit 7: IRQ pending (read acks)
+
+; DMA Modes
+.equ DMA_COPY,      $00     ; Block copy SRC -> DST
+.equ DMA_MODE_FILL, $01     ; Fill DST with DMA_FILL
+.equ DMA_STREAM,    $02     ; Stream SRC bytes into fixed port at DST
+
 ; ----------------------------------------------------------------------------
 ; Input Registers
 ; ----------------------------------------------------------------------------
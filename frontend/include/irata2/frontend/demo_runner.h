@@ -1,16 +1,26 @@
 #ifndef IRATA2_FRONTEND_DEMO_RUNNER_H
 #define IRATA2_FRONTEND_DEMO_RUNNER_H
 
+#include <atomic>
 #include <cstdint>
+#include <exception>
+#include <fstream>
 #include <memory>
 #include <string>
 
 #include <SDL.h>
 
 #include "irata2/base/types.h"
+#include "irata2/frontend/sdl_audio.h"
+#include "irata2/frontend/sdl_backend.h"
 #include "irata2/sim/cpu.h"
+#include "irata2/sim/frame_budget.h"
+#include "irata2/sim/frame_pacer.h"
 #include "irata2/sim/io/input_device.h"
+#include "irata2/sim/io/queue_backend.h"
+#include "irata2/sim/io/sound_device.h"
 #include "irata2/sim/io/vector_graphics_coprocessor.h"
+#include "irata2/sim/io/vgc_capture.h"
 
 namespace irata2::frontend {
 
@@ -21,10 +31,62 @@ struct DemoOptions {
   int64_t cycles_per_frame = 0;
   bool debug_on_crash = false;
   size_t trace_size = 0;
+  sim::PacingMode pacing = sim::PacingMode::Realtime;
+  int turbo_factor = 4;
+  bool frame_stats = false;
+  bool latency_stats = false;
+  bool frame_budget = false;
+  std::string debug_path;
+  bool frame_sync = true;
+  int run_ahead = 0;
+  bool texture_present = false;
+  double phosphor_decay = 0.0;
+  std::string vgc_capture_path;
+  bool audio = true;
 };
 
+/// Runs a cartridge in an SDL window.
+///
+/// The CPU runs on its own emulation thread. VGC frames leave it through a
+/// QueueBackend and are replayed into an SdlBackend on the SDL thread, and
+/// keyboard events travel the other way through the InputDevice's host
+/// event ring, which the device drains at the start of each tick. A slow
+/// present or vsync stall therefore never holds up emulation, and while
+/// emulation catches up the window keeps showing the last complete frame.
+///
+/// Pacing is handled by a FramePacer on the emulation thread. F1/F2/F3
+/// switch between realtime, turbo (pressing F2 again doubles the factor, up
+/// to 16x) and unthrottled; F4 toggles once-a-second frame-time logging. The
+/// window title shows the current mode and measured frame rate.
+///
+/// With run_ahead set to N (requires frame sync), each host frame runs the
+/// real guest frame invisibly, snapshots the machine, runs N more frames on
+/// the current input, presents the last of them and restores the snapshot.
+/// This costs N extra guest frames of emulation per host frame.
+///
+/// The sound device at $4200 synthesizes each guest frame's audio in one
+/// batch at the end of the frame and hands it to SdlAudio's callback ring.
+///
+/// With vgc_capture_path set, every frame the VGC shows is also logged to a
+/// capture file for irata2_vgc_replay.
+///
+/// With latency_stats set, the CPU's IRQ and input-to-present latency
+/// histograms are logged on exit. Run-ahead speculation is excluded.
+///
+/// With frame_budget set, each guest frame is accounted against
+/// cycles_per_frame by a sim::FrameBudget and the report is logged on exit,
+/// again excluding run-ahead speculation. debug_path names the assembler's
+/// debug JSON, which gives the report's symbols and crash dumps names.
 class DemoRunner {
  public:
+  static constexpr int kMaxTurboFactor = 16;
+  static constexpr double kStatsIntervalSeconds = 1.0;
+  /// With frame sync on, a host frame ends at the guest's PRESENT; this
+  /// many cycles_per_frame quanta is the watchdog for guests that stop
+  /// presenting.
+  static constexpr int64_t kFrameSyncBudgetFrames = 4;
+  static constexpr int kMaxRunAhead = 8;
+
   explicit DemoRunner(DemoOptions options);
   ~DemoRunner();
 
@@ -32,16 +94,52 @@ class DemoRunner {
 
  private:
   DemoOptions options_;
+
+  // Declared before cpu_ so the queue outlives the backend that feeds it.
+  sim::io::QueueBackend::FrameQueue frames_;
+  // Likewise, the capture must outlive the coprocessor that writes to it.
+  std::ofstream vgc_capture_file_;
+  std::unique_ptr<sim::io::VgcCaptureWriter> vgc_capture_;
+  // The sound device's backend pushes into this ring.
+  std::unique_ptr<SdlAudio> audio_;
+
   std::unique_ptr<sim::Cpu> cpu_;
   sim::io::InputDevice* input_device_ = nullptr;
   sim::io::VectorGraphicsCoprocessor* vgc_ = nullptr;
+  std::unique_ptr<sim::FrameBudget> frame_budget_;
+  sim::io::SoundDevice* sound_ = nullptr;
 
   SDL_Window* window_ = nullptr;
   SDL_Renderer* renderer_ = nullptr;
+  std::unique_ptr<SdlBackend> sdl_backend_;
+
+  std::atomic<bool> stop_{false};
+  std::atomic<bool> emulation_done_{false};
+  std::exception_ptr emulation_error_;
 
+  // Written by the SDL thread, read by the emulation thread.
+  std::atomic<sim::PacingMode> pacing_mode_{sim::PacingMode::Realtime};
+  std::atomic<int> turbo_factor_{4};
+  std::atomic<bool> frame_stats_{false};
+  // Written by the emulation thread, read by the SDL thread.
+  std::atomic<double> measured_fps_{0.0};
+
+  // Emulation thread only.
+  sim::Cpu::Snapshot run_ahead_snapshot_;
+
+  // SDL thread
   void HandleEvent(const SDL_Event& event);
+  bool HandleHotkey(SDL_Keycode key);
+  void PushInput(sim::io::HostInputEvent::Kind kind, uint8_t value);
+  void UpdateTitle();
+  bool RenderPendingFrames();
+
+  // Emulation thread
+  void EmulationLoop();
   void TickCpu();
-  void RenderFrame();
+  void RunGuestFrame();
+  sim::Cpu::StopConditions FrameConditions() const;
+
   void ShutdownSdl();
 
   static uint8_t MapKey(SDL_Keycode key);
@@ -0,0 +1,60 @@
+#ifndef IRATA2_FRONTEND_SDL_AUDIO_H
+#define IRATA2_FRONTEND_SDL_AUDIO_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+#include <SDL.h>
+
+#include "irata2/base/spsc_queue.h"
+#include "irata2/sim/io/sound_backend.h"
+
+namespace irata2::frontend {
+
+/// Plays sound-device output through an SDL audio callback.
+///
+/// The emulation thread pushes sample blocks into a lock-free ring through
+/// the backend returned by MakeBackend(); SDL's audio thread drains it in
+/// its callback and pads with silence on underrun. When the ring is full
+/// (turbo, or no audio device) new samples are dropped and counted, so the
+/// producer never waits.
+class SdlAudio {
+ public:
+  static constexpr size_t kRingCapacity = 16384;
+  static constexpr uint16_t kCallbackSamples = 1024;
+  using SampleRing = base::SpscQueue<int16_t, kRingCapacity>;
+
+  /// Opens the default output device if @p open_device is set. Failure to
+  /// open is logged, not fatal: samples are then simply dropped.
+  SdlAudio(uint32_t sample_rate, bool open_device);
+  ~SdlAudio();
+
+  SdlAudio(const SdlAudio&) = delete;
+  SdlAudio& operator=(const SdlAudio&) = delete;
+
+  /// Backend for the SoundDevice; the SdlAudio must outlive it.
+  std::unique_ptr<sim::io::SoundBackend> MakeBackend();
+
+  /// Stop the callback and release the device. Idempotent.
+  void Close();
+
+  bool is_open() const { return device_ != 0; }
+  uint64_t dropped_samples() const { return dropped_samples_; }
+  uint64_t underruns() const { return underruns_; }
+
+ private:
+  class RingBackend;
+
+  static void Callback(void* userdata, Uint8* stream, int length);
+
+  SampleRing ring_;
+  SDL_AudioDeviceID device_ = 0;
+  std::atomic<uint64_t> dropped_samples_{0};
+  std::atomic<uint64_t> underruns_{0};
+};
+
+}  // namespace irata2::frontend
+
+#endif  // IRATA2_FRONTEND_SDL_AUDIO_H
@@ -1,7 +1,11 @@
 #ifndef IRATA2_FRONTEND_SDL_BACKEND_H
 #define IRATA2_FRONTEND_SDL_BACKEND_H
 
+#include <array>
+#include <bitset>
 #include <cstdint>
+#include <span>
+#include <vector>
 
 #include <SDL.h>
 
@@ -9,9 +13,25 @@
 
 namespace irata2::frontend {
 
+struct SdlBackendOptions {
+  /// Rasterize frames on the CPU and upload them through a streaming
+  /// texture instead of issuing one renderer call per primitive run.
+  bool streaming_texture = false;
+  /// Fraction of a pixel's brightness that survives each present, in
+  /// [0, 1). Zero disables phosphor persistence. Texture mode only.
+  double phosphor_decay = 0.0;
+};
+
 class SdlBackend final : public sim::io::VgcBackend {
  public:
-  explicit SdlBackend(SDL_Renderer* renderer);
+  static constexpr size_t kWidth = sim::io::ImageBackend::kWidth;
+  static constexpr size_t kHeight = sim::io::ImageBackend::kHeight;
+
+  explicit SdlBackend(SDL_Renderer* renderer, SdlBackendOptions options = {});
+  ~SdlBackend() override;
+
+  SdlBackend(const SdlBackend&) = delete;
+  SdlBackend& operator=(const SdlBackend&) = delete;
 
   void clear(uint8_t intensity) override;
   void draw_point(uint8_t x, uint8_t y, uint8_t intensity) override;
@@ -22,10 +42,34 @@ class SdlBackend final : public sim::io::VgcBackend {
                  uint8_t intensity) override;
   void present() override;
 
+  /// Draws a frame's worth of commands with one color change per run of
+  /// same-intensity primitives. Consecutive points go out in a single
+  /// SDL_RenderDrawPoints call and chained line segments are merged into
+  /// one SDL_RenderDrawLines polyline.
+  ///
+  /// In texture mode the commands are only recorded; present() rasterizes
+  /// them, converts the rows that changed or are still fading to ARGB, and
+  /// uploads them with a single SDL_UpdateTexture call.
+  void submit(std::span<const sim::io::VgcCommand> commands) override;
+
  private:
   SDL_Renderer* renderer_;
+  std::vector<SDL_Point> points_;
+  std::vector<SDL_Point> path_;
+
+  // Texture mode only.
+  SDL_Texture* texture_ = nullptr;
+  sim::io::ImageBackend image_;
+  uint32_t decay_ = 0;  // brightness multiplier in 1/256ths
+  std::vector<uint8_t> glow_;
+  std::vector<uint32_t> pixels_;
+  std::bitset<kHeight> fading_rows_;
 
   void SetColor(uint8_t intensity);
+  void FlushPoints();
+  void FlushPath();
+  void PresentTexture();
+  bool UpdateRow(size_t y, const uint8_t* levels);
 };
 
 }  // namespace irata2::frontend
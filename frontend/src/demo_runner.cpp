@@ -1,15 +1,19 @@
 #include "irata2/frontend/demo_runner.h"
 
+#include <algorithm>
 #include <chrono>
+#include <cstdio>
 #include <optional>
+#include <sstream>
+#include <thread>
 #include <utility>
 #include <vector>
 #include <stdexcept>
 
-#include "irata2/frontend/sdl_backend.h"
 #include "irata2/sim/cartridge.h"
 #include "irata2/sim/debug_dump.h"
 #include "irata2/sim/initialization.h"
+#include "irata2/sim/io/dma_controller.h"
 
 namespace irata2::frontend {
 
@@ -17,6 +21,7 @@ namespace {
 struct DeviceBundle {
   sim::io::InputDevice* input = nullptr;
   sim::io::VectorGraphicsCoprocessor* vgc = nullptr;
+  sim::io::SoundDevice* sound = nullptr;
 };
 
 void ResetCpu(sim::Cpu& cpu, base::Word entry) {
@@ -30,11 +35,18 @@ DemoRunner::DemoRunner(DemoOptions options) : options_(std::move(options)) {
   if (options_.cycles_per_frame <= 0 && options_.fps > 0) {
     options_.cycles_per_frame = 100000 / options_.fps;
   }
-  if (options_.fps <= 0 || options_.scale <= 0) {
+  if (options_.fps <= 0 || options_.scale <= 0 || options_.turbo_factor < 1 ||
+      options_.run_ahead < 0 || options_.run_ahead > kMaxRunAhead ||
+      options_.phosphor_decay < 0.0 || options_.phosphor_decay >= 1.0) {
     throw std::runtime_error("invalid demo options");
   }
+  pacing_mode_ = options_.pacing;
+  turbo_factor_ = std::min(options_.turbo_factor, kMaxTurboFactor);
+  frame_stats_ = options_.frame_stats;
 
-  if (SDL_Init(SDL_INIT_VIDEO | SDL_INIT_EVENTS) != 0) {
+  const Uint32 subsystems = SDL_INIT_VIDEO | SDL_INIT_EVENTS |
+                            (options_.audio ? SDL_INIT_AUDIO : 0u);
+  if (SDL_Init(subsystems) != 0) {
     throw std::runtime_error(SDL_GetError());
   }
   window_ = SDL_CreateWindow("IRATA2 Demo",
@@ -56,6 +68,15 @@ DemoRunner::DemoRunner(DemoOptions options) : options_(std::move(options)) {
                      static_cast<float>(options_.scale),
                      static_cast<float>(options_.scale));
   SDL_SetRenderDrawBlendMode(renderer_, SDL_BLENDMODE_BLEND);
+  try {
+    sdl_backend_ = std::make_unique<SdlBackend>(
+        renderer_, SdlBackendOptions{options_.texture_present ||
+                                         options_.phosphor_decay > 0.0,
+                                     options_.phosphor_decay});
+  } catch (...) {
+    ShutdownSdl();
+    throw;
+  }
 
   auto cartridge = sim::LoadCartridge(options_.rom_path);
   DeviceBundle bundle;
@@ -75,14 +96,14 @@ DemoRunner::DemoRunner(DemoOptions options) : options_(std::move(options)) {
         });
   });
 
-  factories.push_back([&bundle, renderer = renderer_](sim::memory::Memory& mem,
-                                                      sim::LatchedProcessControl&)
+  factories.push_back([&bundle, &frames = frames_](sim::memory::Memory& mem,
+                                                  sim::LatchedProcessControl&)
                           -> std::unique_ptr<sim::memory::Region> {
     return std::make_unique<sim::memory::Region>(
         "vgc", mem, base::Word{sim::io::VGC_BASE},
-        [&bundle, renderer](sim::memory::Region& region)
+        [&bundle, &frames](sim::memory::Region& region)
             -> std::unique_ptr<sim::memory::Module> {
-          auto backend = std::make_unique<SdlBackend>(renderer);
+          auto backend = std::make_unique<sim::io::QueueBackend>(frames);
           auto device = std::make_unique<sim::io::VectorGraphicsCoprocessor>(
               "vgc", region, std::move(backend));
           bundle.vgc = device.get();
@@ -90,6 +111,37 @@ DemoRunner::DemoRunner(DemoOptions options) : options_(std::move(options)) {
         });
   });
 
+  const sim::io::SoundConfig sound_config;
+  audio_ = std::make_unique<SdlAudio>(sound_config.sample_rate,
+                                      options_.audio);
+  factories.push_back([&bundle, &sound_config, audio = audio_.get()](
+                          sim::memory::Memory& mem,
+                          sim::LatchedProcessControl&)
+                          -> std::unique_ptr<sim::memory::Region> {
+    return std::make_unique<sim::memory::Region>(
+        "sound", mem, base::Word{sim::io::SOUND_BASE},
+        [&bundle, &sound_config, audio](sim::memory::Region& region)
+            -> std::unique_ptr<sim::memory::Module> {
+          auto device = std::make_unique<sim::io::SoundDevice>(
+              "sound", region, audio->MakeBackend(), sound_config);
+          bundle.sound = device.get();
+          return device;
+        });
+  });
+
+  factories.push_back([](sim::memory::Memory& mem,
+                          sim::LatchedProcessControl& irq_line)
+                          -> std::unique_ptr<sim::memory::Region> {
+    return std::make_unique<sim::memory::Region>(
+        "dma", mem, base::Word{sim::io::DMA_BASE},
+        [&irq_line](sim::memory::Region& region)
+            -> std::unique_ptr<sim::memory::Module> {
+          return std::make_unique<sim::io::DmaController>("dma",
+                                                          region,
+                                                          irq_line);
+        });
+  });
+
   cpu_ = std::make_unique<sim::Cpu>(
       sim::DefaultHdl(),
       sim::DefaultMicrocodeProgram(),
@@ -97,11 +149,34 @@ DemoRunner::DemoRunner(DemoOptions options) : options_(std::move(options)) {
       std::move(factories));
   input_device_ = bundle.input;
   vgc_ = bundle.vgc;
+  sound_ = bundle.sound;
+
+  if (!options_.vgc_capture_path.empty()) {
+    vgc_capture_file_.open(options_.vgc_capture_path, std::ios::binary);
+    if (!vgc_capture_file_) {
+      throw std::runtime_error("failed to open VGC capture: " +
+                               options_.vgc_capture_path);
+    }
+    vgc_capture_ = std::make_unique<sim::io::VgcCaptureWriter>(
+        vgc_capture_file_);
+    vgc_->set_capture(vgc_capture_.get());
+  }
 
   ResetCpu(*cpu_, cartridge.header.entry);
   if (options_.trace_size > 0) {
     cpu_->EnableTrace(options_.trace_size);
   }
+  if (!options_.debug_path.empty()) {
+    cpu_->LoadDebugSymbols(sim::LoadDebugSymbols(options_.debug_path));
+  }
+  cpu_->set_latency_tracking(options_.latency_stats);
+  if (options_.frame_budget) {
+    frame_budget_ = std::make_unique<sim::FrameBudget>(
+        static_cast<uint64_t>(options_.cycles_per_frame));
+    frame_budget_->SetSymbols(cpu_->debug_symbols());
+    frame_budget_->AttachVgc(vgc_);
+    cpu_->AttachFrameBudget(frame_budget_.get());
+  }
 }
 
 DemoRunner::~DemoRunner() {
@@ -109,53 +184,75 @@ DemoRunner::~DemoRunner() {
 }
 
 int DemoRunner::Run() {
-  bool running = true;
-  auto last_frame = std::chrono::steady_clock::now();
+  stop_ = false;
+  emulation_done_ = false;
+  std::thread emulation([this] { EmulationLoop(); });
 
-  while (running) {
+  auto last_title = std::chrono::steady_clock::now();
+  UpdateTitle();
+  while (!stop_ && !emulation_done_) {
     SDL_Event event;
     while (SDL_PollEvent(&event)) {
       if (event.type == SDL_QUIT) {
-        running = false;
+        stop_ = true;
         break;
       }
       HandleEvent(event);
     }
 
-    TickCpu();
-    RenderFrame();
-
-    auto now = std::chrono::steady_clock::now();
-    const auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
-        now - last_frame);
-    const auto frame_ms = std::chrono::milliseconds(1000 / options_.fps);
-    if (elapsed < frame_ms) {
-      SDL_Delay(static_cast<uint32_t>((frame_ms - elapsed).count()));
+    if (!RenderPendingFrames()) {
+      // Nothing new to show; the window keeps the last presented frame.
+      SDL_Delay(1);
     }
-    last_frame = std::chrono::steady_clock::now();
 
-    if (cpu_->halted()) {
-      running = false;
+    const auto now = std::chrono::steady_clock::now();
+    if (now - last_title >= std::chrono::milliseconds(500)) {
+      UpdateTitle();
+      last_title = now;
     }
   }
 
+  stop_ = true;
+  emulation.join();
+  RenderPendingFrames();
+  if (vgc_capture_) {
+    vgc_capture_->Flush();
+  }
+  if (options_.latency_stats) {
+    std::ostringstream report;
+    cpu_->latency_stats().WriteText(report);
+    SDL_Log("latency (cycles):\n%s", report.str().c_str());
+  }
+  if (frame_budget_) {
+    std::ostringstream report;
+    frame_budget_->WriteText(report);
+    SDL_Log("frame budget (cycles):\n%s", report.str().c_str());
+  }
+
+  if (emulation_error_) {
+    std::rethrow_exception(emulation_error_);
+  }
   return cpu_->crashed() ? 2 : 0;
 }
 
 void DemoRunner::HandleEvent(const SDL_Event& event) {
   // Handle key down events
   if (event.type == SDL_KEYDOWN) {
+    if (!event.key.repeat && HandleHotkey(event.key.keysym.sym)) {
+      return;
+    }
+
     // Update key state bitmask for continuous input detection
     const uint8_t state_bit = MapKeyToState(event.key.keysym.sym);
-    if (state_bit != 0 && input_device_) {
-      input_device_->set_key_down(state_bit);
+    if (state_bit != 0) {
+      PushInput(sim::io::HostInputEvent::Kind::KeyDown, state_bit);
     }
 
     // Queue key press events (but not repeats)
     if (!event.key.repeat) {
       const uint8_t code = MapKey(event.key.keysym.sym);
-      if (code != 0x00 && input_device_) {
-        input_device_->inject_key(code);
+      if (code != 0x00) {
+        PushInput(sim::io::HostInputEvent::Kind::KeyPress, code);
       }
     }
     return;
@@ -164,27 +261,188 @@ void DemoRunner::HandleEvent(const SDL_Event& event) {
   // Handle key up events for key state tracking
   if (event.type == SDL_KEYUP) {
     const uint8_t state_bit = MapKeyToState(event.key.keysym.sym);
-    if (state_bit != 0 && input_device_) {
-      input_device_->set_key_up(state_bit);
+    if (state_bit != 0) {
+      PushInput(sim::io::HostInputEvent::Kind::KeyUp, state_bit);
     }
     return;
   }
 }
 
+bool DemoRunner::HandleHotkey(SDL_Keycode key) {
+  switch (key) {
+    case SDLK_F1:
+      pacing_mode_ = sim::PacingMode::Realtime;
+      break;
+    case SDLK_F2:
+      if (pacing_mode_ == sim::PacingMode::Turbo) {
+        const int next = turbo_factor_ * 2;
+        turbo_factor_ = next > kMaxTurboFactor ? 2 : next;
+      }
+      pacing_mode_ = sim::PacingMode::Turbo;
+      break;
+    case SDLK_F3:
+      pacing_mode_ = sim::PacingMode::Unthrottled;
+      break;
+    case SDLK_F4:
+      frame_stats_ = !frame_stats_;
+      break;
+    default:
+      return false;
+  }
+  UpdateTitle();
+  return true;
+}
+
+void DemoRunner::UpdateTitle() {
+  const sim::PacingMode mode = pacing_mode_;
+  std::string label = sim::ToString(mode);
+  if (mode == sim::PacingMode::Turbo) {
+    label += " " + std::to_string(turbo_factor_.load()) + "x";
+  }
+  char title[96];
+  std::snprintf(title, sizeof(title), "IRATA2 Demo - %s - %.1f fps",
+                label.c_str(), measured_fps_.load());
+  SDL_SetWindowTitle(window_, title);
+}
+
+void DemoRunner::PushInput(sim::io::HostInputEvent::Kind kind,
+                           uint8_t value) {
+  if (input_device_ && !input_device_->PostHostEvent({kind, value})) {
+    // The guest's own queue is only 16 deep, so a backlog this large means
+    // emulation has stalled; losing keystrokes is the least bad option.
+    SDL_Log("input queue full, dropping event");
+  }
+}
+
+bool DemoRunner::RenderPendingFrames() {
+  // Only the newest frame is worth drawing, but every queued frame must be
+  // replayed because a frame need not start with a clear.
+  bool rendered = false;
+  while (auto frame = frames_.TryPop()) {
+    sdl_backend_->submit(frame->commands);
+    rendered = true;
+  }
+  if (rendered) {
+    sdl_backend_->present();
+  }
+  return rendered;
+}
+
+void DemoRunner::EmulationLoop() {
+  try {
+    sim::FramePacer pacer(options_.fps);
+    auto window_start = sim::FramePacer::Clock::now();
+
+    while (!stop_) {
+      pacer.set_mode(pacing_mode_);
+      pacer.set_turbo_factor(turbo_factor_);
+
+      TickCpu();
+      if (cpu_->halted()) {
+        break;
+      }
+      pacer.WaitForNextFrame();
+
+      const auto now = sim::FramePacer::Clock::now();
+      const double window =
+          std::chrono::duration<double>(now - window_start).count();
+      if (window >= kStatsIntervalSeconds) {
+        const sim::FrameStats& stats = pacer.stats();
+        measured_fps_ = static_cast<double>(stats.frames) / window;
+        if (frame_stats_) {
+          SDL_Log("frame stats (%s): %s", sim::ToString(pacer.mode()).c_str(),
+                  stats.Format().c_str());
+        }
+        pacer.ResetStats();
+        window_start = now;
+      }
+    }
+  } catch (...) {
+    emulation_error_ = std::current_exception();
+  }
+  emulation_done_ = true;
+}
+
 void DemoRunner::TickCpu() {
-  auto result = cpu_->RunUntilHalt(
-      static_cast<uint64_t>(options_.cycles_per_frame));
+  if (options_.run_ahead <= 0 || !options_.frame_sync || !vgc_) {
+    RunGuestFrame();
+    return;
+  }
+
+  // Run-ahead: advance the real frame with its output hidden, then run
+  // speculative frames on the same input and show only the last one. The
+  // player sees the machine run_ahead frames in the future, which hides
+  // that many frames of the guest's polling latency. Restoring the
+  // snapshot discards the speculation, so guest-visible state only ever
+  // advances by the real frame.
+  // Audio follows the real frame only; speculative frames would otherwise
+  // be heard and then heard again once they actually happen.
+  vgc_->set_output_enabled(false);
+  RunGuestFrame();
+  if (cpu_->halted()) {
+    vgc_->set_output_enabled(true);
+    return;
+  }
+
+  cpu_->SaveSnapshot(run_ahead_snapshot_);
+  if (sound_) {
+    sound_->set_output_enabled(false);
+  }
+  // Input arriving now belongs to the next real frame; the rollback would
+  // lose it.
+  if (input_device_) {
+    input_device_->set_host_events_enabled(false);
+  }
+  cpu_->set_latency_tracking(false);
+  cpu_->AttachFrameBudget(nullptr);
+  for (int i = 1; i <= options_.run_ahead && !cpu_->halted(); ++i) {
+    vgc_->set_output_enabled(i == options_.run_ahead);
+    cpu_->RunUntil(FrameConditions());
+  }
+  cpu_->RestoreSnapshot(run_ahead_snapshot_);
+  cpu_->set_latency_tracking(options_.latency_stats);
+  if (frame_budget_) {
+    frame_budget_->Resync(*cpu_);
+    cpu_->AttachFrameBudget(frame_budget_.get());
+  }
+  vgc_->set_output_enabled(true);
+  if (sound_) {
+    sound_->set_output_enabled(true);
+  }
+  if (input_device_) {
+    input_device_->set_host_events_enabled(true);
+  }
+}
+
+sim::Cpu::StopConditions DemoRunner::FrameConditions() const {
+  // Run exactly one guest frame: stop on PRESENT so a frame is never split
+  // across host frames or drawn twice. Without frame sync, fall back to a
+  // fixed cycle quantum.
+  sim::Cpu::StopConditions conditions;
+  conditions.frame_presented = options_.frame_sync;
+  conditions.max_cycles = static_cast<uint64_t>(
+      options_.frame_sync
+          ? options_.cycles_per_frame * kFrameSyncBudgetFrames
+          : options_.cycles_per_frame);
+  return conditions;
+}
+
+void DemoRunner::RunGuestFrame() {
+  auto result = cpu_->RunUntil(FrameConditions());
+  if (sound_) {
+    sound_->Sync();
+  }
   if (result.reason == sim::Cpu::HaltReason::Crash && options_.debug_on_crash) {
     const std::string dump = sim::FormatDebugDump(*cpu_, "crash");
     SDL_Log("%s", dump.c_str());
   }
 }
 
-void DemoRunner::RenderFrame() {
-  (void)vgc_;
-}
-
 void DemoRunner::ShutdownSdl() {
+  if (audio_) {
+    audio_->Close();
+  }
+  sdl_backend_.reset();
   if (renderer_) {
     SDL_DestroyRenderer(renderer_);
     renderer_ = nullptr;
@@ -10,7 +10,12 @@ void PrintUsage(const char* argv0) {
   std::cerr << "Usage: " << argv0
             << " --rom <cartridge.bin>"
             << " [--fps N] [--scale N] [--cycles-per-frame N]"
-            << " [--debug-on-crash] [--trace-size N]\n";
+            << " [--debug-on-crash] [--trace-size N]"
+            << " [--turbo N | --unthrottled] [--frame-stats] [--latency-stats]"
+            << " [--frame-budget] [--debug <debug.json>]"
+            << " [--no-frame-sync] [--run-ahead N]"
+            << " [--texture] [--phosphor DECAY]"
+            << " [--capture-vgc <capture.vgc>] [--no-audio]\n";
 }
 
 std::optional<int64_t> ParseI64(const std::string& value) {
@@ -25,6 +30,19 @@ std::optional<int64_t> ParseI64(const std::string& value) {
     return std::nullopt;
   }
 }
+
+std::optional<double> ParseDouble(const std::string& value) {
+  try {
+    size_t idx = 0;
+    double parsed = std::stod(value, &idx);
+    if (idx != value.size()) {
+      return std::nullopt;
+    }
+    return parsed;
+  } catch (const std::exception&) {
+    return std::nullopt;
+  }
+}
 }  // namespace
 
 int main(int argc, char** argv) {
@@ -96,6 +114,93 @@ int main(int argc, char** argv) {
       options.trace_size = static_cast<size_t>(*parsed);
       continue;
     }
+    if (arg == "--turbo") {
+      if (i + 1 >= argc) {
+        PrintUsage(argv[0]);
+        return 1;
+      }
+      auto parsed = ParseI64(argv[++i]);
+      if (!parsed || *parsed < 1 ||
+          *parsed > irata2::frontend::DemoRunner::kMaxTurboFactor) {
+        std::cerr << "Invalid turbo factor\n";
+        return 1;
+      }
+      options.pacing = irata2::sim::PacingMode::Turbo;
+      options.turbo_factor = static_cast<int>(*parsed);
+      continue;
+    }
+    if (arg == "--unthrottled") {
+      options.pacing = irata2::sim::PacingMode::Unthrottled;
+      continue;
+    }
+    if (arg == "--frame-stats") {
+      options.frame_stats = true;
+      continue;
+    }
+    if (arg == "--latency-stats") {
+      options.latency_stats = true;
+      continue;
+    }
+    if (arg == "--frame-budget") {
+      options.frame_budget = true;
+      continue;
+    }
+    if (arg == "--debug") {
+      if (i + 1 >= argc) {
+        PrintUsage(argv[0]);
+        return 1;
+      }
+      options.debug_path = argv[++i];
+      continue;
+    }
+    if (arg == "--no-frame-sync") {
+      options.frame_sync = false;
+      continue;
+    }
+    if (arg == "--run-ahead") {
+      if (i + 1 >= argc) {
+        PrintUsage(argv[0]);
+        return 1;
+      }
+      auto parsed = ParseI64(argv[++i]);
+      if (!parsed || *parsed < 0 ||
+          *parsed > irata2::frontend::DemoRunner::kMaxRunAhead) {
+        std::cerr << "Invalid run-ahead value\n";
+        return 1;
+      }
+      options.run_ahead = static_cast<int>(*parsed);
+      continue;
+    }
+    if (arg == "--capture-vgc") {
+      if (i + 1 >= argc) {
+        PrintUsage(argv[0]);
+        return 1;
+      }
+      options.vgc_capture_path = argv[++i];
+      continue;
+    }
+    if (arg == "--no-audio") {
+      options.audio = false;
+      continue;
+    }
+    if (arg == "--texture") {
+      options.texture_present = true;
+      continue;
+    }
+    if (arg == "--phosphor") {
+      if (i + 1 >= argc) {
+        PrintUsage(argv[0]);
+        return 1;
+      }
+      auto parsed = ParseDouble(argv[++i]);
+      if (!parsed || *parsed < 0.0 || *parsed >= 1.0) {
+        std::cerr << "Invalid phosphor decay value\n";
+        return 1;
+      }
+      options.texture_present = true;
+      options.phosphor_decay = *parsed;
+      continue;
+    }
     PrintUsage(argv[0]);
     return 1;
   }
@@ -0,0 +1,70 @@
+#include "irata2/frontend/sdl_audio.h"
+
+#include <algorithm>
+#include <span>
+
+namespace irata2::frontend {
+
+class SdlAudio::RingBackend final : public sim::io::SoundBackend {
+ public:
+  explicit RingBackend(SdlAudio& audio) : audio_(audio) {}
+
+  void submit(std::span<const int16_t> samples) override {
+    const size_t pushed = audio_.ring_.PushSome(samples);
+    if (pushed < samples.size()) {
+      audio_.dropped_samples_.fetch_add(samples.size() - pushed,
+                                        std::memory_order_relaxed);
+    }
+  }
+
+ private:
+  SdlAudio& audio_;
+};
+
+SdlAudio::SdlAudio(uint32_t sample_rate, bool open_device) {
+  if (!open_device) {
+    return;
+  }
+  SDL_AudioSpec wanted{};
+  wanted.freq = static_cast<int>(sample_rate);
+  wanted.format = AUDIO_S16SYS;
+  wanted.channels = 1;
+  wanted.samples = kCallbackSamples;
+  wanted.callback = &SdlAudio::Callback;
+  wanted.userdata = this;
+  device_ = SDL_OpenAudioDevice(nullptr, 0, &wanted, nullptr, 0);
+  if (device_ == 0) {
+    SDL_Log("audio disabled: %s", SDL_GetError());
+    return;
+  }
+  SDL_PauseAudioDevice(device_, 0);
+}
+
+SdlAudio::~SdlAudio() {
+  Close();
+}
+
+std::unique_ptr<sim::io::SoundBackend> SdlAudio::MakeBackend() {
+  return std::make_unique<RingBackend>(*this);
+}
+
+void SdlAudio::Close() {
+  if (device_ != 0) {
+    SDL_CloseAudioDevice(device_);
+    device_ = 0;
+  }
+}
+
+void SdlAudio::Callback(void* userdata, Uint8* stream, int length) {
+  auto& audio = *static_cast<SdlAudio*>(userdata);
+  const std::span<int16_t> out(reinterpret_cast<int16_t*>(stream),
+                               static_cast<size_t>(length) / sizeof(int16_t));
+  const size_t popped = audio.ring_.PopSome(out);
+  if (popped < out.size()) {
+    std::fill(out.begin() + static_cast<std::ptrdiff_t>(popped), out.end(),
+              int16_t{0});
+    audio.underruns_.fetch_add(1, std::memory_order_relaxed);
+  }
+}
+
+}  // namespace irata2::frontend
@@ -1,15 +1,62 @@
 #include "irata2/frontend/sdl_backend.h"
 
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
 namespace irata2::frontend {
 
-SdlBackend::SdlBackend(SDL_Renderer* renderer) : renderer_(renderer) {}
+namespace {
+// Green channel for each of the four VGC intensity levels.
+constexpr std::array<uint8_t, 4> kGreenLevels = {0, 64, 128, 255};
+
+constexpr uint32_t Argb(uint8_t green) {
+  return 0xFF000000u | (static_cast<uint32_t>(green) << 8);
+}
+}  // namespace
+
+SdlBackend::SdlBackend(SDL_Renderer* renderer, SdlBackendOptions options)
+    : renderer_(renderer) {
+  if (!options.streaming_texture) {
+    return;
+  }
+  if (options.phosphor_decay < 0.0 || options.phosphor_decay >= 1.0) {
+    throw std::invalid_argument("phosphor decay must be in [0, 1)");
+  }
+  texture_ = SDL_CreateTexture(renderer_, SDL_PIXELFORMAT_ARGB8888,
+                               SDL_TEXTUREACCESS_STREAMING,
+                               static_cast<int>(kWidth),
+                               static_cast<int>(kHeight));
+  if (!texture_) {
+    throw std::runtime_error(SDL_GetError());
+  }
+  decay_ = static_cast<uint32_t>(std::lround(options.phosphor_decay * 256.0));
+  glow_.assign(kWidth * kHeight, 0);
+  pixels_.assign(kWidth * kHeight, Argb(0));
+  // The texture starts out undefined, so the first present uploads it all.
+  fading_rows_.set();
+}
+
+SdlBackend::~SdlBackend() {
+  if (texture_) {
+    SDL_DestroyTexture(texture_);
+  }
+}
 
 void SdlBackend::clear(uint8_t intensity) {
+  if (texture_) {
+    image_.clear(intensity);
+    return;
+  }
   SetColor(intensity);
   SDL_RenderClear(renderer_);
 }
 
 void SdlBackend::draw_point(uint8_t x, uint8_t y, uint8_t intensity) {
+  if (texture_) {
+    image_.draw_point(x, y, intensity);
+    return;
+  }
   SetColor(intensity);
   SDL_RenderDrawPoint(renderer_, static_cast<int>(x), static_cast<int>(y));
 }
@@ -19,6 +66,10 @@ void SdlBackend::draw_line(uint8_t x0,
                            uint8_t x1,
                            uint8_t y1,
                            uint8_t intensity) {
+  if (texture_) {
+    image_.draw_line(x0, y0, x1, y1, intensity);
+    return;
+  }
   SetColor(intensity);
   SDL_RenderDrawLine(renderer_,
                      static_cast<int>(x0),
@@ -28,30 +79,122 @@ void SdlBackend::draw_line(uint8_t x0,
 }
 
 void SdlBackend::present() {
+  if (texture_) {
+    PresentTexture();
+  }
   SDL_RenderPresent(renderer_);
 }
 
+void SdlBackend::submit(std::span<const sim::io::VgcCommand> commands) {
+  using sim::io::VgcOp;
+
+  if (texture_) {
+    image_.submit(commands);
+    return;
+  }
+
+  int color = -1;
+  for (const auto& command : commands) {
+    const int level = command.intensity & 0x03;
+    if (level != color) {
+      FlushPoints();
+      FlushPath();
+      SetColor(command.intensity);
+      color = level;
+    }
+
+    switch (command.op) {
+      case VgcOp::Clear:
+        FlushPoints();
+        FlushPath();
+        SDL_RenderClear(renderer_);
+        break;
+      case VgcOp::Point:
+        FlushPath();
+        points_.push_back({command.x0, command.y0});
+        break;
+      case VgcOp::Line: {
+        FlushPoints();
+        const SDL_Point start{command.x0, command.y0};
+        const SDL_Point end{command.x1, command.y1};
+        if (path_.empty() || path_.back().x != start.x ||
+            path_.back().y != start.y) {
+          FlushPath();
+          path_.push_back(start);
+        }
+        path_.push_back(end);
+        break;
+      }
+    }
+  }
+  FlushPoints();
+  FlushPath();
+}
+
+void SdlBackend::FlushPoints() {
+  if (points_.empty()) {
+    return;
+  }
+  SDL_RenderDrawPoints(renderer_, points_.data(),
+                       static_cast<int>(points_.size()));
+  points_.clear();
+}
+
+void SdlBackend::FlushPath() {
+  if (path_.empty()) {
+    return;
+  }
+  SDL_RenderDrawLines(renderer_, path_.data(), static_cast<int>(path_.size()));
+  path_.clear();
+}
+
+void SdlBackend::PresentTexture() {
+  const uint8_t* const levels = image_.framebuffer().data();
+  const std::bitset<kHeight> rows = image_.dirty_rows() | fading_rows_;
+  image_.reset_dirty();
+
+  // Without persistence only rows the frame touched change. With it, rows
+  // keep changing until every pixel has decayed to its current level.
+  size_t first = kHeight;
+  size_t last = 0;
+  for (size_t y = 0; y < kHeight; ++y) {
+    if (!rows.test(y)) {
+      continue;
+    }
+    fading_rows_.set(y, UpdateRow(y, levels));
+    first = std::min(first, y);
+    last = y;
+  }
+
+  if (first < kHeight) {
+    const SDL_Rect rect{0, static_cast<int>(first), static_cast<int>(kWidth),
+                        static_cast<int>(last - first + 1)};
+    SDL_UpdateTexture(texture_, &rect, pixels_.data() + first * kWidth,
+                      static_cast<int>(kWidth * sizeof(uint32_t)));
+  }
+  SDL_RenderCopy(renderer_, texture_, nullptr, nullptr);
+}
+
+bool SdlBackend::UpdateRow(size_t y, const uint8_t* levels) {
+  const size_t offset = y * kWidth;
+  uint8_t* const glow = glow_.data() + offset;
+  uint32_t* const pixels = pixels_.data() + offset;
+  levels += offset;
+
+  bool fading = false;
+  for (size_t x = 0; x < kWidth; ++x) {
+    const uint8_t target = kGreenLevels[levels[x] & 0x03];
+    const auto faded = static_cast<uint8_t>((glow[x] * decay_) >> 8);
+    const uint8_t value = std::max(target, faded);
+    fading |= value != target;
+    glow[x] = value;
+    pixels[x] = Argb(value);
+  }
+  return fading;
+}
+
 void SdlBackend::SetColor(uint8_t intensity) {
-  const uint8_t level = intensity & 0x03;
-  uint8_t green = 0;
-  switch (level) {
-    case 0:
-      green = 0;
-      break;
-    case 1:
-      green = 64;
-      break;
-    case 2:
-      green = 128;
-      break;
-    case 3:
-      green = 255;
-      break;
-    default:
-      green = 0;
-      break;
-  }
-  SDL_SetRenderDrawColor(renderer_, 0, green, 0, 255);
+  SDL_SetRenderDrawColor(renderer_, 0, kGreenLevels[intensity & 0x03], 0, 255);
 }
 
 }  // namespace irata2::frontend
@@ -1,8 +1,10 @@
 #ifndef IRATA2_MICROCODE_DEBUG_DECODER_H
 #define IRATA2_MICROCODE_DEBUG_DECODER_H
 
+#include "irata2/microcode/debug/profile.h"
 #include "irata2/microcode/output/program.h"
 
+#include <cstddef>
 #include <string>
 
 namespace irata2::microcode::debug {
@@ -56,6 +58,34 @@ class MicrocodeDecoder {
    */
   std::string DumpInstructionYaml(uint8_t opcode) const;
 
+  /**
+   * @brief Summarize an execution profile against this program.
+   *
+   * Lists cycles per instruction, the hottest (opcode, step, status)
+   * entries with their controls, and assertions per control, each sorted
+   * by count.
+   *
+   * @param profile Counts recorded by the simulator
+   * @param max_entries Hot entries to list; 0 lists all
+   * @return Multi-line report
+   */
+  std::string DumpProfile(const MicrocodeProfile& profile,
+                          size_t max_entries = 25) const;
+
+  /**
+   * @brief Report which microcode variants a profile exercised.
+   *
+   * A variant is one distinct control word at an (opcode, step); the
+   * status values that select the same word are interchangeable, so a
+   * variant is covered if any of them was executed. Lists overall and
+   * per-instruction coverage, the missing variants of partly covered
+   * instructions, and the instructions never executed.
+   *
+   * @param profile Counts recorded by the simulator, possibly merged
+   * @return Multi-line report
+   */
+  std::string DumpCoverage(const MicrocodeProfile& profile) const;
+
  private:
   const output::MicrocodeProgram& program_;
 
@@ -0,0 +1,58 @@
+#ifndef IRATA2_MICROCODE_DEBUG_PROFILE_H
+#define IRATA2_MICROCODE_DEBUG_PROFILE_H
+
+#include "irata2/microcode/output/program.h"
+
+#include <cstdint>
+#include <istream>
+#include <map>
+#include <ostream>
+#include <vector>
+
+namespace irata2::microcode::debug {
+
+/**
+ * @brief Execution counts per microcode entry.
+ *
+ * The simulator's controller records one count per cycle for the
+ * (opcode, step, status) entry it looked up. Per-control assertion counts
+ * are derived afterwards from the program's control words rather than
+ * counted per cycle, since an entry always asserts the same controls.
+ *
+ * The text format is one "opcode step status count" line per entry (hex
+ * opcode and status, decimal step and count); lines starting with '#' are
+ * comments. Entries are keyed by position, not control names, so a
+ * profile can be read against any compile of the same microcode.
+ */
+class MicrocodeProfile {
+ public:
+  void Record(uint8_t opcode, uint8_t step, uint8_t status) {
+    ++counts_[output::EncodeKey({opcode, step, status})];
+  }
+
+  /// Add another profile's counts, e.g. from a different run.
+  void Merge(const MicrocodeProfile& other);
+
+  /// Counts keyed by output::EncodeKey().
+  const std::map<uint32_t, uint64_t>& counts() const { return counts_; }
+  uint64_t count(output::MicrocodeKey key) const;
+  uint64_t total() const;
+
+  /// Assertions per control, indexed like program.control_paths. Entries
+  /// missing from the program are ignored.
+  std::vector<uint64_t> ControlCounts(
+      const output::MicrocodeProgram& program) const;
+
+  void Write(std::ostream& out) const;
+  /// @throws MicrocodeError on malformed input
+  static MicrocodeProfile Read(std::istream& in);
+  /// @throws MicrocodeError if the file cannot be opened or parsed
+  static MicrocodeProfile ReadFile(const std::string& path);
+
+ private:
+  std::map<uint32_t, uint64_t> counts_;
+};
+
+}  // namespace irata2::microcode::debug
+
+#endif  // IRATA2_MICROCODE_DEBUG_PROFILE_H
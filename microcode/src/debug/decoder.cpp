@@ -1,10 +1,30 @@
 #include "irata2/microcode/debug/decoder.h"
 
+#include "irata2/isa/isa.h"
+
 #include <algorithm>
+#include <iomanip>
+#include <map>
 #include <sstream>
 
 namespace irata2::microcode::debug {
 
+namespace {
+std::string OpcodeName(uint8_t opcode) {
+  const auto info = isa::IsaInfo::GetInstruction(opcode);
+  if (!info) {
+    return "???";
+  }
+  return isa::ToString(info->opcode);
+}
+
+double Percent(uint64_t part, uint64_t total) {
+  return total == 0 ? 0.0
+                    : 100.0 * static_cast<double>(part) /
+                          static_cast<double>(total);
+}
+}  // namespace
+
 MicrocodeDecoder::MicrocodeDecoder(const output::MicrocodeProgram& program)
     : program_(program) {}
 
@@ -258,4 +278,184 @@ std::string MicrocodeDecoder::DumpInstructionYaml(uint8_t opcode) const {
   return output.str();
 }
 
+std::string MicrocodeDecoder::DumpProfile(const MicrocodeProfile& profile,
+                                          size_t max_entries) const {
+  std::ostringstream output;
+  const uint64_t total = profile.total();
+  output << "microcode profile: " << total << " cycles, "
+         << profile.counts().size() << " entries\n";
+
+  // Cycles per instruction
+  std::vector<std::pair<uint8_t, uint64_t>> by_opcode;
+  for (const auto& [encoded_key, count] : profile.counts()) {
+    const uint8_t opcode = (encoded_key >> 16) & 0xFF;
+    if (by_opcode.empty() || by_opcode.back().first != opcode) {
+      by_opcode.emplace_back(opcode, 0);
+    }
+    by_opcode.back().second += count;
+  }
+  std::stable_sort(by_opcode.begin(), by_opcode.end(),
+                   [](const auto& a, const auto& b) {
+                     return a.second > b.second;
+                   });
+  output << "\ninstructions:\n";
+  for (const auto& [opcode, count] : by_opcode) {
+    output << "  " << std::setw(10) << count << "  " << std::fixed
+           << std::setprecision(2) << std::setw(6) << Percent(count, total)
+           << "%  opcode " << std::setw(3) << static_cast<int>(opcode) << "  "
+           << OpcodeName(opcode) << "\n";
+  }
+
+  // Hottest entries
+  std::vector<std::pair<uint32_t, uint64_t>> entries(profile.counts().begin(),
+                                                     profile.counts().end());
+  std::stable_sort(entries.begin(), entries.end(),
+                   [](const auto& a, const auto& b) {
+                     return a.second > b.second;
+                   });
+  if (max_entries != 0 && entries.size() > max_entries) {
+    entries.resize(max_entries);
+  }
+  output << "\nhot entries:\n";
+  for (const auto& [encoded_key, count] : entries) {
+    const uint8_t opcode = (encoded_key >> 16) & 0xFF;
+    const uint8_t step = (encoded_key >> 8) & 0xFF;
+    const uint8_t status = encoded_key & 0xFF;
+    output << "  " << std::setw(10) << count << "  " << std::fixed
+           << std::setprecision(2) << std::setw(6) << Percent(count, total)
+           << "%  " << OpcodeName(opcode) << " step "
+           << static_cast<int>(step) << " status " << DecodeStatusBits(status)
+           << ": [";
+    auto it = program_.table.find(encoded_key);
+    if (it == program_.table.end()) {
+      output << "not in program";
+    } else {
+      const auto controls = DecodeControlWord(it->second);
+      for (size_t i = 0; i < controls.size(); ++i) {
+        if (i > 0) output << ", ";
+        output << controls[i];
+      }
+    }
+    output << "]\n";
+  }
+
+  // Assertions per control
+  const std::vector<uint64_t> control_counts = profile.ControlCounts(program_);
+  std::vector<size_t> order;
+  for (size_t i = 0; i < control_counts.size(); ++i) {
+    if (control_counts[i] != 0) {
+      order.push_back(i);
+    }
+  }
+  std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+    return control_counts[a] > control_counts[b];
+  });
+  output << "\ncontrols (% of cycles asserted):\n";
+  for (size_t index : order) {
+    output << "  " << std::setw(10) << control_counts[index] << "  "
+           << std::fixed << std::setprecision(2) << std::setw(6)
+           << Percent(control_counts[index], total) << "%  "
+           << program_.control_paths[index] << "\n";
+  }
+
+  return output.str();
+}
+
+std::string MicrocodeDecoder::DumpCoverage(
+    const MicrocodeProfile& profile) const {
+  struct Variant {
+    __uint128_t control_word = 0;
+    uint8_t status = 0;  // lowest status selecting this word
+    bool covered = false;
+  };
+  // (opcode << 8 | step) -> variants, ordered so the report is stable.
+  std::map<uint16_t, std::vector<Variant>> steps;
+  for (const auto& [encoded_key, control_word] : program_.table) {
+    const uint16_t position = static_cast<uint16_t>(encoded_key >> 8);
+    const uint8_t status = encoded_key & 0xFF;
+    const bool covered = profile.counts().count(encoded_key) != 0;
+    auto& variants = steps[position];
+    auto it = std::find_if(variants.begin(), variants.end(),
+                           [&](const Variant& variant) {
+                             return variant.control_word == control_word;
+                           });
+    if (it == variants.end()) {
+      variants.push_back({control_word, status, covered});
+    } else {
+      it->status = std::min(it->status, status);
+      it->covered = it->covered || covered;
+    }
+  }
+
+  struct OpcodeCoverage {
+    size_t variants = 0;
+    size_t covered = 0;
+  };
+  std::map<uint8_t, OpcodeCoverage> opcodes;
+  size_t total = 0;
+  size_t covered = 0;
+  for (const auto& [position, variants] : steps) {
+    auto& opcode = opcodes[static_cast<uint8_t>(position >> 8)];
+    for (const auto& variant : variants) {
+      ++opcode.variants;
+      ++total;
+      if (variant.covered) {
+        ++opcode.covered;
+        ++covered;
+      }
+    }
+  }
+  size_t executed = 0;
+  for (const auto& [opcode, coverage] : opcodes) {
+    executed += coverage.covered != 0 ? 1 : 0;
+  }
+
+  std::ostringstream output;
+  output << "microcode coverage: " << covered << "/" << total
+         << " variants (" << std::fixed << std::setprecision(2)
+         << Percent(covered, total) << "%), " << executed << "/"
+         << opcodes.size() << " instructions executed\n";
+
+  output << "\npartly covered:\n";
+  for (const auto& [opcode, coverage] : opcodes) {
+    if (coverage.covered == 0 || coverage.covered == coverage.variants) {
+      continue;
+    }
+    output << "  " << OpcodeName(opcode) << ": " << coverage.covered << "/"
+           << coverage.variants << " variants\n";
+    for (auto it = steps.lower_bound(static_cast<uint16_t>(opcode << 8));
+         it != steps.end() && (it->first >> 8) == opcode; ++it) {
+      std::vector<const Variant*> missing;
+      for (const auto& variant : it->second) {
+        if (!variant.covered) {
+          missing.push_back(&variant);
+        }
+      }
+      std::sort(missing.begin(), missing.end(),
+                [](const Variant* a, const Variant* b) {
+                  return a->status < b->status;
+                });
+      for (const Variant* variant : missing) {
+        output << "    missing step " << (it->first & 0xFF) << " status "
+               << DecodeStatusBits(variant->status) << ": [";
+        const auto controls = DecodeControlWord(variant->control_word);
+        for (size_t i = 0; i < controls.size(); ++i) {
+          if (i > 0) output << ", ";
+          output << controls[i];
+        }
+        output << "]\n";
+      }
+    }
+  }
+
+  output << "\nnot executed:\n";
+  for (const auto& [opcode, coverage] : opcodes) {
+    if (coverage.covered == 0) {
+      output << "  " << OpcodeName(opcode) << "\n";
+    }
+  }
+
+  return output.str();
+}
+
 }  // namespace irata2::microcode::debug
@@ -0,0 +1,104 @@
+#include "irata2/microcode/debug/profile.h"
+
+#include "irata2/microcode/error.h"
+
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+
+namespace irata2::microcode::debug {
+
+void MicrocodeProfile::Merge(const MicrocodeProfile& other) {
+  for (const auto& [key, count] : other.counts_) {
+    counts_[key] += count;
+  }
+}
+
+uint64_t MicrocodeProfile::count(output::MicrocodeKey key) const {
+  auto it = counts_.find(output::EncodeKey(key));
+  return it == counts_.end() ? 0 : it->second;
+}
+
+uint64_t MicrocodeProfile::total() const {
+  uint64_t total = 0;
+  for (const auto& [key, count] : counts_) {
+    total += count;
+  }
+  return total;
+}
+
+std::vector<uint64_t> MicrocodeProfile::ControlCounts(
+    const output::MicrocodeProgram& program) const {
+  std::vector<uint64_t> counts(program.control_paths.size(), 0);
+  for (const auto& [key, count] : counts_) {
+    auto it = program.table.find(key);
+    if (it == program.table.end()) {
+      continue;
+    }
+    for (size_t i = 0; i < counts.size(); ++i) {
+      if ((it->second >> i) & 1U) {
+        counts[i] += count;
+      }
+    }
+  }
+  return counts;
+}
+
+void MicrocodeProfile::Write(std::ostream& out) const {
+  out << "# irata2 microcode profile\n";
+  out << "# opcode step status count\n";
+  for (const auto& [key, count] : counts_) {
+    out << "0x" << std::hex << std::setw(2) << std::setfill('0')
+        << ((key >> 16) & 0xFF) << std::dec << ' ' << ((key >> 8) & 0xFF)
+        << " 0x" << std::hex << std::setw(2) << std::setfill('0')
+        << (key & 0xFF) << std::dec << ' ' << count << '\n';
+  }
+}
+
+MicrocodeProfile MicrocodeProfile::Read(std::istream& in) {
+  MicrocodeProfile profile;
+  std::string line;
+  int line_number = 0;
+  while (std::getline(in, line)) {
+    ++line_number;
+    if (line.empty() || line[0] == '#') {
+      continue;
+    }
+    std::istringstream fields(line);
+    std::string opcode;
+    std::string step;
+    std::string status;
+    std::string count;
+    std::string extra;
+    if (!(fields >> opcode >> step >> status >> count) || (fields >> extra)) {
+      throw MicrocodeError("malformed microcode profile line " +
+                           std::to_string(line_number));
+    }
+    try {
+      const unsigned long opcode_value = std::stoul(opcode, nullptr, 0);
+      const unsigned long step_value = std::stoul(step, nullptr, 0);
+      const unsigned long status_value = std::stoul(status, nullptr, 0);
+      if (opcode_value > 0xFF || step_value > 0xFF || status_value > 0xFF) {
+        throw std::out_of_range("field");
+      }
+      profile.counts_[output::EncodeKey(
+          {static_cast<uint8_t>(opcode_value), static_cast<uint8_t>(step_value),
+           static_cast<uint8_t>(status_value)})] +=
+          std::stoull(count, nullptr, 10);
+    } catch (const std::logic_error&) {
+      throw MicrocodeError("invalid value in microcode profile line " +
+                           std::to_string(line_number));
+    }
+  }
+  return profile;
+}
+
+MicrocodeProfile MicrocodeProfile::ReadFile(const std::string& path) {
+  std::ifstream in(path);
+  if (!in) {
+    throw MicrocodeError("failed to open microcode profile: " + path);
+  }
+  return Read(in);
+}
+
+}  // namespace irata2::microcode::debug
@@ -2,19 +2,28 @@
 #include "irata2/hdl.h"
 #include "irata2/microcode/compiler/compiler.h"
 #include "irata2/microcode/debug/decoder.h"
+#include "irata2/microcode/debug/profile.h"
 #include "irata2/microcode/encoder/control_encoder.h"
 #include "irata2/microcode/encoder/status_encoder.h"
 #include "irata2/microcode/ir/irata_instruction_set.h"
 
 #include <absl/flags/flag.h>
 #include <absl/flags/parse.h>
+#include <algorithm>
 #include <iostream>
 #include <optional>
+#include <string>
+#include <vector>
 
 ABSL_FLAG(std::string, format, "text",
           "Output format: 'text' or 'yaml' (default: text)");
 ABSL_FLAG(std::optional<int>, opcode, std::nullopt,
           "Filter output to specific opcode (default: show all)");
+ABSL_FLAG(std::string, profile, "",
+          "Summarize a profile written by irata2_run --microcode-profile");
+ABSL_FLAG(int, top, 25, "Hot entries listed with --profile (0 = all)");
+ABSL_FLAG(std::vector<std::string>, coverage, {},
+          "Report microcode variants exercised by one or more profiles");
 
 namespace {
 
@@ -24,6 +33,10 @@ void PrintUsage(const char* argv0) {
   std::cerr << "Options:\n";
   std::cerr << "  --format=<text|yaml>  Output format (default: text)\n";
   std::cerr << "  --opcode=<N>          Show only opcode N (default: show all)\n";
+  std::cerr << "  --profile=<run.prof>  Summarize a recorded execution profile\n";
+  std::cerr << "  --top=<N>             Hot entries listed with --profile (default: 25)\n";
+  std::cerr << "  --coverage=<a.prof,b.prof,...>\n";
+  std::cerr << "                        Report variants exercised by merged profiles\n";
   std::cerr << "\n";
   std::cerr << "Dumps compiled microcode in human-readable format.\n";
 }
@@ -36,6 +49,10 @@ int main(int argc, char** argv) {
 
   const std::string format = absl::GetFlag(FLAGS_format);
   const std::optional<int> opcode_filter = absl::GetFlag(FLAGS_opcode);
+  const std::string profile_path = absl::GetFlag(FLAGS_profile);
+  const int top = absl::GetFlag(FLAGS_top);
+  const std::vector<std::string> coverage_paths =
+      absl::GetFlag(FLAGS_coverage);
 
   if (format != "text" && format != "yaml") {
     std::cerr << "Error: Invalid format '" << format
@@ -88,7 +105,18 @@ int main(int argc, char** argv) {
 
     // Output based on format and filter
     std::string output;
-    if (opcode_filter.has_value()) {
+    if (!coverage_paths.empty()) {
+      irata2::microcode::debug::MicrocodeProfile merged;
+      for (const auto& path : coverage_paths) {
+        merged.Merge(
+            irata2::microcode::debug::MicrocodeProfile::ReadFile(path));
+      }
+      output = decoder.DumpCoverage(merged);
+    } else if (!profile_path.empty()) {
+      output = decoder.DumpProfile(
+          irata2::microcode::debug::MicrocodeProfile::ReadFile(profile_path),
+          static_cast<size_t>(std::max(top, 0)));
+    } else if (opcode_filter.has_value()) {
       if (format == "yaml") {
         output = decoder.DumpInstructionYaml(static_cast<uint8_t>(*opcode_filter));
       } else {
@@ -0,0 +1,124 @@
+#include "irata2/microcode/debug/profile.h"
+
+#include "irata2/microcode/debug/decoder.h"
+#include "irata2/microcode/error.h"
+#include "irata2/microcode/output/program.h"
+
+#include <gtest/gtest.h>
+
+#include <sstream>
+
+using irata2::microcode::MicrocodeError;
+using irata2::microcode::debug::MicrocodeDecoder;
+using irata2::microcode::debug::MicrocodeProfile;
+using irata2::microcode::output::EncodeKey;
+using irata2::microcode::output::MicrocodeProgram;
+
+namespace {
+
+MicrocodeProgram MakeTestProgram() {
+  MicrocodeProgram program;
+  program.control_paths = {"halt", "a.read", "x.write"};
+  program.status_bits = {{"zero", 0}};
+  program.table[EncodeKey({0xC6, 0, 0})] = 0b110;  // a.read, x.write
+  program.table[EncodeKey({0xC6, 1, 0})] = 0b010;  // a.read
+  program.table[EncodeKey({0xC6, 1, 1})] = 0b001;  // halt (zero set)
+  return program;
+}
+
+}  // namespace
+
+TEST(MicrocodeProfileTest, CountsEntriesAndControls) {
+  MicrocodeProgram program = MakeTestProgram();
+  MicrocodeProfile profile;
+  profile.Record(0xC6, 0, 0);
+  profile.Record(0xC6, 0, 0);
+  profile.Record(0xC6, 1, 0);
+  profile.Record(0xC6, 1, 1);
+
+  EXPECT_EQ(profile.total(), 4u);
+  EXPECT_EQ(profile.count({0xC6, 0, 0}), 2u);
+  EXPECT_EQ(profile.count({0xC6, 2, 0}), 0u);
+
+  const auto controls = profile.ControlCounts(program);
+  ASSERT_EQ(controls.size(), 3u);
+  EXPECT_EQ(controls[0], 1u);  // halt
+  EXPECT_EQ(controls[1], 3u);  // a.read
+  EXPECT_EQ(controls[2], 2u);  // x.write
+}
+
+TEST(MicrocodeProfileTest, RoundTripsThroughText) {
+  MicrocodeProfile profile;
+  profile.Record(0xC6, 3, 0x02);
+  profile.Record(0x01, 0, 0);
+  profile.Record(0x01, 0, 0);
+
+  std::stringstream buffer;
+  profile.Write(buffer);
+  const MicrocodeProfile read = MicrocodeProfile::Read(buffer);
+  EXPECT_EQ(read.counts(), profile.counts());
+}
+
+TEST(MicrocodeProfileTest, RejectsMalformedLines) {
+  std::istringstream missing_field("0xc6 0 0x00\n");
+  EXPECT_THROW(MicrocodeProfile::Read(missing_field), MicrocodeError);
+
+  std::istringstream out_of_range("0x1c6 0 0x00 5\n");
+  EXPECT_THROW(MicrocodeProfile::Read(out_of_range), MicrocodeError);
+
+  std::istringstream not_a_number("0xc6 step 0x00 5\n");
+  EXPECT_THROW(MicrocodeProfile::Read(not_a_number), MicrocodeError);
+}
+
+TEST(MicrocodeProfileTest, DecoderReportsHotEntriesAndControls) {
+  MicrocodeProgram program = MakeTestProgram();
+  MicrocodeProfile profile;
+  for (int i = 0; i < 3; ++i) {
+    profile.Record(0xC6, 0, 0);
+  }
+  profile.Record(0xC6, 1, 1);
+
+  MicrocodeDecoder decoder(program);
+  const std::string report = decoder.DumpProfile(profile);
+  EXPECT_NE(report.find("4 cycles"), std::string::npos);
+  EXPECT_NE(report.find("JSR_ABS"), std::string::npos);
+  EXPECT_NE(report.find("step 0 status default: [a.read, x.write]"),
+            std::string::npos);
+  EXPECT_NE(report.find("step 1 status zero: [halt]"), std::string::npos);
+  // a.read is asserted by three of the four cycles.
+  EXPECT_NE(report.find("75.00%  a.read"), std::string::npos);
+}
+
+TEST(MicrocodeProfileTest, MergeAddsCounts) {
+  MicrocodeProfile first;
+  first.Record(0xC6, 0, 0);
+  MicrocodeProfile second;
+  second.Record(0xC6, 0, 0);
+  second.Record(0xC6, 1, 1);
+
+  first.Merge(second);
+  EXPECT_EQ(first.count({0xC6, 0, 0}), 2u);
+  EXPECT_EQ(first.count({0xC6, 1, 1}), 1u);
+  EXPECT_EQ(first.total(), 3u);
+}
+
+TEST(MicrocodeProfileTest, DecoderReportsVariantCoverage) {
+  MicrocodeProgram program = MakeTestProgram();
+  // A second status selecting the same word is the same variant.
+  program.table[EncodeKey({0xC6, 0, 1})] = 0b110;
+  program.table[EncodeKey({0x01, 0, 0})] = 0b001;
+  MicrocodeProfile profile;
+  profile.Record(0xC6, 0, 1);
+  profile.Record(0xC6, 1, 0);
+
+  MicrocodeDecoder decoder(program);
+  const std::string report = decoder.DumpCoverage(profile);
+  EXPECT_NE(report.find("microcode coverage: 2/4 variants (50.00%), "
+                        "1/2 instructions executed"),
+            std::string::npos);
+  EXPECT_NE(report.find("JSR_ABS: 2/3 variants\n"
+                        "    missing step 1 status zero: [halt]\n"),
+            std::string::npos);
+  EXPECT_NE(report.find("not executed:\n  "), std::string::npos);
+  EXPECT_EQ(report.find("missing step 0"), std::string::npos);
+}
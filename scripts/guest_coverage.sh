@@ -0,0 +1,50 @@
+#!/bin/bash
+# Merge guest and microcode coverage recorded by the test suites.
+# Configure with -DIRATA2_GUEST_COVERAGE=ON and run ctest first; ctest
+# empties the coverage directory at the start of each run.
+
+set -e
+
+BUILD_DIR=${1:-build}
+COVERAGE_DIR="$BUILD_DIR/guest_coverage"
+
+if [ ! -d "$COVERAGE_DIR" ]; then
+    echo "No guest coverage in $COVERAGE_DIR; configure with -DIRATA2_GUEST_COVERAGE=ON and run ctest"
+    exit 1
+fi
+
+shopt -s nullglob
+# guest.info is this script's own merged output from an earlier run.
+infos=()
+for info in "$COVERAGE_DIR"/*.info; do
+    [ "$(basename "$info")" = guest.info ] || infos+=("$info")
+done
+profiles=("$COVERAGE_DIR"/*.prof)
+
+if [ ${#infos[@]} -gt 0 ]; then
+    echo "Merging ${#infos[@]} guest tracefiles..."
+    args=()
+    for info in "${infos[@]}"; do
+        args+=(--add-tracefile "$info")
+    done
+    lcov "${args[@]}" \
+         --output-file "$COVERAGE_DIR/guest.info" \
+         --rc lcov_branch_coverage=1
+    genhtml "$COVERAGE_DIR/guest.info" \
+            --output-directory "$COVERAGE_DIR/html" \
+            --title "IRATA2 Guest Coverage" \
+            --legend \
+            --rc lcov_branch_coverage=1
+    echo ""
+    echo "Guest coverage report generated at: $COVERAGE_DIR/html/index.html"
+fi
+
+if [ ${#profiles[@]} -gt 0 ]; then
+    echo ""
+    echo "Merging ${#profiles[@]} microcode profiles..."
+    list=$(IFS=,; echo "${profiles[*]}")
+    "$BUILD_DIR/microcode/microcode_dump" --coverage="$list" \
+        > "$COVERAGE_DIR/microcode.txt"
+    head -n 1 "$COVERAGE_DIR/microcode.txt"
+    echo "Microcode coverage report: $COVERAGE_DIR/microcode.txt"
+fi
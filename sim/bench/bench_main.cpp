@@ -21,12 +21,19 @@ struct Options {
   uint64_t warmup_cycles = 100'000;
   std::string format = "text";
   std::string output_path;
+  bool host_profile = false;
+  bool host_profile_components = false;
 };
 
 void PrintUsage(const char* argv0) {
   std::cerr << "Usage: " << argv0
             << " [--workload {loop,mem}] [--cycles N] [--warmup N]"
-            << " [--format {text,json,csv}] [--output path]\n";
+            << " [--format {text,json,csv}] [--output path] [--host-profile]"
+            << " [--host-profile-components]\n"
+            << "\n--host-profile prints host time per tick phase to stderr;"
+            << " --host-profile-components\nalso times each CPU component,"
+            << " which inflates the phase totals. Both need a\nbuild"
+            << " configured with -DIRATA2_HOST_PROFILE=ON.\n";
 }
 
 std::optional<uint64_t> ParseU64(const std::string& value) {
@@ -93,6 +100,12 @@ const char* HaltReasonToString(irata2::sim::Cpu::HaltReason reason) {
       return "halt";
     case irata2::sim::Cpu::HaltReason::Crash:
       return "crash";
+    case irata2::sim::Cpu::HaltReason::FramePresented:
+      return "frame";
+    case irata2::sim::Cpu::HaltReason::TargetPc:
+      return "target_pc";
+    case irata2::sim::Cpu::HaltReason::MemoryAccess:
+      return "memory_access";
   }
   return "unknown";
 }
@@ -107,6 +120,7 @@ void RunBenchmark(const Options& options) {
   }
 
   auto cpu = MakeCpu(program);
+  cpu.host_profile().set_component_breakdown(options.host_profile_components);
   const auto start = std::chrono::steady_clock::now();
   const auto result = cpu.RunUntilHalt(options.cycles);
   const auto end = std::chrono::steady_clock::now();
@@ -115,6 +129,7 @@ void RunBenchmark(const Options& options) {
   const double seconds = elapsed.count();
   const double cycles = static_cast<double>(result.cycles);
   const double cycles_per_sec = seconds > 0.0 ? cycles / seconds : 0.0;
+  const irata2::sim::PerfCounters perf = cpu.perf_counters();
 
   std::ostringstream output;
   if (options.format == "json") {
@@ -123,21 +138,38 @@ void RunBenchmark(const Options& options) {
            << "\"cycles\":" << result.cycles << ","
            << "\"elapsed_s\":" << seconds << ","
            << "\"cycles_per_sec\":" << cycles_per_sec << ","
-           << "\"halt_reason\":\"" << HaltReasonToString(result.reason) << "\""
-           << "}\n";
+           << "\"halt_reason\":\"" << HaltReasonToString(result.reason) << "\","
+           << "\"perf\":";
+    perf.WriteJson(output);
+    output << "}\n";
   } else if (options.format == "csv") {
-    output << "workload,cycles,elapsed_s,cycles_per_sec,halt_reason\n";
+    output << "workload,cycles,elapsed_s,cycles_per_sec,halt_reason,"
+           << "instructions,cpi,data_bus_utilization,address_bus_utilization,"
+           << "memory_reads,memory_writes,mmio_accesses,irqs_taken\n";
     output << options.workload << ","
            << result.cycles << ","
            << seconds << ","
            << cycles_per_sec << ","
-           << HaltReasonToString(result.reason) << "\n";
+           << HaltReasonToString(result.reason) << ","
+           << perf.instructions << ","
+           << perf.cycles_per_instruction() << ","
+           << perf.data_bus_utilization() << ","
+           << perf.address_bus_utilization() << ","
+           << perf.memory_reads() << ","
+           << perf.memory_writes() << ","
+           << perf.mmio_accesses() << ","
+           << perf.irqs_taken << "\n";
   } else {
     output << "workload=" << options.workload
            << " cycles=" << result.cycles
            << " elapsed_s=" << seconds
            << " cycles_per_sec=" << cycles_per_sec
            << " halt_reason=" << HaltReasonToString(result.reason)
+           << " instructions=" << perf.instructions
+           << " cpi=" << perf.cycles_per_instruction()
+           << " data_bus_utilization=" << perf.data_bus_utilization()
+           << " memory_reads=" << perf.memory_reads()
+           << " memory_writes=" << perf.memory_writes()
            << "\n";
   }
 
@@ -151,6 +183,10 @@ void RunBenchmark(const Options& options) {
   } else {
     std::cout << output.str();
   }
+
+  if (options.host_profile) {
+    cpu.host_profile().WriteTable(std::cerr);
+  }
 }
 }  // namespace
 
@@ -221,6 +257,18 @@ int main(int argc, char** argv) {
       options.output_path = argv[++i];
       continue;
     }
+    if (arg == "--host-profile" || arg == "--host-profile-components") {
+      if (!irata2::sim::HostProfile::kEnabled) {
+        std::cerr << arg << " needs a build configured with"
+                  << " -DIRATA2_HOST_PROFILE=ON\n";
+        return 1;
+      }
+      options.host_profile = true;
+      if (arg == "--host-profile-components") {
+        options.host_profile_components = true;
+      }
+      continue;
+    }
     PrintUsage(argv[0]);
     return 1;
   }
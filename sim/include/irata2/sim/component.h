@@ -5,6 +5,7 @@
 #include <vector>
 
 #include "irata2/base/tick_phase.h"
+#include "irata2/sim/snapshot.h"
 
 namespace irata2::sim {
 
@@ -88,6 +89,47 @@ class Component {
       child->TickClear();
     }
   }
+
+  /// Run one tick phase on @p component and its subtree. Lets a parent
+  /// drive (and time) its children individually.
+  static void RunPhase(Component& component, base::TickPhase phase) {
+    switch (phase) {
+      case base::TickPhase::Control:
+        component.TickControl();
+        break;
+      case base::TickPhase::Write:
+        component.TickWrite();
+        break;
+      case base::TickPhase::Read:
+        component.TickRead();
+        break;
+      case base::TickPhase::Process:
+        component.TickProcess();
+        break;
+      case base::TickPhase::Clear:
+        component.TickClear();
+        break;
+      case base::TickPhase::None:
+        break;
+    }
+  }
+
+ public:
+  // Snapshot support
+  // Base implementations propagate to children; components with mutable
+  // state override these, call the base, and write/read their own fields in
+  // the same order in both methods.
+  virtual void SaveState(SnapshotWriter& out) const {
+    for (const auto* child : children_) {
+      child->SaveState(out);
+    }
+  }
+
+  virtual void LoadState(SnapshotReader& in) {
+    for (auto* child : children_) {
+      child->LoadState(in);
+    }
+  }
 };
 
 /**
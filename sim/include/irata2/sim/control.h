@@ -113,6 +113,18 @@ class LatchedControl : public ControlBase {
       : ControlBase(std::move(name), parent, phase) {}
 
   // TickClear intentionally does nothing - control persists
+
+  // Auto-reset controls are always clear between ticks, so only latched
+  // controls carry state across a snapshot.
+  void SaveState(SnapshotWriter& out) const override {
+    Component::SaveState(out);
+    out.Write(asserted_);
+  }
+
+  void LoadState(SnapshotReader& in) override {
+    Component::LoadState(in);
+    in.Read(asserted_);
+  }
 };
 
 /**
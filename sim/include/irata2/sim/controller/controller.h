@@ -5,6 +5,7 @@
 #include <utility>
 #include <vector>
 
+#include "irata2/microcode/debug/profile.h"
 #include "irata2/microcode/output/program.h"
 #include "irata2/sim/instruction_register.h"
 #include "irata2/sim/component.h"
@@ -42,6 +43,12 @@ class Controller final : public ComponentWithParent {
     return instruction_memory_.get();
   }
 
+  /// Count every microcode entry looked up into @p profile. Not owned; pass
+  /// nullptr to stop.
+  void set_microcode_profile(microcode::debug::MicrocodeProfile* profile) {
+    profile_ = profile;
+  }
+
   void TickControl() override;
   void TickProcess() override;
 
@@ -52,6 +59,7 @@ class Controller final : public ComponentWithParent {
   const ProgramCounter& pc_;
   LatchedWordRegister ipc_;
   std::unique_ptr<InstructionMemory> instruction_memory_;
+  microcode::debug::MicrocodeProfile* profile_ = nullptr;
 };
 
 }  // namespace irata2::sim::controller
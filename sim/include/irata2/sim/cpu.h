@@ -23,9 +23,13 @@
 #include "irata2/sim/program_counter.h"
 #include "irata2/sim/debug_symbols.h"
 #include "irata2/sim/debug_trace.h"
+#include "irata2/sim/host_profile.h"
+#include "irata2/sim/latency_stats.h"
 #include "irata2/sim/memory/memory.h"
 #include "irata2/sim/memory/module.h"
 #include "irata2/sim/memory/region.h"
+#include "irata2/sim/perf_counters.h"
+#include "irata2/sim/retired_instruction.h"
 #include "irata2/sim/status_register.h"
 #include "irata2/sim/word_bus.h"
 
@@ -35,6 +39,12 @@ namespace irata2::sim {
 using alu::Alu;
 using controller::Controller;
 
+class FrameBudget;
+class GuestCoverage;
+class GuestProfiler;
+class GuestTimeline;
+class TraceStreamWriter;
+
 /**
  * @brief Runtime CPU simulator with mutable state.
  *
@@ -69,7 +79,27 @@ class Cpu : public Component {
     Running,   ///< CPU is still running (not halted)
     Timeout,   ///< Maximum cycle count reached
     Halt,      ///< Normal halt via halt control
-    Crash      ///< CPU crash via crash control
+    Crash,     ///< CPU crash via crash control
+    FramePresented,  ///< A device reported a completed frame
+    TargetPc,        ///< An instruction started at the target address
+    MemoryAccess     ///< The CPU touched the watched address range
+  };
+
+  /**
+   * @brief Conditions under which RunUntil() returns.
+   *
+   * Halt and crash always stop execution. Every other condition is opt-in
+   * and checked at cycle boundaries, so RunUntil() returns with the CPU
+   * between ticks. When several conditions fire on the same cycle the
+   * reason reported is the first of halt/crash, frame presented, target PC,
+   * memory access, cycle budget.
+   */
+  struct StopConditions {
+    std::optional<uint64_t> max_cycles;   ///< Cycle budget for this call
+    bool frame_presented = false;         ///< Stop after a VGC PRESENT
+    std::optional<base::Word> target_pc;  ///< Stop when an instruction starts here
+    std::optional<memory::AddressRange> memory_access;  ///< Stop after a bus access here
+    bool capture_state = false;           ///< Capture CpuState in the result
   };
 
   /**
@@ -130,6 +160,55 @@ class Cpu : public Component {
    */
   RunResult RunUntilHalt(uint64_t max_cycles, bool capture_state = false);
 
+  /**
+   * @brief Run until any of the given stop conditions holds.
+   * @param conditions Stop conditions; halt and crash are implied
+   * @return RunResult with the stop reason and cycles executed by this call
+   */
+  RunResult RunUntil(const StopConditions& conditions);
+
+  /**
+   * @brief Record that a display device presented a frame.
+   *
+   * Called by the VGC when PRESENT is written; RunUntil() uses it to stop
+   * on frame boundaries.
+   */
+  void NotifyFramePresented();
+  uint64_t frames_presented() const { return frames_presented_; }
+
+  /**
+   * @brief Record that an input device applied a host input event.
+   *
+   * Starts an input-to-present latency sample that the next
+   * NotifyFramePresented() completes.
+   */
+  void NotifyHostInput();
+
+  /**
+   * @brief In-memory image of the whole machine.
+   *
+   * Covers every register, latched control, RAM byte and MMIO device
+   * register, so restoring it and re-running produces identical execution.
+   * Backend output (framebuffers, queued frames) and debug traces are not
+   * included. Snapshots only restore into a CPU built with the same HDL and
+   * region factories.
+   */
+  struct Snapshot {
+    std::vector<uint8_t> bytes;
+  };
+
+  /**
+   * @brief Save machine state between ticks.
+   * @param snapshot Destination; its buffer is reused to avoid allocation
+   */
+  void SaveSnapshot(Snapshot& snapshot) const;
+
+  /**
+   * @brief Restore state saved by SaveSnapshot().
+   * @throws SimError if the snapshot does not match this machine
+   */
+  void RestoreSnapshot(const Snapshot& snapshot);
+
   /**
    * @brief Capture current CPU state.
    * @return Snapshot of all CPU registers and cycle count
@@ -158,13 +237,91 @@ class Cpu : public Component {
 
   void LoadDebugSymbols(DebugSymbols symbols);
   const DebugSymbols* debug_symbols() const;
+  /// Keep the last @p depth instruction starts (rounded up to a power of
+  /// two) for crash dumps; 0 disables.
   void EnableTrace(size_t depth);
+  /// Restrict which instruction starts the trace buffer records.
+  void SetTraceFilter(DebugTraceFilter filter) {
+    trace_.set_filter(std::move(filter));
+  }
+  const DebugTraceBuffer& trace() const { return trace_; }
   bool trace_enabled() const { return trace_.enabled(); }
   size_t trace_depth() const { return trace_.depth(); }
   std::vector<DebugTraceEntry> trace_entries() const { return trace_.entries(); }
 
   base::Word instruction_address() const;
   std::optional<SourceLocation> instruction_source_location() const;
+  /// True if an instruction started during the last cycle.
+  bool instruction_started() const { return instruction_started_; }
+
+  /**
+   * @brief Report every cycle to a profiler.
+   * @param profiler Not owned; pass nullptr to detach
+   */
+  void AttachProfiler(GuestProfiler* profiler) { profiler_ = profiler; }
+
+  /**
+   * @brief Report every cycle and device access to a timeline.
+   * @param timeline Not owned; pass nullptr to detach
+   */
+  void AttachTimeline(GuestTimeline* timeline);
+
+  /**
+   * @brief Report every cycle to a frame budget.
+   * @param budget Not owned; pass nullptr to detach
+   */
+  void AttachFrameBudget(FrameBudget* budget) { frame_budget_ = budget; }
+
+  /**
+   * @brief Report every cycle to a coverage recorder.
+   * @param coverage Not owned; pass nullptr to detach
+   */
+  void AttachCoverage(GuestCoverage* coverage) { coverage_ = coverage; }
+
+  /// True if the IRQ line was asserted during the last cycle.
+  bool irq_requested() const { return irq_requested_; }
+
+  /**
+   * @brief Sample the architectural performance counters.
+   *
+   * Counts run since construction or the last ResetPerfCounters(). They are
+   * host-side statistics and are neither saved in nor restored from
+   * snapshots.
+   */
+  PerfCounters perf_counters() const;
+  void ResetPerfCounters();
+
+  /**
+   * @brief Interrupt and input latency histograms.
+   *
+   * Host-side like the performance counters, and off by default since it
+   * inspects every cycle. While disabled, nothing is recorded and no
+   * sample in flight advances, which also lets speculative frames run
+   * without disturbing the statistics.
+   */
+  const LatencyStats& latency_stats() const { return latency_; }
+  void ResetLatencyStats();
+  void set_latency_tracking(bool enabled) { latency_tracking_ = enabled; }
+  bool latency_tracking() const { return latency_tracking_; }
+
+  /**
+   * @brief Host time per tick phase.
+   *
+   * Only collected when built with IRATA2_HOST_PROFILE; see HostProfile.
+   */
+  HostProfile& host_profile() { return host_profile_; }
+  const HostProfile& host_profile() const { return host_profile_; }
+
+  /**
+   * @brief Stream every retired instruction and CPU bus access.
+   *
+   * Instructions are recorded when they retire, with the register state
+   * they leave behind, followed by the memory accesses made since the
+   * previous record. Detaching, or a halt, emits the instruction in flight.
+   *
+   * @param writer Not owned; pass nullptr to detach
+   */
+  void AttachTraceWriter(TraceStreamWriter* writer);
 
   // For tests: control whether IPC is considered valid.
   void SetIpcForTest(base::Word address);
@@ -221,7 +378,13 @@ class Cpu : public Component {
   void TickProcess() override;
 
  private:
+  static constexpr uint32_t kSnapshotMagic = 0x49523253;  // "IR2S"
+
   void BuildControlIndex();
+  void TickChildren(base::TickPhase phase);
+  void EmitTraceRecords();
+  bool CaptureTrace();
+  void TrackIrqLatency();
   void ValidateAgainstHdl();
 
   // Singleton accessors for default HDL and microcode
@@ -234,10 +397,39 @@ class Cpu : public Component {
   bool halted_ = false;
   bool crashed_ = false;
   uint64_t cycle_count_ = 0;
+  uint64_t frames_presented_ = 0;
+  bool instruction_started_ = false;
+  bool irq_requested_ = false;
 
   std::vector<Component*> components_;
   std::optional<DebugSymbols> debug_symbols_;
   DebugTraceBuffer trace_;
+  GuestProfiler* profiler_ = nullptr;
+  GuestTimeline* timeline_ = nullptr;
+  std::vector<memory::MemoryAccess> timeline_mmio_;
+  FrameBudget* frame_budget_ = nullptr;
+  GuestCoverage* coverage_ = nullptr;
+  TraceStreamWriter* trace_writer_ = nullptr;
+  struct TracedInstruction {
+    uint64_t cycle = 0;
+    base::Word address;
+    bool irq = false;
+  };
+  std::optional<TracedInstruction> traced_instruction_;
+  std::vector<memory::MemoryAccess> traced_accesses_;
+  PerfCounters perf_;  // scalar counts; regions are filled in on sampling
+  LatencyStats latency_;
+  bool latency_tracking_ = false;
+  // Latency samples in flight.
+  std::optional<uint64_t> irq_raised_at_;
+  bool irq_armed_ = true;  // a new assertion may start an irq_entry sample
+  RetiredInstructionTracker retired_;
+  static constexpr size_t kMaxIrqNesting = 256;
+  std::vector<std::optional<uint64_t>> irq_entries_;  // nullopt for BRK
+  static constexpr size_t kMaxPendingInputs = 256;
+  std::vector<uint64_t> pending_inputs_;  // applied, awaiting a present
+  HostProfile host_profile_;
+  std::vector<size_t> host_profile_slots_;  // per child, into components()
   bool ipc_valid_ = false;
 
   ProcessControl<true> halt_control_;
@@ -4,7 +4,9 @@
 #include <cstdint>
 #include <optional>
 #include <string>
+#include <string_view>
 #include <unordered_map>
+#include <utility>
 #include <vector>
 
 #include "irata2/base/types.h"
@@ -39,6 +41,39 @@ struct DebugSymbols {
 };
 
 DebugSymbols LoadDebugSymbols(const std::string& path);
+/// Parse debug JSON already in memory, e.g. AssemblerResult::debug_json.
+DebugSymbols ParseDebugSymbols(std::string_view json);
+
+/// Address-to-name lookup over a symbol table.
+///
+/// Symbols are kept sorted by address and then name, so several names at
+/// one address always resolve to the first alphabetically.
+class SymbolResolver {
+ public:
+  SymbolResolver() = default;
+  explicit SymbolResolver(const DebugSymbols* symbols) { Reset(symbols); }
+
+  void Reset(const DebugSymbols* symbols);
+
+  /// Name for an address: symbol, symbol+offset, or $hex.
+  std::string NameFor(base::Word address) const;
+  /// Name of the symbol at or below @p address, or $hex of the address
+  /// when no symbol precedes it.
+  std::string SymbolFor(base::Word address) const;
+
+  bool empty() const { return sorted_.empty(); }
+  /// Every (address, name) pair in address order.
+  const std::vector<std::pair<uint16_t, std::string>>& sorted() const {
+    return sorted_;
+  }
+
+ private:
+  using Entry = std::pair<uint16_t, std::string>;
+  // Nearest symbol at or below @p address, or nullptr.
+  const Entry* Find(uint16_t address) const;
+
+  std::vector<Entry> sorted_;
+};
 
 }  // namespace irata2::sim
 
@@ -1,9 +1,13 @@
 #ifndef IRATA2_SIM_DEBUG_TRACE_H
 #define IRATA2_SIM_DEBUG_TRACE_H
 
+#include <algorithm>
+#include <array>
+#include <bitset>
 #include <cstddef>
 #include <cstdint>
-#include <deque>
+#include <span>
+#include <utility>
 #include <vector>
 
 #include "irata2/base/types.h"
@@ -21,34 +25,138 @@ struct DebugTraceEntry {
   base::Byte status;
 };
 
+/// Decides which instruction starts the trace buffer records. Checked
+/// before an entry is built, so a narrow filter costs almost nothing per
+/// instruction. An empty filter captures everything.
+struct DebugTraceFilter {
+  struct Range {
+    base::Word first;
+    base::Word last;  // inclusive
+  };
+
+  /// Instruction address must fall in one of these; empty means any.
+  std::vector<Range> address_ranges;
+  /// Opcodes to capture; none set means any.
+  std::bitset<256> opcodes;
+  /// Only IRQ entries.
+  bool irq_only = false;
+  /// Keep every Nth instruction that passes the other filters.
+  uint32_t every_nth = 1;
+
+  bool filters_opcode() const { return opcodes.any(); }
+};
+
+/// Fixed-capacity ring of the most recent instruction starts.
+///
+/// Storage is allocated once by Configure(), whose depth is rounded up to
+/// a power of two, and recording overwrites the oldest slot in place.
+/// Entries are read without copying through at() or spans().
 class DebugTraceBuffer {
  public:
   void Configure(size_t depth) {
-    depth_ = depth;
-    entries_.clear();
+    size_t capacity = 0;
+    if (depth > 0) {
+      capacity = 1;
+      while (capacity < depth) {
+        capacity <<= 1;
+      }
+    }
+    ring_.assign(capacity, DebugTraceEntry{});
+    mask_ = capacity == 0 ? 0 : capacity - 1;
+    head_ = 0;
+    size_ = 0;
+    skipped_ = 0;
   }
 
-  bool enabled() const { return depth_ > 0; }
-  size_t depth() const { return depth_; }
-  size_t size() const { return entries_.size(); }
+  void set_filter(DebugTraceFilter filter) {
+    filter_ = std::move(filter);
+    if (filter_.every_nth == 0) {
+      filter_.every_nth = 1;
+    }
+    skipped_ = 0;
+  }
+  const DebugTraceFilter& filter() const { return filter_; }
+
+  bool enabled() const { return !ring_.empty(); }
+  size_t depth() const { return ring_.size(); }
+  size_t size() const { return size_; }
 
-  void Record(DebugTraceEntry entry) {
+  /// Whether an instruction start should be recorded. Advances the
+  /// every-Nth counter, so call it once per candidate. @p opcode is only
+  /// consulted when the filter names opcodes.
+  bool ShouldCapture(base::Word address, uint8_t opcode, bool irq) {
+    if (!enabled()) {
+      return false;
+    }
+    if (filter_.irq_only && !irq) {
+      return false;
+    }
+    if (!filter_.address_ranges.empty()) {
+      bool in_range = false;
+      for (const auto& range : filter_.address_ranges) {
+        if (address >= range.first && address <= range.last) {
+          in_range = true;
+          break;
+        }
+      }
+      if (!in_range) {
+        return false;
+      }
+    }
+    if (filter_.filters_opcode() && !filter_.opcodes.test(opcode)) {
+      return false;
+    }
+    if (filter_.every_nth > 1) {
+      if (skipped_ + 1 < filter_.every_nth) {
+        ++skipped_;
+        return false;
+      }
+      skipped_ = 0;
+    }
+    return true;
+  }
+
+  void Record(const DebugTraceEntry& entry) {
     if (!enabled()) {
       return;
     }
-    if (entries_.size() >= depth_) {
-      entries_.pop_front();
+    ring_[head_ & mask_] = entry;
+    ++head_;
+    if (size_ < ring_.size()) {
+      ++size_;
     }
-    entries_.push_back(std::move(entry));
   }
 
+  /// Entry @p index, oldest first.
+  const DebugTraceEntry& at(size_t index) const {
+    return ring_[(head_ - size_ + index) & mask_];
+  }
+
+  /// The retained entries as at most two contiguous runs, oldest first.
+  std::array<std::span<const DebugTraceEntry>, 2> spans() const {
+    const size_t start = (head_ - size_) & mask_;
+    const size_t first = std::min(size_, ring_.size() - start);
+    const std::span<const DebugTraceEntry> all(ring_);
+    return {all.subspan(start, first), all.subspan(0, size_ - first)};
+  }
+
+  /// Copy of the retained entries, oldest first.
   std::vector<DebugTraceEntry> entries() const {
-    return std::vector<DebugTraceEntry>(entries_.begin(), entries_.end());
+    std::vector<DebugTraceEntry> out;
+    out.reserve(size_);
+    for (const auto& span : spans()) {
+      out.insert(out.end(), span.begin(), span.end());
+    }
+    return out;
   }
 
  private:
-  size_t depth_ = 0;
-  std::deque<DebugTraceEntry> entries_;
+  std::vector<DebugTraceEntry> ring_;
+  size_t mask_ = 0;
+  size_t head_ = 0;  // total records written; slot is head_ & mask_
+  size_t size_ = 0;
+  DebugTraceFilter filter_;
+  uint32_t skipped_ = 0;
 };
 
 }  // namespace irata2::sim
@@ -0,0 +1,115 @@
+#ifndef IRATA2_SIM_FRAME_BUDGET_H
+#define IRATA2_SIM_FRAME_BUDGET_H
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "irata2/sim/debug_symbols.h"
+#include "irata2/sim/latency_stats.h"
+
+namespace irata2::sim {
+
+class Cpu;
+
+namespace io {
+class VectorGraphicsCoprocessor;
+}  // namespace io
+
+/// Per-frame accounting of guest work against a cycle budget.
+///
+/// Attach with Cpu::AttachFrameBudget(). A frame runs from one VGC PRESENT
+/// to the next, the first one from the cycle recording starts. Each frame
+/// records its cycles, the cycles from its first CLEAR to its PRESENT, the
+/// VGC commands issued and lines drawn (when a coprocessor is attached
+/// with AttachVgc()) and the CPU's writes to device regions.
+///
+/// A frame that takes more than cycles_per_frame() cycles is an overrun.
+/// For overruns the frame's cycles are also attributed to the symbol at or
+/// below each executing instruction and the kTopSymbols largest are kept,
+/// which says what pushed the frame over.
+class FrameBudget {
+ public:
+  static constexpr size_t kTopSymbols = 5;
+  /// Overruns listed by WriteText(), worst first. WriteCsv() has them all.
+  static constexpr size_t kReportedOverruns = 10;
+
+  struct SymbolCycles {
+    std::string name;
+    uint64_t cycles = 0;
+  };
+
+  struct Frame {
+    uint64_t index = 0;  // Cpu::frames_presented() after this frame
+    uint64_t start_cycle = 0;
+    uint64_t cycles = 0;
+    uint64_t draw_cycles = 0;  // first CLEAR to PRESENT; 0 without a CLEAR
+    uint64_t commands = 0;
+    uint64_t lines = 0;
+    uint64_t mmio_writes = 0;
+    bool overrun = false;
+    std::vector<SymbolCycles> top_symbols;  // overruns only
+  };
+
+  explicit FrameBudget(uint64_t cycles_per_frame);
+
+  void SetSymbols(const DebugSymbols* symbols) { resolver_.Reset(symbols); }
+  /// Source of the command and line counts. Not owned; may be nullptr.
+  void AttachVgc(const io::VectorGraphicsCoprocessor* vgc) { vgc_ = vgc; }
+
+  /// Called by the CPU at the end of every cycle.
+  void OnCycle(const Cpu& cpu);
+  /// Start a fresh frame at the CPU's current cycle, dropping the partial
+  /// one. Call after restoring a snapshot, which moves the CPU back but
+  /// not the host-side device counters.
+  void Resync(const Cpu& cpu);
+
+  uint64_t cycles_per_frame() const { return cycles_per_frame_; }
+  const std::vector<Frame>& frames() const { return frames_; }
+  const LatencyHistogram& frame_cycles() const { return frame_cycles_; }
+  uint64_t overruns() const { return overruns_; }
+
+  /// Totals, the frame-time histogram and the worst overruns with their
+  /// top symbols.
+  void WriteText(std::ostream& out) const;
+  /// One row per completed frame.
+  void WriteCsv(std::ostream& out) const;
+
+ private:
+  struct Counters {
+    uint64_t commands = 0;
+    uint64_t lines = 0;
+    uint64_t clears = 0;
+    uint64_t mmio_writes = 0;
+  };
+
+  Counters ReadCounters(const Cpu& cpu) const;
+  void EndFrame(const Cpu& cpu, uint64_t cycle);
+  std::vector<SymbolCycles> TopSymbols() const;
+  void ClearAddressCycles();
+
+  uint64_t cycles_per_frame_;
+  const io::VectorGraphicsCoprocessor* vgc_ = nullptr;
+  SymbolResolver resolver_;
+
+  bool started_ = false;
+  uint64_t presented_ = 0;
+  uint64_t frame_start_ = 0;
+  std::optional<uint64_t> draw_start_;
+  Counters baseline_;
+  // Cycles per instruction address in the current frame; touched_ lists
+  // the nonzero entries so a frame costs what it ran, not 64K.
+  std::vector<uint64_t> address_cycles_;
+  std::vector<uint16_t> touched_;
+
+  std::vector<Frame> frames_;
+  LatencyHistogram frame_cycles_;
+  uint64_t overruns_ = 0;
+};
+
+}  // namespace irata2::sim
+
+#endif  // IRATA2_SIM_FRAME_BUDGET_H
@@ -0,0 +1,99 @@
+#ifndef IRATA2_SIM_FRAME_PACER_H
+#define IRATA2_SIM_FRAME_PACER_H
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+namespace irata2::sim {
+
+enum class PacingMode : uint8_t {
+  Realtime,     // one frame per 1/fps seconds
+  Turbo,        // turbo_factor frames per 1/fps seconds
+  Unthrottled,  // as fast as the host allows
+};
+
+std::string ToString(PacingMode mode);
+
+/// Frame-time statistics accumulated since the last ResetStats().
+struct FrameStats {
+  uint64_t frames = 0;
+  uint64_t late_frames = 0;  // frames that started after their deadline
+  double mean_ms = 0.0;
+  double min_ms = 0.0;
+  double max_ms = 0.0;
+  double jitter_ms = 0.0;  // standard deviation of the frame time
+
+  std::string Format() const;
+};
+
+/// Time source for FramePacer. Tests substitute a manual clock.
+class FrameClock {
+ public:
+  using Clock = std::chrono::steady_clock;
+
+  virtual ~FrameClock() = default;
+
+  virtual Clock::time_point Now() const = 0;
+  /// Return no earlier than @p deadline.
+  virtual void WaitUntil(Clock::time_point deadline) = 0;
+
+  /// steady_clock. WaitUntil() sleeps until shortly before the deadline and
+  /// spins the remainder, since OS sleeps routinely overshoot by a
+  /// millisecond or more.
+  static FrameClock& Steady();
+
+  static constexpr auto kSpinWindow = std::chrono::microseconds(1500);
+};
+
+/// High-resolution frame scheduler.
+///
+/// Deadlines are absolute: each frame's deadline is the previous deadline
+/// plus one period, so rounding in individual waits never accumulates into
+/// drift. If the caller falls more than kMaxLagFrames behind (a debugger
+/// pause, a long GC on the host), the schedule restarts from now instead of
+/// bursting to catch up. A mode or turbo change applies from the deadline
+/// after the one already scheduled.
+class FramePacer {
+ public:
+  using Clock = FrameClock::Clock;
+
+  static constexpr int kMaxLagFrames = 4;
+
+  explicit FramePacer(int fps, FrameClock& clock = FrameClock::Steady());
+
+  void set_mode(PacingMode mode) { mode_ = mode; }
+  PacingMode mode() const { return mode_; }
+  void set_turbo_factor(int factor) { turbo_factor_ = factor < 1 ? 1 : factor; }
+  int turbo_factor() const { return turbo_factor_; }
+
+  /// Restart the schedule from the current time.
+  void Start();
+
+  /// Block until the next frame should begin and record the elapsed frame
+  /// time. Returns immediately in Unthrottled mode.
+  void WaitForNextFrame();
+
+  const FrameStats& stats() const { return stats_; }
+  void ResetStats();
+
+ private:
+  Clock::duration Period() const;
+  void Record(Clock::duration frame_time, bool late);
+
+  FrameClock& clock_;
+  Clock::duration base_period_;
+  PacingMode mode_ = PacingMode::Realtime;
+  int turbo_factor_ = 4;
+
+  Clock::time_point deadline_;
+  Clock::time_point frame_start_;
+
+  FrameStats stats_;
+  double sum_ms_ = 0.0;
+  double sum_sq_ms_ = 0.0;
+};
+
+}  // namespace irata2::sim
+
+#endif  // IRATA2_SIM_FRAME_PACER_H
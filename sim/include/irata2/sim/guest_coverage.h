@@ -0,0 +1,72 @@
+#ifndef IRATA2_SIM_GUEST_COVERAGE_H
+#define IRATA2_SIM_GUEST_COVERAGE_H
+
+#include <bitset>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <optional>
+#include <ostream>
+#include <string_view>
+
+#include "irata2/base/types.h"
+#include "irata2/sim/debug_symbols.h"
+#include "irata2/sim/retired_instruction.h"
+
+namespace irata2::sim {
+
+class Cpu;
+
+/// Guest code coverage: which instructions ran and which way each
+/// conditional branch went.
+///
+/// Attach with Cpu::AttachCoverage(). Only instruction starts are looked
+/// at, so recording costs a bit set per instruction and a map update per
+/// conditional branch. A branch whose next instruction is the one after it
+/// counts as not taken, so a branch to its own fall-through always reads
+/// as not taken.
+///
+/// Microcode entries are covered by the controller's
+/// microcode::debug::MicrocodeProfile instead; see microcode_dump
+/// --coverage.
+class GuestCoverage {
+ public:
+  struct BranchCounts {
+    uint64_t taken = 0;
+    uint64_t not_taken = 0;
+  };
+
+  GuestCoverage();
+
+  /// Called by the CPU at the end of every cycle.
+  void OnCycle(const Cpu& cpu);
+
+  bool executed(base::Word address) const {
+    return executed_.test(address.value());
+  }
+  size_t executed_count() const { return executed_.count(); }
+  /// Per conditional branch address, in address order.
+  const std::map<uint16_t, BranchCounts>& branches() const {
+    return branches_;
+  }
+
+  /// lcov tracefile against the assembler source recorded in @p symbols:
+  /// a DA line per source line that assembled to code, counting how many
+  /// of its instructions ran at least once, and a BRDA pair (taken, not
+  /// taken) per conditional branch on it. Data directives are not lines.
+  void WriteLcov(std::ostream& out,
+                 const DebugSymbols& symbols,
+                 std::string_view test_name = {}) const;
+
+ private:
+  std::bitset<0x10000> executed_;
+  std::map<uint16_t, BranchCounts> branches_;
+  std::bitset<256> conditional_branches_;
+  uint16_t branch_length_ = 0;
+  std::optional<uint16_t> previous_start_;
+  RetiredInstructionTracker retired_;
+};
+
+}  // namespace irata2::sim
+
+#endif  // IRATA2_SIM_GUEST_COVERAGE_H
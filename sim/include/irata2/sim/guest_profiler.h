@@ -0,0 +1,114 @@
+#ifndef IRATA2_SIM_GUEST_PROFILER_H
+#define IRATA2_SIM_GUEST_PROFILER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "irata2/base/types.h"
+#include "irata2/sim/debug_symbols.h"
+#include "irata2/sim/retired_instruction.h"
+
+namespace irata2::sim {
+
+class Cpu;
+
+/// Cycle-accurate profiler for guest programs.
+///
+/// Attach with Cpu::AttachProfiler(). Every cycle is charged to the
+/// instruction address the CPU reports at the end of that cycle, so each
+/// instruction's count covers all of its microcode steps.
+///
+/// Calls are tracked at instruction boundaries: the instruction after a
+/// JSR, BRK or IRQ entry opens a frame named by its address, and the
+/// instruction after an RTS or RTI closes one. Frames form a call tree,
+/// which gives inclusive cycles per routine and collapsed stacks for
+/// flamegraphs. Guests that discard return addresses leave the tree
+/// unbalanced; returns at the root are ignored and depth is capped at
+/// kMaxDepth, so the profile stays usable rather than exact.
+///
+/// Address-to-name resolution uses the loaded DebugSymbols: a flat profile
+/// entry belongs to the nearest symbol at or below its address, and a call
+/// frame to the symbol at its entry address. Without symbols, addresses
+/// are printed in hex.
+class GuestProfiler {
+ public:
+  static constexpr size_t kAddressSpace = 0x10000;
+  static constexpr size_t kMaxDepth = 256;
+
+  GuestProfiler();
+
+  /// Called by the CPU at the end of every cycle.
+  void OnCycle(const Cpu& cpu);
+
+  void SetSymbols(const DebugSymbols* symbols);
+
+  uint64_t total_cycles() const { return total_cycles_; }
+  uint64_t total_instructions() const { return total_instructions_; }
+  uint64_t cycles_at(base::Word address) const {
+    return cycles_[address.value()];
+  }
+  uint64_t instructions_at(base::Word address) const {
+    return instructions_[address.value()];
+  }
+
+  struct FunctionStats {
+    std::string name;
+    base::Word entry;
+    uint64_t calls = 0;
+    uint64_t self_cycles = 0;
+    uint64_t inclusive_cycles = 0;
+  };
+  /// Per-routine totals from the call tree, by inclusive cycles descending.
+  /// Recursive activations are only counted once towards inclusive cycles.
+  std::vector<FunctionStats> Functions() const;
+
+  /// JSON with totals, the flat profile by address and by symbol, and the
+  /// per-routine call-tree totals. frames, if nonzero, adds a cycles per
+  /// frame figure.
+  void WriteJson(std::ostream& out, uint64_t frames = 0) const;
+  /// One "root;caller;callee cycles" line per call path with self cycles,
+  /// the input format of flamegraph.pl and speedscope.
+  void WriteCollapsedStacks(std::ostream& out) const;
+  /// Every assembled source line in address order with its cycles, share of
+  /// the total and execution count, labelled by symbol.
+  void WriteAnnotatedListing(std::ostream& out) const;
+
+  /// Name for an address: symbol, symbol+offset, or $hex.
+  std::string NameFor(base::Word address) const;
+
+ private:
+  struct Node {
+    size_t parent = 0;
+    uint16_t entry = 0;
+    uint64_t calls = 0;
+    uint64_t self_cycles = 0;
+    std::map<uint16_t, size_t> children;
+  };
+
+  size_t Child(size_t parent, uint16_t entry);
+  std::string FrameName(uint16_t entry) const;
+  std::vector<uint64_t> InclusiveCycles() const;
+  std::string StackName(size_t node) const;
+
+  std::vector<uint64_t> cycles_;
+  std::vector<uint64_t> instructions_;
+  uint64_t total_cycles_ = 0;
+  uint64_t total_instructions_ = 0;
+
+  std::vector<Node> nodes_;
+  size_t current_ = 0;
+  size_t depth_ = 0;
+  size_t overflow_ = 0;  // calls past kMaxDepth, not in the tree
+  RetiredInstructionTracker retired_;
+
+  const DebugSymbols* symbols_ = nullptr;
+  SymbolResolver resolver_;
+};
+
+}  // namespace irata2::sim
+
+#endif  // IRATA2_SIM_GUEST_PROFILER_H
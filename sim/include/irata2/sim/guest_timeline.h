@@ -0,0 +1,107 @@
+#ifndef IRATA2_SIM_GUEST_TIMELINE_H
+#define IRATA2_SIM_GUEST_TIMELINE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <ostream>
+#include <span>
+#include <string>
+#include <vector>
+
+#include "irata2/base/types.h"
+#include "irata2/sim/debug_symbols.h"
+#include "irata2/sim/memory/memory.h"
+#include "irata2/sim/retired_instruction.h"
+
+namespace irata2::sim {
+
+class Cpu;
+
+/// Records guest activity as a timeline for Chrome trace-event viewers
+/// (chrome://tracing, Perfetto UI, speedscope).
+///
+/// Attach with Cpu::AttachTimeline(). Timestamps are CPU cycles, written
+/// as the format's microseconds, so one cycle reads as 1 us in a viewer.
+/// Four tracks are recorded:
+///
+/// - cpu: a span per call, opened by the instruction after a JSR, BRK or
+///   IRQ entry and closed by the one after RTS or RTI, named like
+///   GuestProfiler::NameFor(). IRQ and BRK handlers nest on the same stack
+///   under category "irq".
+/// - irq: a span from the cycle the IRQ line is first asserted to the
+///   first handler instruction, i.e. the interrupt latency.
+/// - video: a span per presented VGC frame, plus a global marker at each
+///   present.
+/// - mmio: an instant per CPU bus access to a device region.
+///
+/// Spans are written as complete events when they close, so unbalanced
+/// guest stacks cannot produce an unreadable trace; spans still open are
+/// closed at the last recorded cycle. Recording stops after max_events()
+/// events and the number dropped is reported in the trace metadata.
+class GuestTimeline {
+ public:
+  static constexpr size_t kMaxDepth = 256;
+  static constexpr size_t kDefaultMaxEvents = 1'000'000;
+
+  GuestTimeline() = default;
+
+  void SetSymbols(const DebugSymbols* symbols);
+  void set_max_events(size_t max_events) { max_events_ = max_events; }
+  size_t max_events() const { return max_events_; }
+
+  /// Called by the CPU at the end of every cycle with the device accesses
+  /// made during it.
+  void OnCycle(const Cpu& cpu, std::span<const memory::MemoryAccess> mmio);
+
+  size_t event_count() const { return events_.size(); }
+  uint64_t dropped_events() const { return dropped_; }
+
+  /// Chrome trace-event JSON (the object form with "traceEvents").
+  void WriteChromeTrace(std::ostream& out) const;
+
+ private:
+  enum class Track : uint8_t { Cpu = 1, Irq, Video, Mmio };
+
+  struct Event {
+    Track track = Track::Cpu;
+    char phase = 'X';  // 'X' complete, 'i' thread instant, 'I' global
+    uint64_t cycle = 0;
+    uint64_t duration = 0;
+    std::string name;
+    const char* category = "";
+    std::string args;  // JSON object body, without braces
+  };
+
+  struct OpenSpan {
+    uint64_t cycle = 0;
+    uint16_t entry = 0;
+    bool irq = false;
+  };
+
+  void OnInstructionStart(const Cpu& cpu, uint64_t cycle);
+  void Add(Event event);
+  Event CallSpan(const OpenSpan& span, uint64_t end) const;
+  std::string NameFor(uint16_t address) const;
+  std::string RegionName(const Cpu& cpu, base::Word address) const;
+
+  std::vector<Event> events_;
+  size_t max_events_ = kDefaultMaxEvents;
+  uint64_t dropped_ = 0;
+
+  bool started_ = false;
+  RetiredInstructionTracker retired_;
+  uint64_t last_cycle_ = 0;
+  std::vector<OpenSpan> stack_;
+  size_t overflow_ = 0;  // calls past kMaxDepth, not on the stack
+  bool irq_line_high_ = false;
+  std::optional<uint64_t> irq_requested_at_;
+  uint64_t frames_ = 0;
+  uint64_t frame_start_ = 0;
+
+  SymbolResolver resolver_;
+};
+
+}  // namespace irata2::sim
+
+#endif  // IRATA2_SIM_GUEST_TIMELINE_H
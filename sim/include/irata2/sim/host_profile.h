@@ -0,0 +1,115 @@
+#ifndef IRATA2_SIM_HOST_PROFILE_H
+#define IRATA2_SIM_HOST_PROFILE_H
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "irata2/base/tick_phase.h"
+
+#ifndef IRATA2_HOST_PROFILE
+#define IRATA2_HOST_PROFILE 0
+#endif
+
+namespace irata2::sim {
+
+class Component;
+
+/// Host time spent by the simulator in each tick phase.
+///
+/// Only collected in builds configured with -DIRATA2_HOST_PROFILE=ON. In
+/// other builds the timers in Cpu::Tick() are empty and the profile stays
+/// zero, so it costs nothing when disabled.
+///
+/// With the component breakdown enabled, each child of the CPU is also
+/// timed per phase and grouped by its C++ type. Children include all of
+/// their own descendants, so Memory covers every region and MMIO device.
+/// Timing each child separately adds clock reads, so phase totals are
+/// inflated slightly while the breakdown is on.
+class HostProfile {
+ public:
+  using Clock = std::chrono::steady_clock;
+  static constexpr bool kEnabled = IRATA2_HOST_PROFILE != 0;
+  static constexpr size_t kPhaseCount = 5;  // Control through Clear
+
+  struct ComponentTimes {
+    std::string type;
+    std::array<uint64_t, kPhaseCount> ns{};
+  };
+
+  uint64_t ticks() const { return ticks_; }
+  uint64_t phase_ns(base::TickPhase phase) const {
+    return phase_ns_[PhaseIndex(phase)];
+  }
+  uint64_t total_ns() const;
+  const std::vector<ComponentTimes>& components() const { return components_; }
+
+  bool component_breakdown() const { return component_breakdown_; }
+  void set_component_breakdown(bool enabled) { component_breakdown_ = enabled; }
+
+  void Reset();
+
+  /// Per-phase table (total ms, ns per tick, share), then the component
+  /// breakdown if it was collected.
+  void WriteTable(std::ostream& out) const;
+
+  // Called from Cpu::Tick().
+  void AddTick() { ++ticks_; }
+  void AddPhase(base::TickPhase phase, uint64_t ns) {
+    phase_ns_[PhaseIndex(phase)] += ns;
+  }
+  /// Slot in components() for @p component, keyed by its dynamic type.
+  size_t ComponentSlot(const Component& component);
+  void AddComponent(size_t slot, base::TickPhase phase, uint64_t ns) {
+    components_[slot].ns[PhaseIndex(phase)] += ns;
+  }
+
+  static uint64_t ElapsedNs(Clock::time_point start) {
+    return static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() -
+                                                             start)
+            .count());
+  }
+
+ private:
+  static size_t PhaseIndex(base::TickPhase phase) {
+    return static_cast<size_t>(phase) - static_cast<size_t>(base::TickPhase::Control);
+  }
+
+  uint64_t ticks_ = 0;
+  std::array<uint64_t, kPhaseCount> phase_ns_{};
+  std::vector<ComponentTimes> components_;
+  bool component_breakdown_ = false;
+};
+
+/// Scoped timer charging one phase of a tick. Empty unless the build has
+/// IRATA2_HOST_PROFILE enabled.
+class HostPhaseTimer {
+ public:
+#if IRATA2_HOST_PROFILE
+  HostPhaseTimer(HostProfile& profile, base::TickPhase phase)
+      : profile_(profile), phase_(phase), start_(HostProfile::Clock::now()) {}
+  ~HostPhaseTimer() {
+    profile_.AddPhase(phase_, HostProfile::ElapsedNs(start_));
+  }
+
+ private:
+  HostProfile& profile_;
+  base::TickPhase phase_;
+  HostProfile::Clock::time_point start_;
+#else
+  HostPhaseTimer(HostProfile&, base::TickPhase) {}
+#endif
+
+ public:
+  HostPhaseTimer(const HostPhaseTimer&) = delete;
+  HostPhaseTimer& operator=(const HostPhaseTimer&) = delete;
+};
+
+}  // namespace irata2::sim
+
+#endif  // IRATA2_SIM_HOST_PROFILE_H
@@ -33,6 +33,13 @@ class InstructionRegister final : public ByteRegister {
     return ByteRegister::value();
   }
 
+  /// True while an IRQ entry is being injected in place of the fetched
+  /// opcode, from the instruction start that took the interrupt.
+  bool injecting_interrupt() const { return inject_interrupt_; }
+
+  /// The opcode byte last loaded from memory, ignoring any IRQ injection.
+  base::Byte fetched_value() const { return ByteRegister::value(); }
+
   void TickProcess() override {
     ByteRegister::TickProcess();
 
@@ -46,6 +53,16 @@ class InstructionRegister final : public ByteRegister {
     }
   }
 
+  void SaveState(SnapshotWriter& out) const override {
+    ByteRegister::SaveState(out);
+    out.Write(inject_interrupt_);
+  }
+
+  void LoadState(SnapshotReader& in) override {
+    ByteRegister::LoadState(in);
+    in.Read(inject_interrupt_);
+  }
+
  private:
   const LatchedProcessControl& irq_line_;
   const ProcessControl<true>& instruction_start_;
@@ -0,0 +1,126 @@
+#ifndef IRATA2_SIM_IO_DMA_CONTROLLER_H
+#define IRATA2_SIM_IO_DMA_CONTROLLER_H
+
+#include <cstddef>
+#include <cstdint>
+
+#include "irata2/base/types.h"
+#include "irata2/sim/control.h"
+#include "irata2/sim/memory/module.h"
+
+namespace irata2::sim::io {
+
+/// DMA controller base address in memory map.
+/// $4200 is reserved for the sound device, so DMA sits at $4300.
+constexpr uint16_t DMA_BASE = 0x4300;
+
+/// DMA controller MMIO register offsets (relative to DMA_BASE).
+namespace dma_reg {
+constexpr uint8_t SRC_LO = 0x00;   // W: source address low byte
+constexpr uint8_t SRC_HI = 0x01;   // W: source address high byte
+constexpr uint8_t DST_LO = 0x02;   // W: destination address low byte
+constexpr uint8_t DST_HI = 0x03;   // W: destination address high byte
+constexpr uint8_t LEN_LO = 0x04;   // W: transfer length low byte
+constexpr uint8_t LEN_HI = 0x05;   // W: transfer length high byte
+constexpr uint8_t FILL = 0x06;     // W: fill value for FILL mode
+constexpr uint8_t MODE = 0x07;     // W: transfer mode (see dma_mode)
+constexpr uint8_t CONTROL = 0x08;  // W: bit 0=start, bit 7=enable IRQ
+constexpr uint8_t STATUS = 0x09;   // R: bit 0=busy, bit 7=IRQ pending (read acks)
+}  // namespace dma_reg
+
+/// Transfer modes.
+namespace dma_mode {
+constexpr uint8_t COPY = 0x00;    // SRC..SRC+LEN -> DST..DST+LEN
+constexpr uint8_t FILL = 0x01;    // FILL value -> DST..DST+LEN
+constexpr uint8_t STREAM = 0x02;  // SRC..SRC+LEN -> fixed port at DST
+}  // namespace dma_mode
+
+/// Status register bit positions.
+namespace dma_status {
+constexpr uint8_t BUSY = 0x01;
+constexpr uint8_t IRQ_PENDING = 0x80;
+}  // namespace dma_status
+
+/// Control register bit positions.
+namespace dma_control {
+constexpr uint8_t START = 0x01;
+constexpr uint8_t IRQ_ENABLE = 0x80;
+}  // namespace dma_control
+
+/// Memory-to-memory and memory-to-MMIO block transfer engine.
+///
+/// Like the other demo devices this is not hardware-ish: the whole transfer
+/// happens on the host when START is written, as one memmove/memset over the
+/// RAM backing store whenever both ends are plain storage. Ranges that touch
+/// MMIO (and every STREAM transfer) fall back to per-byte Memory writes so
+/// device side effects still fire. Both paths give COPY memmove semantics,
+/// so overlapping ranges copy correctly either way.
+///
+/// What the guest observes is the modeled cost: BUSY stays set for
+/// kSetupCycles plus a per-byte charge, and the completion IRQ is raised
+/// when that budget elapses. Nothing is ticked per byte on the host.
+///
+/// MMIO Map (16 bytes at $4300-$430F):
+///   $4300-$4301 SRC     (W)  - Source address (lo/hi)
+///   $4302-$4303 DST     (W)  - Destination address (lo/hi)
+///   $4304-$4305 LEN     (W)  - Length in bytes (lo/hi), 0 = no-op
+///   $4306       FILL    (W)  - Fill value
+///   $4307       MODE    (W)  - COPY / FILL / STREAM
+///   $4308       CONTROL (W)  - Start transfer, IRQ enable
+///   $4309       STATUS  (R)  - Busy, IRQ pending (reading acknowledges)
+///
+/// @see docs/projects/demo-surface.md for full specification
+class DmaController final : public memory::Module {
+ public:
+  static constexpr size_t MMIO_SIZE = 16;
+  static constexpr uint64_t kSetupCycles = 4;
+  static constexpr uint64_t kFillCyclesPerByte = 1;
+  static constexpr uint64_t kCopyCyclesPerByte = 2;
+
+  DmaController(std::string name,
+                Component& parent,
+                LatchedProcessControl& irq_line);
+
+  // Module interface
+  size_t size() const override { return MMIO_SIZE; }
+  base::Byte Read(base::Word address) const override;
+  void Write(base::Word address, base::Byte value) override;
+
+  bool busy() const { return busy_; }
+  bool irq_pending() const { return irq_enabled_ && done_; }
+
+  /// Modeled guest-cycle cost of a transfer.
+  static uint64_t TransferCycles(uint8_t mode, uint16_t length);
+
+  void SaveState(SnapshotWriter& out) const override;
+  void LoadState(SnapshotReader& in) override;
+
+ private:
+  base::Word source() const { return base::Word(src_hi_, src_lo_); }
+  base::Word destination() const { return base::Word(dst_hi_, dst_lo_); }
+  uint16_t length() const {
+    return static_cast<uint16_t>((len_hi_ << 8) | len_lo_);
+  }
+
+  void Start();
+  void Transfer();
+  void TickControl() override;
+
+  base::Byte src_lo_;
+  base::Byte src_hi_;
+  base::Byte dst_lo_;
+  base::Byte dst_hi_;
+  uint8_t len_lo_ = 0;
+  uint8_t len_hi_ = 0;
+  base::Byte fill_;
+  uint8_t mode_ = dma_mode::COPY;
+  bool irq_enabled_ = false;
+  bool busy_ = false;
+  mutable bool done_ = false;  // cleared by STATUS reads
+  uint64_t complete_cycle_ = 0;
+  LatchedProcessControl& irq_line_;
+};
+
+}  // namespace irata2::sim::io
+
+#endif  // IRATA2_SIM_IO_DMA_CONTROLLER_H
@@ -4,7 +4,9 @@
 #include <array>
 #include <cstddef>
 #include <cstdint>
+#include <optional>
 
+#include "irata2/base/spsc_queue.h"
 #include "irata2/base/types.h"
 #include "irata2/sim/component.h"
 #include "irata2/sim/control.h"
@@ -48,11 +50,33 @@ namespace input_control {
 constexpr uint8_t IRQ_ENABLE = 0x01;  // Bit 0: enable IRQ on input
 }  // namespace input_control
 
+/// Input change posted by a host thread for the device to apply.
+struct HostInputEvent {
+  enum class Kind : uint8_t {
+    KeyDown,   // set a KEY_STATE bit
+    KeyUp,     // clear a KEY_STATE bit
+    KeyPress,  // enqueue a key code
+  };
+  Kind kind = Kind::KeyPress;
+  uint8_t value = 0;
+  /// Earliest CPU cycle at which the event applies; 0 means the next tick.
+  uint64_t cycle = 0;
+};
+
 /// Input device with 16-byte keyboard queue and MMIO registers.
 ///
 /// This device accepts keyboard input from the frontend, buffers it in a
 /// circular queue, and exposes it to the CPU via memory-mapped I/O.
 ///
+/// inject_key() and set_key_down()/set_key_up() change guest-visible state
+/// directly and must only be called from the thread running the CPU. Other
+/// threads (an SDL event loop, a replay driver, a test harness) call
+/// PostHostEvent() instead, which pushes onto a lock-free SPSC ring. The
+/// device drains that ring at the start of its control phase each tick,
+/// applying every event whose cycle stamp has been reached, in order. An
+/// event stamped in the future holds back the ones behind it, so replays
+/// stamped with recorded cycles reproduce exactly.
+///
 /// MMIO Map (16 bytes at $4000-$400F):
 ///   $4000 STATUS  (R)  - Status flags
 ///   $4001 CONTROL (W)  - Control register
@@ -66,6 +90,7 @@ class InputDevice final : public memory::Module {
  public:
   static constexpr size_t QUEUE_SIZE = 16;
   static constexpr size_t MMIO_SIZE = 16;  // Power of 2, aligned
+  static constexpr size_t kHostEventCapacity = 64;
 
   InputDevice(std::string name, Component& parent, LatchedProcessControl& irq_line);
 
@@ -81,6 +106,15 @@ class InputDevice final : public memory::Module {
   void set_key_down(uint8_t bit);
   void set_key_up(uint8_t bit);
 
+  // Host interface - callable from one producer thread other than the CPU's.
+  // Returns false, dropping the event, if the ring is full.
+  bool PostHostEvent(const HostInputEvent& event);
+
+  // While disabled, posted events stay queued instead of being applied.
+  // Used to keep speculative frames from consuming input they would lose
+  // on rollback.
+  void set_host_events_enabled(bool enabled) { host_events_enabled_ = enabled; }
+
   // Key state query (for testing)
   uint8_t key_state() const { return key_state_; }
 
@@ -92,6 +126,9 @@ class InputDevice final : public memory::Module {
   bool full() const { return count_ == QUEUE_SIZE; }
   size_t count() const { return count_; }
 
+  void SaveState(SnapshotWriter& out) const override;
+  void LoadState(SnapshotReader& in) override;
+
  private:
   std::array<uint8_t, QUEUE_SIZE> queue_{};
   size_t read_idx_ = 0;
@@ -101,6 +138,13 @@ class InputDevice final : public memory::Module {
   uint8_t key_state_ = 0;  // Bitmask of currently held keys
   LatchedProcessControl& irq_line_;
 
+  // Host-side plumbing, not guest state: excluded from snapshots.
+  base::SpscQueue<HostInputEvent, kHostEventCapacity> host_events_;
+  std::optional<HostInputEvent> held_event_;  // popped but not yet due
+  bool host_events_enabled_ = true;
+
+  void DrainHostEvents();
+  void Apply(const HostInputEvent& event);
   uint8_t pop();
   uint8_t peek() const;
 
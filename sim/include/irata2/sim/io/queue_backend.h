@@ -0,0 +1,57 @@
+#ifndef IRATA2_SIM_IO_QUEUE_BACKEND_H
+#define IRATA2_SIM_IO_QUEUE_BACKEND_H
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include "irata2/base/spsc_queue.h"
+#include "irata2/sim/io/vgc_backend.h"
+
+namespace irata2::sim::io {
+
+/// One presented VGC frame: every command issued since the previous
+/// present, in order.
+struct VgcFrame {
+  uint64_t sequence = 0;
+  std::vector<VgcCommand> commands;
+};
+
+/// Backend that hands whole frames to another thread instead of drawing.
+///
+/// The emulation thread owns the coprocessor and this backend; each present
+/// moves the accumulated commands into a lock-free queue for a render thread
+/// to replay into a real backend. If the renderer has fallen behind and the
+/// queue is full, the new frame is dropped and counted rather than stalling
+/// emulation.
+class QueueBackend final : public VgcBackend {
+ public:
+  static constexpr size_t kQueueDepth = 4;
+  using FrameQueue = base::SpscQueue<VgcFrame, kQueueDepth>;
+
+  explicit QueueBackend(FrameQueue& queue) : queue_(queue) {}
+
+  void clear(uint8_t intensity) override;
+  void draw_point(uint8_t x, uint8_t y, uint8_t intensity) override;
+  void draw_line(uint8_t x0,
+                 uint8_t y0,
+                 uint8_t x1,
+                 uint8_t y1,
+                 uint8_t intensity) override;
+  void present() override;
+  void submit(std::span<const VgcCommand> commands) override;
+
+  uint64_t frames_pushed() const { return frames_pushed_; }
+  uint64_t frames_dropped() const { return frames_dropped_; }
+
+ private:
+  FrameQueue& queue_;
+  VgcFrame frame_;
+  uint64_t frames_pushed_ = 0;
+  uint64_t frames_dropped_ = 0;
+};
+
+}  // namespace irata2::sim::io
+
+#endif  // IRATA2_SIM_IO_QUEUE_BACKEND_H
@@ -0,0 +1,65 @@
+#ifndef IRATA2_SIM_IO_SOUND_BACKEND_H
+#define IRATA2_SIM_IO_SOUND_BACKEND_H
+
+#include <cstdint>
+#include <fstream>
+#include <span>
+#include <string>
+#include <vector>
+
+namespace irata2::sim::io {
+
+/// Destination for synthesized audio: signed 16-bit mono samples at the
+/// sound device's sample rate, delivered in blocks.
+class SoundBackend {
+ public:
+  virtual ~SoundBackend() = default;
+
+  virtual void submit(std::span<const int16_t> samples) = 0;
+};
+
+/// Headless backend that keeps every sample in memory (testing).
+class BufferSoundBackend final : public SoundBackend {
+ public:
+  void submit(std::span<const int16_t> samples) override;
+
+  const std::vector<int16_t>& samples() const { return samples_; }
+  uint64_t blocks() const { return blocks_; }
+
+ private:
+  std::vector<int16_t> samples_;
+  uint64_t blocks_ = 0;
+};
+
+/// Streams samples to a 16-bit mono PCM WAV file.
+///
+/// The header's size fields are patched when the backend is closed. The
+/// destructor closes too, but it cannot report errors, so call Close()
+/// when failure matters.
+class WavSoundBackend final : public SoundBackend {
+ public:
+  WavSoundBackend(const std::string& path, uint32_t sample_rate);
+  ~WavSoundBackend() override;
+
+  WavSoundBackend(const WavSoundBackend&) = delete;
+  WavSoundBackend& operator=(const WavSoundBackend&) = delete;
+
+  void submit(std::span<const int16_t> samples) override;
+
+  /// Finish the file. Throws SimError on I/O failure.
+  void Close();
+
+  uint64_t samples_written() const { return samples_written_; }
+
+ private:
+  std::ofstream out_;
+  std::string path_;
+  uint32_t sample_rate_;
+  uint64_t samples_written_ = 0;
+
+  void WriteHeader();
+};
+
+}  // namespace irata2::sim::io
+
+#endif  // IRATA2_SIM_IO_SOUND_BACKEND_H
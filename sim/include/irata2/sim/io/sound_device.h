@@ -0,0 +1,122 @@
+#ifndef IRATA2_SIM_IO_SOUND_DEVICE_H
+#define IRATA2_SIM_IO_SOUND_DEVICE_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+#include "irata2/base/types.h"
+#include "irata2/sim/io/sound_backend.h"
+#include "irata2/sim/memory/module.h"
+
+namespace irata2::sim::io {
+
+/// Sound device base address in memory map.
+constexpr uint16_t SOUND_BASE = 0x4200;
+
+/// Sound device MMIO register offsets (relative to SOUND_BASE).
+namespace sound_reg {
+constexpr uint8_t FREQ_LO = 0x00;   // W: frequency in Hz, low byte
+constexpr uint8_t FREQ_HI = 0x01;   // W: frequency in Hz, high byte
+constexpr uint8_t DURATION = 0x02;  // W: length in duration ticks, 0 = forever
+constexpr uint8_t VOLUME = 0x03;    // W: 0-15
+constexpr uint8_t CONTROL = 0x04;   // W: bit 0=play (0 stops), bit 1=reset
+constexpr uint8_t STATUS = 0x05;    // R: bit 0=playing
+}  // namespace sound_reg
+
+namespace sound_control {
+constexpr uint8_t PLAY = 0x01;
+constexpr uint8_t RESET = 0x02;
+}  // namespace sound_control
+
+namespace sound_status {
+constexpr uint8_t PLAYING = 0x01;
+}  // namespace sound_status
+
+struct SoundConfig {
+  /// Emulated CPU clock, used to turn cycle stamps into sample positions.
+  uint32_t cpu_hz = 100000;
+  uint32_t sample_rate = 44100;
+  /// DURATION counts ticks of this rate (one frame at 60 FPS).
+  uint32_t duration_tick_hz = 60;
+};
+
+/// Single-channel square-wave generator.
+///
+/// The device does no per-cycle work. A register write first synthesizes
+/// every sample between the last synthesized point and the write's cycle
+/// using the old settings, then applies the new value, so each change lands
+/// on the sample its cycle stamp maps to. Samples are generated in tight
+/// loops into a fixed block that goes to the SoundBackend whenever it
+/// fills. The host calls Sync() (once per frame, or at the end of a
+/// headless run) to catch up to the current cycle and push out the partial
+/// block. STATUS is computed from the cycle count when read.
+///
+/// MMIO Map (16 bytes at $4200-$420F):
+///   $4200-$4201 FREQ     (W)  - Frequency in Hz (lo/hi)
+///   $4202       DURATION (W)  - Duration ticks, 0 = until stopped
+///   $4203       VOLUME   (W)  - Volume 0-15
+///   $4204       CONTROL  (W)  - Play/stop, reset
+///   $4205       STATUS   (R)  - Playing
+///
+/// @see docs/projects/demo-surface.md for full specification
+class SoundDevice final : public memory::Module {
+ public:
+  static constexpr size_t MMIO_SIZE = 16;
+  static constexpr size_t kBlockSize = 512;
+  static constexpr int16_t kMaxAmplitude = 8000;
+
+  SoundDevice(std::string name,
+              Component& parent,
+              std::unique_ptr<SoundBackend> backend,
+              SoundConfig config = {});
+
+  size_t size() const override { return MMIO_SIZE; }
+  base::Byte Read(base::Word address) const override;
+  void Write(base::Word address, base::Byte value) override;
+
+  SoundBackend& backend() { return *backend_; }
+  const SoundConfig& config() const { return config_; }
+
+  /// Synthesize up to the current cycle and submit any buffered samples.
+  void Sync();
+
+  bool playing() const;
+  uint64_t samples_generated() const { return samples_generated_; }
+
+  /// When disabled, samples are still generated (so timing is unaffected)
+  /// but discarded instead of reaching the backend. Used for speculative
+  /// frames.
+  void set_output_enabled(bool enabled) { output_enabled_ = enabled; }
+
+  void SaveState(SnapshotWriter& out) const override;
+  void LoadState(SnapshotReader& in) override;
+
+ private:
+  uint64_t SampleAt(uint64_t cycle) const;
+  void AdvanceTo(uint64_t cycle);
+  void Fill(int16_t* out, size_t count);
+  void FlushBlock();
+  void Reset();
+
+  std::unique_ptr<SoundBackend> backend_;
+  SoundConfig config_;
+
+  uint8_t freq_lo_ = 0;
+  uint8_t freq_hi_ = 0;
+  uint8_t duration_ = 0;
+  uint8_t volume_ = 0;
+  bool playing_ = false;
+  uint64_t end_cycle_ = 0;  // 0 = no end
+  uint32_t phase_ = 0;
+  uint64_t samples_generated_ = 0;
+  bool output_enabled_ = true;
+
+  std::array<int16_t, kBlockSize> block_{};
+  size_t block_fill_ = 0;
+};
+
+}  // namespace irata2::sim::io
+
+#endif  // IRATA2_SIM_IO_SOUND_DEVICE_H
@@ -1,6 +1,7 @@
 #ifndef IRATA2_SIM_IO_VECTOR_GRAPHICS_COPROCESSOR_H
 #define IRATA2_SIM_IO_VECTOR_GRAPHICS_COPROCESSOR_H
 
+#include <array>
 #include <cstddef>
 #include <cstdint>
 #include <memory>
@@ -8,6 +9,7 @@
 #include "irata2/base/types.h"
 #include "irata2/sim/memory/module.h"
 #include "irata2/sim/io/vgc_backend.h"
+#include "irata2/sim/io/vgc_capture.h"
 
 namespace irata2::sim::io {
 
@@ -23,8 +25,24 @@ constexpr uint8_t COLOR = 0x05;
 constexpr uint8_t EXEC = 0x06;
 constexpr uint8_t CONTROL = 0x07;
 constexpr uint8_t STATUS = 0x08;
+constexpr uint8_t STREAM = 0x09;  // W: packed command port (see vgc_packed)
+constexpr uint8_t DL_ADDR_LO = 0x0A;  // W: display list address low byte
+constexpr uint8_t DL_ADDR_HI = 0x0B;  // W: display list address high byte
+constexpr uint8_t DL_COUNT = 0x0C;    // W: run N packed commands from DL_ADDR
+constexpr uint8_t SHAPE_ADDR_LO = 0x0D;  // W: shape definition address low
+constexpr uint8_t SHAPE_ADDR_HI = 0x0E;  // W: shape definition address high
+constexpr uint8_t SHAPE_LOAD = 0x0F;     // W: copy definition into shape N
+constexpr uint8_t SCALE = 0x10;          // W: DRAW_SHAPE scale, 4.4 fixed
 }  // namespace vgc_reg
 
+/// Packed command layout accepted by the STREAM port and display lists: six
+/// bytes per command in register order (CMD, X0, Y0, X1, Y1, COLOR). Lets a
+/// DMA stream or a tight store loop feed commands through a single fixed
+/// address, or a whole frame be submitted from memory in one write.
+namespace vgc_packed {
+constexpr size_t kCommandSize = 6;
+}  // namespace vgc_packed
+
 namespace vgc_status {
 constexpr uint8_t BUSY = 0x01;
 constexpr uint8_t IRQ_PENDING = 0x80;
@@ -41,11 +59,53 @@ constexpr uint8_t NOP = 0x00;
 constexpr uint8_t CLEAR = 0x01;
 constexpr uint8_t POINT = 0x02;
 constexpr uint8_t LINE = 0x03;
+constexpr uint8_t DRAW_SHAPE = 0x04;  // X0/Y0 origin, X1 shape, Y1 rotation
+constexpr uint8_t GLYPH = 0x05;       // X0/Y0 top-left, X1 character
+constexpr uint8_t TEXT = 0x06;        // X0/Y0 top-left, X1/Y1 string address
 }  // namespace vgc_cmd
 
+/// Shape RAM layout. A definition in CPU memory is a header byte (vertex
+/// count in bits 0-4, CLOSED in bit 7) followed by that many signed (dx, dy)
+/// byte pairs relative to the shape's origin. Counts above kMaxVertices are
+/// clamped; a count of zero empties the slot.
+namespace vgc_shape {
+constexpr size_t kShapeCount = 32;
+constexpr size_t kMaxVertices = 16;
+constexpr uint8_t COUNT_MASK = 0x1F;
+constexpr uint8_t CLOSED = 0x80;
+constexpr uint8_t kUnitScale = 0x10;
+}  // namespace vgc_shape
+
+/// Vector graphics coprocessor with streaming registers and display lists.
+///
+/// Commands can be issued three ways, all of which share the same decoder:
+/// discrete register writes followed by EXEC, six-byte packets written to
+/// STREAM, or a display list of packed commands in memory that runs when
+/// DL_COUNT is written.
+///
+/// DRAW_SHAPE draws a polyline from shape RAM, rotated by Y1/256 of a turn
+/// (clockwise on screen, so with 16 directions each step is 16), scaled by
+/// SCALE and translated to (X0, Y0). The transform runs on the coprocessor
+/// in fixed point and the resulting segments are clipped to the screen, so
+/// guest code issues one command per object instead of transforming every
+/// vertex itself.
+///
+/// GLYPH and TEXT draw characters from the built-in stroke font (see
+/// vgc_font.h) at SCALE, TEXT reading a NUL-terminated string from CPU
+/// memory where '\n' starts a new line. The string is read from RAM or ROM
+/// only, so it also ends at a device region or unmapped address. A whole
+/// HUD line is then one command rather than a line submission per stroke.
+///
+/// Decoded commands are accumulated and handed to VgcBackend::submit() as a
+/// batch on PRESENT or when the accumulator fills, so backends see one call
+/// per frame rather than one virtual call per primitive. Host code that
+/// inspects a backend mid-frame should call Flush() first.
+///
+/// @see docs/projects/demo-surface.md for full specification
 class VectorGraphicsCoprocessor final : public memory::Module {
  public:
-  static constexpr size_t MMIO_SIZE = 16;
+  static constexpr size_t MMIO_SIZE = 32;
+  static constexpr size_t kBatchCapacity = 256;
 
   VectorGraphicsCoprocessor(std::string name,
                             Component& parent,
@@ -58,7 +118,51 @@ class VectorGraphicsCoprocessor final : public memory::Module {
   VgcBackend& backend() { return *backend_; }
   const VgcBackend& backend() const { return *backend_; }
 
+  /// Walk `count` packed commands starting at `address` in CPU memory.
+  /// This is what a DL_COUNT write triggers.
+  void RunDisplayList(base::Word address, uint8_t count);
+
+  /// Copy the shape definition at `address` in CPU memory into slot `id`.
+  /// This is what a SHAPE_LOAD write triggers.
+  void LoadShape(uint8_t id, base::Word address);
+
+  /// Submit any accumulated commands to the backend.
+  void Flush();
+
+  /// Number of commands waiting in the accumulator.
+  size_t pending_commands() const { return batch_size_; }
+
+  /// When disabled, decoded commands are discarded instead of reaching the
+  /// backend and PRESENT does not present, though it is still reported to
+  /// the CPU. Used to run frames speculatively without showing them.
+  void set_output_enabled(bool enabled) { output_enabled_ = enabled; }
+  bool output_enabled() const { return output_enabled_; }
+
+  /// Log every command and present that reaches the backend, stamped with
+  /// the CPU cycle it was issued on, to @p capture. Commands are logged
+  /// when their batch is submitted, so ones dropped by a later CLEAR in the
+  /// same batch are not. Pass nullptr to stop. The writer is not
+  /// owned and must outlive the coprocessor or be detached first.
+  void set_capture(VgcCaptureWriter* capture) { capture_ = capture; }
+
+  /// Running totals since construction, for per-frame accounting: drawing
+  /// commands decoded (NOPs excluded), lines appended including those of
+  /// shapes and glyphs, and clears. Host-side counters, not snapshotted,
+  /// and counted whether or not output is enabled.
+  uint64_t commands_issued() const { return commands_issued_; }
+  uint64_t lines_drawn() const { return lines_drawn_; }
+  uint64_t clears() const { return clears_; }
+
+  void SaveState(SnapshotWriter& out) const override;
+  void LoadState(SnapshotReader& in) override;
+
  private:
+  struct Shape {
+    uint8_t count = 0;
+    bool closed = false;
+    std::array<int8_t, vgc_shape::kMaxVertices * 2> vertices{};
+  };
+
   std::unique_ptr<VgcBackend> backend_;
   uint8_t cmd_ = 0;
   uint8_t x0_ = 0;
@@ -67,9 +171,43 @@ class VectorGraphicsCoprocessor final : public memory::Module {
   uint8_t y1_ = 0;
   uint8_t color_ = 0;
   bool irq_enabled_ = false;
+  std::array<uint8_t, vgc_packed::kCommandSize> stream_{};
+  size_t stream_fill_ = 0;
+  uint8_t dl_addr_lo_ = 0;
+  uint8_t dl_addr_hi_ = 0;
+  uint8_t shape_addr_lo_ = 0;
+  uint8_t shape_addr_hi_ = 0;
+  uint8_t scale_ = vgc_shape::kUnitScale;
+  std::array<Shape, vgc_shape::kShapeCount> shapes_{};
+  std::array<VgcCommand, kBatchCapacity> batch_{};
+  size_t batch_size_ = 0;
+  // Issue cycle per batched command, for the capture only; not snapshotted.
+  std::array<uint64_t, kBatchCapacity> batch_cycles_{};
+  bool output_enabled_ = true;
+  VgcCaptureWriter* capture_ = nullptr;
+  uint64_t commands_issued_ = 0;
+  uint64_t lines_drawn_ = 0;
+  uint64_t clears_ = 0;
 
   uint8_t intensity() const { return static_cast<uint8_t>(color_ & 0x03); }
   void ExecuteCommand();
+  void Dispatch(uint8_t cmd,
+                uint8_t x0,
+                uint8_t y0,
+                uint8_t x1,
+                uint8_t y1,
+                uint8_t intensity);
+  void Append(const VgcCommand& command);
+  void DrawShape(uint8_t x,
+                 uint8_t y,
+                 uint8_t id,
+                 uint8_t rotation,
+                 uint8_t intensity);
+  void AppendClippedLine(int x0, int y0, int x1, int y1, uint8_t intensity);
+  void DrawGlyph(int x, int y, char c, uint8_t intensity);
+  void DrawText(uint8_t x, uint8_t y, base::Word address, uint8_t intensity);
+  void ExecutePacked(const uint8_t* packed);
+  void WriteStream(uint8_t raw);
   void ApplyControl(uint8_t control);
 };
 
@@ -2,11 +2,33 @@
 #define IRATA2_SIM_IO_VGC_BACKEND_H
 
 #include <array>
+#include <bitset>
 #include <cstdint>
 #include <cstddef>
+#include <span>
+#include <vector>
 
 namespace irata2::sim::io {
 
+/// Primitive kinds carried in a VgcCommand batch.
+enum class VgcOp : uint8_t {
+  Clear,
+  Point,
+  Line,
+};
+
+/// One decoded drawing primitive. Unused coordinates are zero.
+struct VgcCommand {
+  VgcOp op = VgcOp::Clear;
+  uint8_t x0 = 0;
+  uint8_t y0 = 0;
+  uint8_t x1 = 0;
+  uint8_t y1 = 0;
+  uint8_t intensity = 0;
+
+  bool operator==(const VgcCommand&) const = default;
+};
+
 class VgcBackend {
  public:
   virtual ~VgcBackend() = default;
@@ -19,12 +41,56 @@ class VgcBackend {
                          uint8_t y1,
                          uint8_t intensity) = 0;
   virtual void present() = 0;
+
+  /// Draw a batch of commands in order.
+  ///
+  /// The coprocessor accumulates commands and hands them over here on
+  /// PRESENT or when its buffer fills. The default forwards each command to
+  /// the per-primitive methods; backends override it to amortize state
+  /// changes across the whole batch.
+  virtual void submit(std::span<const VgcCommand> commands);
+};
+
+/// Axis-aligned pixel bounds, inclusive at x0/y0 and exclusive at x1/y1.
+struct DirtyRect {
+  size_t x0 = 0;
+  size_t y0 = 0;
+  size_t x1 = 0;
+  size_t y1 = 0;
+
+  bool empty() const { return x1 <= x0 || y1 <= y0; }
+  bool operator==(const DirtyRect&) const = default;
 };
 
+/// Headless backend that rasterizes into a 256x256 intensity buffer.
+///
+/// Rasterization is deferred. Draw calls are recorded, and everything since
+/// the last clear is only rasterized when the framebuffer or dirty state is
+/// read, or every Nth present if set_rasterize_interval() asks for it. A
+/// clear drops the commands recorded before it, because it would paint over
+/// them anyway. Runs that never look at a frame never pay to draw it, and
+/// stream_hash() identifies the frame from its commands without touching
+/// pixels.
+///
+/// Lines are drawn as spans: horizontal, vertical, and 45-degree lines take
+/// dedicated loops, everything else falls back to Bresenham. Because
+/// coordinates are uint8_t and the buffer is 256 wide, nothing is clipped.
+///
+/// The backend keeps two kinds of row bookkeeping. Rows drawn since the last
+/// clear let a clear to the same background only reset those rows instead of
+/// all 64K bytes. Separately, the dirty rows and dirty rectangle record
+/// everything that changed since the consumer last called reset_dirty(), so
+/// golden-image comparisons and frame hashing can skip untouched pixels.
+///
+/// The const accessors rasterize into mutable state, so a backend must not
+/// be read from several threads at once.
 class ImageBackend final : public VgcBackend {
  public:
   static constexpr size_t kWidth = 256;
   static constexpr size_t kHeight = 256;
+  /// Recorded commands beyond this are rasterized eagerly so a program that
+  /// never clears cannot grow the log without bound.
+  static constexpr size_t kMaxRecordedCommands = 65536;
 
   void clear(uint8_t intensity) override;
   void draw_point(uint8_t x, uint8_t y, uint8_t intensity) override;
@@ -33,14 +99,64 @@ class ImageBackend final : public VgcBackend {
                  uint8_t x1,
                  uint8_t y1,
                  uint8_t intensity) override;
-  void present() override {}
+  void present() override;
+  void submit(std::span<const VgcCommand> commands) override;
 
   const std::array<uint8_t, kWidth * kHeight>& framebuffer() const {
+    Rasterize();
     return framebuffer_;
   }
 
+  /// Bounding box of pixels written since the last reset_dirty().
+  const DirtyRect& dirty_rect() const {
+    Rasterize();
+    return dirty_rect_;
+  }
+  /// Rows written since the last reset_dirty().
+  const std::bitset<kHeight>& dirty_rows() const {
+    Rasterize();
+    return dirty_rows_;
+  }
+  bool row_dirty(size_t y) const { return dirty_rows().test(y); }
+  void reset_dirty();
+
+  /// Rasterize on every Nth present(). Zero (the default) rasterizes only
+  /// when the framebuffer is read.
+  void set_rasterize_interval(uint64_t frames) { rasterize_interval_ = frames; }
+  uint64_t frames_presented() const { return frames_presented_; }
+
+  /// Commands recorded but not yet rasterized.
+  size_t recorded_commands() const { return recorded_.size(); }
+
+  /// FNV-1a hash of the commands issued since the last clear, including the
+  /// clear itself. Frames with equal hashes drew the same thing, barring a
+  /// 64-bit collision.
+  uint64_t stream_hash() const { return stream_hash_; }
+
  private:
-  std::array<uint8_t, kWidth * kHeight> framebuffer_{};
+  static constexpr uint64_t kFnvOffset = 0xcbf29ce484222325ULL;
+  static constexpr uint64_t kFnvPrime = 0x100000001b3ULL;
+
+  void Record(const VgcCommand& command);
+  // Rasterizing only materializes state the recorded commands already
+  // define, so it and the raster helpers are const over mutable state.
+  void Rasterize() const;
+  void Clear(uint8_t intensity) const;
+  void Plot(size_t x, size_t y, uint8_t intensity) const;
+  void RasterizeLine(int x0, int y0, int x1, int y1, uint8_t intensity) const;
+  void MarkDirty(size_t x0, size_t y0, size_t x1, size_t y1) const;
+  void ExtendDirtyRect(size_t x0, size_t y0, size_t x1, size_t y1) const;
+
+  mutable std::vector<VgcCommand> recorded_;
+  uint64_t stream_hash_ = kFnvOffset;
+  uint64_t rasterize_interval_ = 0;
+  uint64_t frames_presented_ = 0;
+
+  mutable std::array<uint8_t, kWidth * kHeight> framebuffer_{};
+  mutable uint8_t background_ = 0;
+  mutable std::bitset<kHeight> drawn_rows_;
+  mutable std::bitset<kHeight> dirty_rows_;
+  mutable DirtyRect dirty_rect_;
 };
 
 }  // namespace irata2::sim::io
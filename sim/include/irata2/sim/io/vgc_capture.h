@@ -0,0 +1,117 @@
+#ifndef IRATA2_SIM_IO_VGC_CAPTURE_H
+#define IRATA2_SIM_IO_VGC_CAPTURE_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <optional>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "irata2/sim/io/vgc_backend.h"
+
+namespace irata2::sim::io {
+
+/// Binary VGC capture format.
+///
+/// A capture is an 8-byte header ("IVGC", u16 version, u16 reserved, little
+/// endian) followed by one record per command or present. Each record
+/// starts with a tag byte: bits 0-1 are the kind (clear, point, line,
+/// present) and bits 2-3 the intensity. A zigzag LEB128 cycle delta from
+/// the previous record comes next, then the coordinates: none for clear and
+/// present, x/y for a point, and x0/y0/x1/y1 for a line. A typical line
+/// costs six bytes.
+namespace vgc_capture {
+constexpr std::array<char, 4> kMagic{{'I', 'V', 'G', 'C'}};
+constexpr uint16_t kVersion = 1;
+constexpr size_t kHeaderSize = 8;
+}  // namespace vgc_capture
+
+struct VgcCaptureRecord {
+  enum class Kind : uint8_t {
+    Command,
+    Present,
+  };
+  Kind kind = Kind::Command;
+  uint64_t cycle = 0;
+  VgcCommand command;  // Command records only
+};
+
+/// Streams VGC records to a binary capture.
+///
+/// Records are buffered and written out in large chunks. The destructor
+/// flushes, but it cannot report errors, so call Flush() when failure
+/// matters. Cycle stamps need not be monotonic: a snapshot restore can
+/// move the clock backwards.
+class VgcCaptureWriter {
+ public:
+  static constexpr size_t kFlushThreshold = 64 * 1024;
+
+  /// Writes the header immediately. @p out must outlive the writer.
+  explicit VgcCaptureWriter(std::ostream& out);
+  ~VgcCaptureWriter();
+
+  VgcCaptureWriter(const VgcCaptureWriter&) = delete;
+  VgcCaptureWriter& operator=(const VgcCaptureWriter&) = delete;
+
+  void WriteCommand(uint64_t cycle, const VgcCommand& command);
+  void WritePresent(uint64_t cycle);
+
+  /// Write buffered records to the stream. Throws SimError on I/O failure.
+  void Flush();
+
+  uint64_t commands_written() const { return commands_written_; }
+  uint64_t frames_written() const { return frames_written_; }
+
+ private:
+  std::ostream& out_;
+  std::vector<uint8_t> buffer_;
+  uint64_t last_cycle_ = 0;
+  uint64_t commands_written_ = 0;
+  uint64_t frames_written_ = 0;
+
+  void WriteTag(uint8_t kind, uint8_t intensity, uint64_t cycle);
+};
+
+/// Decodes a capture held in memory. Malformed input throws SimError.
+class VgcCaptureReader {
+ public:
+  /// Validates the header; records are decoded lazily by Next().
+  explicit VgcCaptureReader(std::vector<uint8_t> data);
+  static VgcCaptureReader FromFile(const std::string& path);
+
+  std::optional<VgcCaptureRecord> Next();
+  bool at_end() const { return offset_ == data_.size(); }
+
+ private:
+  std::vector<uint8_t> data_;
+  size_t offset_ = vgc_capture::kHeaderSize;
+  uint64_t cycle_ = 0;
+
+  uint8_t ReadByte();
+};
+
+struct VgcReplayResult {
+  uint64_t frames = 0;
+  uint64_t commands = 0;
+  uint64_t last_cycle = 0;
+};
+
+/// Replay a capture into @p backend without a CPU.
+///
+/// Each frame's commands are handed over in one submit() followed by
+/// present(), and @p on_present (if set) runs after every present with the
+/// frame index and its cycle stamp. Stops after @p max_frames presents, or
+/// at the end of the capture when it is zero. Commands after the last
+/// present are submitted but not presented.
+VgcReplayResult ReplayVgcCapture(
+    VgcCaptureReader& reader,
+    VgcBackend& backend,
+    uint64_t max_frames = 0,
+    const std::function<void(uint64_t frame, uint64_t cycle)>& on_present = {});
+
+}  // namespace irata2::sim::io
+
+#endif  // IRATA2_SIM_IO_VGC_CAPTURE_H
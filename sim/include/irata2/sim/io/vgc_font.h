@@ -0,0 +1,34 @@
+#ifndef IRATA2_SIM_IO_VGC_FONT_H
+#define IRATA2_SIM_IO_VGC_FONT_H
+
+#include <cstddef>
+#include <string_view>
+
+namespace irata2::sim::io {
+
+/// Built-in stroke font used by the VGC GLYPH and TEXT commands.
+///
+/// Glyphs live on a 5x7 grid of points (x 0-4, y 0-6, y down). Each glyph is
+/// a string of strokes separated by spaces; a stroke is a run of two-digit
+/// "xy" points joined by lines, and a single-point stroke is a dot. The font
+/// covers digits, upper-case letters (lower case maps onto them), and
+/// - . : ! ? / + = . Anything else draws nothing but still advances.
+namespace vgc_font {
+constexpr int kGlyphWidth = 4;
+constexpr int kGlyphHeight = 6;
+/// Horizontal distance between glyph origins, in grid units.
+constexpr int kAdvance = 5;
+/// Vertical distance between lines of text, in grid units.
+constexpr int kLineHeight = 8;
+/// Pixels per grid unit at SCALE $10, so a glyph cell is 8x12 pixels.
+constexpr int kUnitPixels = 2;
+/// TEXT stops at a NUL byte or after this many characters.
+constexpr size_t kMaxTextLength = 64;
+}  // namespace vgc_font
+
+/// Stroke description for `c`; empty for blanks and unsupported characters.
+std::string_view VgcGlyphStrokes(char c);
+
+}  // namespace irata2::sim::io
+
+#endif  // IRATA2_SIM_IO_VGC_FONT_H
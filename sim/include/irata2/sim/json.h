@@ -0,0 +1,16 @@
+#ifndef IRATA2_SIM_JSON_H
+#define IRATA2_SIM_JSON_H
+
+#include <string>
+#include <string_view>
+
+namespace irata2::sim {
+
+/// @p value escaped for use between the quotes of a JSON string: quote and
+/// backslash are backslash-escaped, and every other character below 0x20
+/// is written as \u00XX, so symbols and paths always produce valid JSON.
+std::string EscapeJson(std::string_view value);
+
+}  // namespace irata2::sim
+
+#endif  // IRATA2_SIM_JSON_H
@@ -39,6 +39,16 @@ class LatchedWordRegister final : public ComponentWithParent {
     }
   }
 
+  void SaveState(SnapshotWriter& out) const override {
+    Component::SaveState(out);
+    out.Write(value_);
+  }
+
+  void LoadState(SnapshotReader& in) override {
+    Component::LoadState(in);
+    in.Read(value_);
+  }
+
  private:
   ProcessControl<true> latch_control_;
   const ProgramCounter& source_;
@@ -0,0 +1,68 @@
+#ifndef IRATA2_SIM_LATENCY_STATS_H
+#define IRATA2_SIM_LATENCY_STATS_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <string_view>
+
+namespace irata2::sim {
+
+/// Histogram of latencies in cycles with power-of-two buckets.
+///
+/// Bucket 0 holds zero-cycle samples and bucket i holds [2^(i-1), 2^i), so
+/// recording is a bit scan and an increment. Exact count, minimum, maximum
+/// and mean are kept alongside; percentiles are resolved to a bucket and
+/// reported as its upper bound, clamped to the maximum.
+class LatencyHistogram {
+ public:
+  static constexpr size_t kBuckets = 65;
+
+  void Record(uint64_t cycles);
+  void Reset() { *this = LatencyHistogram{}; }
+
+  uint64_t count() const { return count_; }
+  uint64_t min() const { return count_ == 0 ? 0 : min_; }
+  uint64_t max() const { return max_; }
+  double mean() const {
+    return count_ == 0 ? 0.0 : static_cast<double>(sum_) / count_;
+  }
+  /// Upper bound of the bucket holding the @p fraction quantile (0..1).
+  uint64_t Percentile(double fraction) const;
+
+  const std::array<uint64_t, kBuckets>& buckets() const { return buckets_; }
+  /// Inclusive range of cycles counted in bucket @p index.
+  static uint64_t BucketLow(size_t index);
+  static uint64_t BucketHigh(size_t index);
+
+  /// Summary line followed by one line per non-empty bucket.
+  void WriteText(std::ostream& out, std::string_view name) const;
+
+ private:
+  std::array<uint64_t, kBuckets> buckets_{};
+  uint64_t count_ = 0;
+  uint64_t sum_ = 0;
+  uint64_t min_ = UINT64_MAX;
+  uint64_t max_ = 0;
+};
+
+/// Interrupt and input latencies measured by the CPU, in cycles.
+///
+/// Like the performance counters these are host-side statistics: not saved
+/// in snapshots and reset with Cpu::ResetLatencyStats(). Recording is off
+/// until enabled with Cpu::set_latency_tracking().
+struct LatencyStats {
+  /// IRQ line first asserted to the IR injecting the IRQ entry.
+  LatencyHistogram irq_entry;
+  /// IRQ entry injected to the handler's RTI retiring.
+  LatencyHistogram irq_handler;
+  /// Host input event applied by the InputDevice to the next VGC present.
+  LatencyHistogram input_to_present;
+
+  void WriteText(std::ostream& out) const;
+};
+
+}  // namespace irata2::sim
+
+#endif  // IRATA2_SIM_LATENCY_STATS_H
@@ -27,6 +27,16 @@ class LocalRegister : public ComponentWithParent {
     }
   }
 
+  void SaveState(SnapshotWriter& out) const override {
+    Component::SaveState(out);
+    out.Write(value_);
+  }
+
+  void LoadState(SnapshotReader& in) override {
+    Component::LoadState(in);
+    in.Read(value_);
+  }
+
  protected:
   ValueType& value_mutable() { return value_; }
 
@@ -2,6 +2,8 @@
 #define IRATA2_SIM_MEMORY_MEMORY_H
 
 #include <functional>
+#include <optional>
+#include <span>
 #include <utility>
 #include <vector>
 
@@ -13,6 +15,24 @@
 
 namespace irata2::sim::memory {
 
+/// Inclusive address range.
+struct AddressRange {
+  base::Word first;
+  base::Word last;
+
+  bool Contains(base::Word address) const {
+    return address >= first && address <= last;
+  }
+};
+
+/// One CPU bus access, as recorded by Memory::set_access_log().
+struct MemoryAccess {
+  uint64_t cycle = 0;
+  base::Word address;
+  base::Byte value;
+  bool write = false;
+};
+
 class Memory final : public ComponentWithBus<Memory, base::Byte> {
  public:
   using RegionFactory =
@@ -31,17 +51,62 @@ class Memory final : public ComponentWithBus<Memory, base::Byte> {
   base::Byte ReadAt(base::Word address) const;
   void WriteAt(base::Word address, base::Byte value);
 
+  /// Host-side bulk access for devices such as DMA.
+  ///
+  /// Returns the backing store for [address, address + length) when the
+  /// whole range lies inside one storage-backed region (RAM for writes,
+  /// RAM or ROM for reads). Returns an empty span otherwise; callers then
+  /// fall back to ReadAt()/WriteAt() so MMIO side effects are preserved.
+  std::span<const base::Byte> ContentsAt(base::Word address,
+                                         size_t length) const;
+  std::span<base::Byte> MutableContentsAt(base::Word address, size_t length);
+
+  /// Watch CPU bus accesses to an address range.
+  ///
+  /// Only reads and writes that go through the data bus count; host-side
+  /// ReadAt()/WriteAt() calls from devices and tooling do not. The hit flag
+  /// latches until ClearAccessWatchHit() or the watch is replaced.
+  void set_access_watch(std::optional<AddressRange> range) {
+    access_watch_ = range;
+    access_watch_hit_ = false;
+  }
+  bool access_watch_hit() const { return access_watch_hit_; }
+  void ClearAccessWatchHit() { access_watch_hit_ = false; }
+
+  /// Regions in map order. Each counts its own CPU bus reads and writes.
+  const std::vector<std::unique_ptr<Region>>& regions() const {
+    return regions_;
+  }
+  void ResetAccessCounts();
+
+  /// Append every CPU bus access to @p log (not owned); nullptr to stop.
+  /// Used by the streaming execution trace.
+  void set_access_log(std::vector<MemoryAccess>* log) { access_log_ = log; }
+  /// Like set_access_log(), but only for accesses to device regions. Used
+  /// by the guest timeline.
+  void set_mmio_log(std::vector<MemoryAccess>* log) { mmio_log_ = log; }
+
  protected:
   // Implement ComponentWithBus abstract interface
-  base::Byte read_value() const override { return ReadAt(mar_.value()); }
-  void write_value(base::Byte value) override { WriteAt(mar_.value(), value); }
+  base::Byte read_value() const override;
+  void write_value(base::Byte value) override;
 
  private:
   Region* FindRegion(base::Word address);
   const Region* FindRegion(base::Word address) const;
 
+  void CheckAccessWatch(base::Word address) const {
+    if (access_watch_ && access_watch_->Contains(address)) {
+      access_watch_hit_ = true;
+    }
+  }
+
   MemoryAddressRegister mar_;
   std::vector<std::unique_ptr<Region>> regions_;
+  std::optional<AddressRange> access_watch_;
+  mutable bool access_watch_hit_ = false;
+  std::vector<MemoryAccess>* access_log_ = nullptr;
+  std::vector<MemoryAccess>* mmio_log_ = nullptr;
 };
 
 }  // namespace irata2::sim::memory
@@ -4,6 +4,7 @@
 #include <cstddef>
 #include <cstdint>
 #include <memory>
+#include <span>
 #include <utility>
 #include <vector>
 
@@ -31,6 +32,13 @@ class Module : public ComponentWithParent {
   virtual size_t size() const = 0;
   virtual base::Byte Read(base::Word address) const = 0;
   virtual void Write(base::Word address, base::Byte value) = 0;
+
+  /// Direct view of the backing store for bulk host-side transfers.
+  ///
+  /// Modules without plain storage (MMIO devices) return an empty span, which
+  /// forces callers back onto Read()/Write() so register side effects happen.
+  virtual std::span<const base::Byte> contents() const { return {}; }
+  virtual std::span<base::Byte> mutable_contents() { return {}; }
 };
 
 /// RAM module that allows both read and write operations.
@@ -42,6 +50,12 @@ class Ram final : public Module {
   base::Byte Read(base::Word address) const override;
   void Write(base::Word address, base::Byte value) override;
 
+  std::span<const base::Byte> contents() const override { return data_; }
+  std::span<base::Byte> mutable_contents() override { return data_; }
+
+  void SaveState(SnapshotWriter& out) const override;
+  void LoadState(SnapshotReader& in) override;
+
  private:
   std::vector<base::Byte> data_;
 };
@@ -58,6 +72,10 @@ class Rom final : public Module {
 
   const MemoryRomStorage& storage() const { return storage_; }
 
+  std::span<const base::Byte> contents() const override {
+    return storage_.data();
+  }
+
  private:
   MemoryRomStorage storage_;
 };
@@ -5,6 +5,7 @@
 #include <cstdint>
 #include <functional>
 #include <memory>
+#include <span>
 #include <string>
 #include <utility>
 
@@ -37,11 +38,32 @@ class Region : public ComponentWithParent {
   base::Byte Read(base::Word address) const;
   void Write(base::Word address, base::Byte value);
 
+  /// Backing-store view of [address, address + length), or an empty span if
+  /// the range leaves the region or the module has no plain storage.
+  std::span<const base::Byte> ContentsAt(base::Word address,
+                                         size_t length) const;
+  std::span<base::Byte> MutableContentsAt(base::Word address, size_t length);
+
+  /// True if the module has no plain backing store, i.e. it is a device.
+  bool is_mmio() const;
+
+  /// CPU bus accesses counted by Memory. Not part of snapshots.
+  uint64_t reads() const { return reads_; }
+  uint64_t writes() const { return writes_; }
+  void CountRead() const { ++reads_; }
+  void CountWrite() { ++writes_; }
+  void ResetAccessCounts() {
+    reads_ = 0;
+    writes_ = 0;
+  }
+
  private:
   base::Word Translate(base::Word address) const;
 
   base::Word offset_;
   std::unique_ptr<Module> module_;
+  mutable uint64_t reads_ = 0;
+  uint64_t writes_ = 0;
 };
 
 }  // namespace irata2::sim::memory
@@ -0,0 +1,61 @@
+#ifndef IRATA2_SIM_PERF_COUNTERS_H
+#define IRATA2_SIM_PERF_COUNTERS_H
+
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "irata2/base/types.h"
+
+namespace irata2::sim {
+
+/// Architectural event counts since the last Cpu::ResetPerfCounters().
+///
+/// Counters are always on and only cost an increment per event, so they
+/// can be sampled at any point of a run to compare workloads. Memory
+/// accesses are counted on the CPU bus path only; host-side ReadAt() and
+/// WriteAt() calls from devices and tooling are not.
+struct PerfCounters {
+  struct RegionAccesses {
+    std::string name;
+    base::Word offset;
+    uint64_t reads = 0;
+    uint64_t writes = 0;
+    bool mmio = false;  ///< Region has no plain backing store
+  };
+
+  uint64_t cycles = 0;
+  uint64_t instructions = 0;         ///< instruction_start assertions
+  uint64_t data_bus_cycles = 0;      ///< Cycles with a value on the data bus
+  uint64_t address_bus_cycles = 0;   ///< Cycles with a value on the address bus
+  uint64_t irqs_taken = 0;           ///< IRQ entries injected by the IR
+  uint64_t irq_masked_cycles = 0;    ///< Cycles with interrupt_disable set
+  std::vector<RegionAccesses> regions;  ///< In memory map order
+
+  double cycles_per_instruction() const {
+    return instructions == 0 ? 0.0
+                             : static_cast<double>(cycles) / instructions;
+  }
+  double data_bus_utilization() const { return Ratio(data_bus_cycles); }
+  double address_bus_utilization() const { return Ratio(address_bus_cycles); }
+  double irq_masked_fraction() const { return Ratio(irq_masked_cycles); }
+
+  uint64_t memory_reads() const;
+  uint64_t memory_writes() const;
+  uint64_t mmio_accesses() const;
+
+  /// Human-readable multi-line summary.
+  void WriteText(std::ostream& out) const;
+  /// Single JSON object with the raw counts and derived ratios.
+  void WriteJson(std::ostream& out) const;
+
+ private:
+  double Ratio(uint64_t count) const {
+    return cycles == 0 ? 0.0 : static_cast<double>(count) / cycles;
+  }
+};
+
+}  // namespace irata2::sim
+
+#endif  // IRATA2_SIM_PERF_COUNTERS_H
@@ -43,6 +43,16 @@ class RegisterWithBus : public ComponentWithBus<Derived, ValueType> {
     }
   }
 
+  void SaveState(SnapshotWriter& out) const override {
+    Component::SaveState(out);
+    out.Write(value_);
+  }
+
+  void LoadState(SnapshotReader& in) override {
+    Component::LoadState(in);
+    in.Read(value_);
+  }
+
  protected:
   // Implement ComponentWithBus abstract interface
   ValueType read_value() const override { return value_; }
@@ -0,0 +1,57 @@
+#ifndef IRATA2_SIM_RETIRED_INSTRUCTION_H
+#define IRATA2_SIM_RETIRED_INSTRUCTION_H
+
+#include <cstdint>
+
+namespace irata2::sim {
+
+class InstructionRegister;
+
+/// The instruction that finished just before an instruction start.
+struct RetiredInstruction {
+  enum class Kind : uint8_t {
+    None,      // first instruction start seen; nothing has retired yet
+    Other,
+    Jsr,
+    Brk,
+    Rts,
+    Rti,
+    IrqEntry,  // injected IRQ entry sequence, which has no opcode
+  };
+
+  Kind kind = Kind::None;
+  uint8_t opcode = 0;  // fetched opcode; only meaningful for an instruction
+
+  bool is_instruction() const {
+    return kind != Kind::None && kind != Kind::IrqEntry;
+  }
+  /// JSR, BRK or IRQ entry: the starting instruction opens a call frame.
+  bool opens_frame() const {
+    return kind == Kind::Jsr || kind == Kind::Brk || kind == Kind::IrqEntry;
+  }
+  /// RTS or RTI: the starting instruction closes a call frame.
+  bool closes_frame() const { return kind == Kind::Rts || kind == Kind::Rti; }
+};
+
+/// Works out which instruction retired at each instruction start.
+///
+/// At an instruction start the IR's fetched value is still the opcode of
+/// the instruction that just finished, unless that was an injected IRQ
+/// entry, which runs without a fetch. Call OnInstructionStart() once per
+/// instruction start, in order, so the tracker can tell the two apart.
+class RetiredInstructionTracker {
+ public:
+  RetiredInstruction OnInstructionStart(const InstructionRegister& ir);
+
+  /// True from an instruction start that took an interrupt until the next
+  /// instruction start.
+  bool in_irq_entry() const { return in_irq_entry_; }
+
+ private:
+  bool seen_start_ = false;
+  bool in_irq_entry_ = false;
+};
+
+}  // namespace irata2::sim
+
+#endif  // IRATA2_SIM_RETIRED_INSTRUCTION_H
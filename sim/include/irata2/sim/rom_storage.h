@@ -38,6 +38,9 @@ class RomStorage final : public ComponentWithParent {
   /// Get the size of the ROM in data elements.
   size_t size() const { return data_.size(); }
 
+  /// Read-only view of the full ROM image.
+  const std::vector<DataType>& data() const { return data_; }
+
   /// Read a value from the ROM.
   ///
   /// \param address The address to read from
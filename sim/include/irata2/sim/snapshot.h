@@ -0,0 +1,99 @@
+#ifndef IRATA2_SIM_SNAPSHOT_H
+#define IRATA2_SIM_SNAPSHOT_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <span>
+#include <type_traits>
+#include <vector>
+
+#include "irata2/sim/error.h"
+
+namespace irata2::sim {
+
+/**
+ * @brief Appends raw component state to a snapshot buffer.
+ *
+ * Snapshots are in-memory and tied to one machine configuration: they are
+ * a flat byte stream in component-tree order with no field names or
+ * versioning. Restoring into a CPU with a different component tree fails.
+ */
+class SnapshotWriter {
+ public:
+  /// Clears @p buffer but keeps its capacity, so repeated saves into the
+  /// same buffer do not allocate.
+  explicit SnapshotWriter(std::vector<uint8_t>& buffer) : buffer_(buffer) {
+    buffer_.clear();
+  }
+
+  template <typename T>
+  void Write(const T& value) {
+    static_assert(std::is_trivially_copyable_v<T>,
+                  "snapshot values must be trivially copyable");
+    WriteBytes(&value, sizeof(T));
+  }
+
+  template <typename T>
+  void WriteSpan(std::span<const T> values) {
+    static_assert(std::is_trivially_copyable_v<T>,
+                  "snapshot values must be trivially copyable");
+    WriteBytes(values.data(), values.size_bytes());
+  }
+
+  void WriteBytes(const void* data, size_t size) {
+    const size_t offset = buffer_.size();
+    buffer_.resize(offset + size);
+    if (size != 0) {
+      std::memcpy(buffer_.data() + offset, data, size);
+    }
+  }
+
+ private:
+  std::vector<uint8_t>& buffer_;
+};
+
+/**
+ * @brief Consumes component state written by SnapshotWriter.
+ *
+ * Every read is bounds-checked; a truncated or mismatched snapshot throws
+ * SimError rather than reading past the buffer.
+ */
+class SnapshotReader {
+ public:
+  explicit SnapshotReader(std::span<const uint8_t> bytes) : bytes_(bytes) {}
+
+  template <typename T>
+  void Read(T& value) {
+    static_assert(std::is_trivially_copyable_v<T>,
+                  "snapshot values must be trivially copyable");
+    ReadBytes(&value, sizeof(T));
+  }
+
+  template <typename T>
+  void ReadSpan(std::span<T> values) {
+    static_assert(std::is_trivially_copyable_v<T>,
+                  "snapshot values must be trivially copyable");
+    ReadBytes(values.data(), values.size_bytes());
+  }
+
+  void ReadBytes(void* data, size_t size) {
+    if (size > bytes_.size() - offset_) {
+      throw SimError("snapshot truncated or from a different machine");
+    }
+    if (size != 0) {
+      std::memcpy(data, bytes_.data() + offset_, size);
+    }
+    offset_ += size;
+  }
+
+  bool at_end() const { return offset_ == bytes_.size(); }
+
+ private:
+  std::span<const uint8_t> bytes_;
+  size_t offset_ = 0;
+};
+
+}  // namespace irata2::sim
+
+#endif  // IRATA2_SIM_SNAPSHOT_H
@@ -0,0 +1,133 @@
+#ifndef IRATA2_SIM_TRACE_STREAM_H
+#define IRATA2_SIM_TRACE_STREAM_H
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <istream>
+#include <optional>
+#include <ostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "irata2/base/spsc_queue.h"
+#include "irata2/base/types.h"
+
+namespace irata2::sim {
+
+/// Binary execution trace format.
+///
+/// A trace is an 8-byte header ("I2TR", u16 version, u16 reserved, little
+/// endian) followed by one record per retired instruction or CPU bus
+/// access. Each record starts with a tag byte: bits 0-1 are the kind and,
+/// for instructions, bits 2-6 flag which of A, X, Y, SP and status changed
+/// since the previous instruction. A zigzag LEB128 cycle delta from the
+/// previous record follows, then a zigzag LEB128 address delta from the
+/// previous record of the same family (instruction or access), the opcode
+/// or data byte, and the changed registers. A straight-line instruction
+/// that changes one register costs five bytes.
+namespace trace_stream {
+constexpr std::array<char, 4> kMagic{{'I', '2', 'T', 'R'}};
+constexpr uint16_t kVersion = 1;
+constexpr size_t kHeaderSize = 8;
+}  // namespace trace_stream
+
+struct TraceRecord {
+  enum class Kind : uint8_t {
+    Instruction,
+    Read,
+    Write,
+  };
+  Kind kind = Kind::Instruction;
+  /// Instruction start cycle, or the cycle of the access.
+  uint64_t cycle = 0;
+  /// Instruction address, or the address accessed.
+  base::Word address;
+  /// Opcode (0x00 for an IRQ entry), or the byte transferred.
+  base::Byte value;
+  // Register state after the instruction retired. Instructions only.
+  base::Byte a;
+  base::Byte x;
+  base::Byte y;
+  base::Byte sp;
+  base::Byte status;
+};
+
+/// Encodes trace records to a stream on a background thread.
+///
+/// Append() only copies the fixed-size record into a lock-free queue, so
+/// the simulator thread never waits on compression or I/O unless the
+/// writer falls a whole queue behind, in which case Append() blocks
+/// rather than dropping records. Close() drains the queue and joins the
+/// thread; the destructor closes too but cannot report errors.
+class TraceStreamWriter {
+ public:
+  static constexpr size_t kQueueCapacity = 1 << 14;
+  static constexpr size_t kFlushThreshold = 256 * 1024;
+
+  /// Writes the header and starts the writer thread. @p out must outlive
+  /// the writer and must not be touched until Close() returns.
+  explicit TraceStreamWriter(std::ostream& out);
+  ~TraceStreamWriter();
+
+  TraceStreamWriter(const TraceStreamWriter&) = delete;
+  TraceStreamWriter& operator=(const TraceStreamWriter&) = delete;
+
+  /// Producer side; call from one thread only.
+  void Append(const TraceRecord& record);
+
+  /// Write everything appended so far and stop the thread. Throws SimError
+  /// on I/O failure. Further Append() calls are ignored.
+  void Close();
+
+  uint64_t records_appended() const { return records_appended_; }
+  /// Bytes written so far, header included. Exact after Close().
+  uint64_t bytes_written() const {
+    return bytes_written_.load(std::memory_order_relaxed);
+  }
+
+ private:
+  void Run();
+  void Encode(const TraceRecord& record);
+  void WriteBuffer();
+
+  std::ostream& out_;
+  base::SpscQueue<TraceRecord, kQueueCapacity> queue_;
+  std::thread thread_;
+  std::atomic<bool> closing_{false};
+  std::atomic<bool> failed_{false};
+  std::atomic<uint64_t> bytes_written_{0};
+  bool closed_ = false;
+  uint64_t records_appended_ = 0;
+
+  // Writer thread state.
+  std::vector<uint8_t> buffer_;
+  TraceRecord last_instruction_;
+  uint64_t last_cycle_ = 0;
+  uint16_t last_access_address_ = 0;
+};
+
+/// Decodes a trace from a stream, one record at a time, so traces larger
+/// than memory can be filtered. Malformed input throws SimError.
+class TraceStreamReader {
+ public:
+  /// Validates the header. @p in must outlive the reader.
+  explicit TraceStreamReader(std::istream& in);
+
+  std::optional<TraceRecord> Next();
+
+ private:
+  std::istream& in_;
+  TraceRecord last_instruction_;
+  uint64_t cycle_ = 0;
+  uint16_t last_access_address_ = 0;
+
+  uint8_t ReadByte();
+  uint64_t ReadVarint();
+};
+
+}  // namespace irata2::sim
+
+#endif  // IRATA2_SIM_TRACE_STREAM_H
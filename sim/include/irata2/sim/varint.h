@@ -0,0 +1,57 @@
+#ifndef IRATA2_SIM_VARINT_H
+#define IRATA2_SIM_VARINT_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "irata2/sim/error.h"
+
+/// Zigzag and LEB128 integer coding shared by the binary VGC capture and
+/// execution trace formats.
+///
+/// Signed deltas are zigzag mapped so small magnitudes of either sign stay
+/// small, then written seven bits per byte, low bits first, with the high
+/// bit set on every byte but the last.
+namespace irata2::sim::varint {
+
+/// Longest encoding of a 64-bit value.
+constexpr size_t kMaxBytes = 10;
+
+inline uint64_t ZigZag(int64_t value) {
+  return (static_cast<uint64_t>(value) << 1) ^
+         static_cast<uint64_t>(value >> 63);
+}
+
+inline int64_t UnZigZag(uint64_t value) {
+  return static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1);
+}
+
+inline void Put(std::vector<uint8_t>& out, uint64_t value) {
+  while (value >= 0x80) {
+    out.push_back(static_cast<uint8_t>(value | 0x80));
+    value >>= 7;
+  }
+  out.push_back(static_cast<uint8_t>(value));
+}
+
+/// Decode one value, pulling bytes from @p next_byte. Throws SimError with
+/// @p too_long when the encoding runs past kMaxBytes.
+template <typename NextByte>
+uint64_t Read(NextByte&& next_byte, const char* too_long) {
+  uint64_t value = 0;
+  for (size_t i = 0;; ++i) {
+    if (i == kMaxBytes) {
+      throw SimError(too_long);
+    }
+    const uint8_t byte = next_byte();
+    value |= static_cast<uint64_t>(byte & 0x7F) << (7 * i);
+    if ((byte & 0x80) == 0) {
+      return value;
+    }
+  }
+}
+
+}  // namespace irata2::sim::varint
+
+#endif  // IRATA2_SIM_VARINT_H
@@ -43,6 +43,9 @@ void Controller::TickControl() {
   const uint8_t opcode = ir_.value().value();
   const uint8_t step = sc_.value().value();
   const uint8_t status = instruction_memory_->status_encoder().Encode();
+  if (profile_) {
+    profile_->Record(opcode, step, status);
+  }
 
   const auto controls = instruction_memory_->Lookup(opcode, step, status);
   for (auto* control : controls) {
@@ -1,7 +1,12 @@
 #include "irata2/sim/cpu.h"
 
 #include "irata2/sim/error.h"
+#include "irata2/sim/frame_budget.h"
+#include "irata2/sim/guest_coverage.h"
+#include "irata2/sim/guest_profiler.h"
+#include "irata2/sim/guest_timeline.h"
 #include "irata2/sim/initialization.h"
+#include "irata2/sim/trace_stream.h"
 #include "irata2/microcode/compiler/compiler.h"
 #include "irata2/microcode/ir/irata_instruction_set.h"
 #include "irata2/hdl/traits.h"
@@ -380,23 +385,66 @@ void Cpu::Tick() {
 
   // Execute five-phase tick model
   // Each phase automatically propagates to all children via Component base class
+  instruction_started_ = false;
   current_phase_ = base::TickPhase::Control;
-  Component::TickControl();
+  // The IRQ line is wired-OR: it drops each cycle and every device with a
+  // pending interrupt re-asserts it during its own TickControl.
+  irq_line_.Clear();
+  {
+    HostPhaseTimer timer(host_profile_, current_phase_);
+    TickChildren(current_phase_);
+  }
 
   current_phase_ = base::TickPhase::Write;
-  Component::TickWrite();
+  {
+    HostPhaseTimer timer(host_profile_, current_phase_);
+    TickChildren(current_phase_);
+  }
 
   current_phase_ = base::TickPhase::Read;
-  Component::TickRead();
+  {
+    HostPhaseTimer timer(host_profile_, current_phase_);
+    TickChildren(current_phase_);
+  }
 
   current_phase_ = base::TickPhase::Process;
-  TickProcess();  // Call our override which checks halt/crash controls
+  {
+    HostPhaseTimer timer(host_profile_, current_phase_);
+    TickProcess();  // Call our override which checks halt/crash controls
+  }
+
+  // Bus occupancy has to be sampled before the clear phase drops it.
+  ++perf_.cycles;
+  perf_.data_bus_cycles += data_bus_.has_value() ? 1 : 0;
+  perf_.address_bus_cycles += address_bus_.has_value() ? 1 : 0;
+  perf_.irq_masked_cycles += status_.interrupt_disable().value() ? 1 : 0;
+  irq_requested_ = irq_line_.asserted();
 
   current_phase_ = base::TickPhase::Clear;
-  Component::TickClear();
+  {
+    HostPhaseTimer timer(host_profile_, current_phase_);
+    TickChildren(current_phase_);
+  }
 
   current_phase_ = base::TickPhase::None;
   cycle_count_++;
+  if constexpr (HostProfile::kEnabled) {
+    host_profile_.AddTick();
+  }
+
+  if (profiler_) {
+    profiler_->OnCycle(*this);
+  }
+  if (timeline_) {
+    timeline_->OnCycle(*this, timeline_mmio_);
+    timeline_mmio_.clear();
+  }
+  if (frame_budget_) {
+    frame_budget_->OnCycle(*this);
+  }
+  if (coverage_) {
+    coverage_->OnCycle(*this);
+  }
 }
 
 Cpu::CpuState Cpu::CaptureState() const {
@@ -448,6 +496,83 @@ Cpu::RunResult Cpu::RunUntilHalt(uint64_t max_cycles, bool capture_state) {
   return result;
 }
 
+Cpu::RunResult Cpu::RunUntil(const StopConditions& conditions) {
+  const uint64_t start_cycles = cycle_count_;
+  const uint64_t start_frames = frames_presented_;
+  memory_.set_access_watch(conditions.memory_access);
+
+  RunResult result;
+  while (true) {
+    if (halted_) {
+      result.reason = crashed_ ? HaltReason::Crash : HaltReason::Halt;
+      break;
+    }
+    if (conditions.max_cycles &&
+        cycle_count_ - start_cycles >= *conditions.max_cycles) {
+      result.reason = HaltReason::Timeout;
+      break;
+    }
+
+    Tick();
+
+    if (halted_) {
+      continue;
+    }
+    if (conditions.frame_presented && frames_presented_ != start_frames) {
+      result.reason = HaltReason::FramePresented;
+      break;
+    }
+    if (conditions.target_pc && instruction_started_ &&
+        controller_.ipc().value() == *conditions.target_pc) {
+      result.reason = HaltReason::TargetPc;
+      break;
+    }
+    if (conditions.memory_access && memory_.access_watch_hit()) {
+      result.reason = HaltReason::MemoryAccess;
+      break;
+    }
+  }
+
+  memory_.set_access_watch(std::nullopt);
+  result.cycles = cycle_count_ - start_cycles;
+  if (conditions.capture_state) {
+    result.state = CaptureState();
+  }
+  return result;
+}
+
+void Cpu::SaveSnapshot(Snapshot& snapshot) const {
+  SnapshotWriter out(snapshot.bytes);
+  out.Write(kSnapshotMagic);
+  out.Write(static_cast<uint64_t>(components_.size()));
+  out.Write(halted_);
+  out.Write(crashed_);
+  out.Write(cycle_count_);
+  out.Write(frames_presented_);
+  out.Write(ipc_valid_);
+  Component::SaveState(out);
+}
+
+void Cpu::RestoreSnapshot(const Snapshot& snapshot) {
+  SnapshotReader in(snapshot.bytes);
+  uint32_t magic = 0;
+  uint64_t component_count = 0;
+  in.Read(magic);
+  in.Read(component_count);
+  if (magic != kSnapshotMagic || component_count != components_.size()) {
+    throw SimError("snapshot does not match this machine");
+  }
+  in.Read(halted_);
+  in.Read(crashed_);
+  in.Read(cycle_count_);
+  in.Read(frames_presented_);
+  in.Read(ipc_valid_);
+  Component::LoadState(in);
+  if (!in.at_end()) {
+    throw SimError("snapshot has trailing data; machine layout differs");
+  }
+}
+
 void Cpu::EnableTrace(size_t depth) {
   trace_.Configure(depth);
 }
@@ -479,11 +604,202 @@ void Cpu::SetCurrentPhaseForTest(base::TickPhase phase) {
   current_phase_ = phase;
 }
 
+PerfCounters Cpu::perf_counters() const {
+  PerfCounters counters = perf_;
+  for (const auto& region : memory_.regions()) {
+    PerfCounters::RegionAccesses accesses;
+    accesses.name = region->name();
+    accesses.offset = region->offset();
+    accesses.reads = region->reads();
+    accesses.writes = region->writes();
+    accesses.mmio = region->is_mmio();
+    counters.regions.push_back(std::move(accesses));
+  }
+  return counters;
+}
+
+void Cpu::ResetPerfCounters() {
+  perf_ = PerfCounters{};
+  memory_.ResetAccessCounts();
+}
+
+void Cpu::ResetLatencyStats() {
+  latency_ = LatencyStats{};
+  irq_raised_at_.reset();
+  irq_armed_ = true;
+  irq_entries_.clear();
+  pending_inputs_.clear();
+}
+
+void Cpu::NotifyFramePresented() {
+  ++frames_presented_;
+  if (!latency_tracking_) {
+    return;
+  }
+  for (uint64_t applied : pending_inputs_) {
+    latency_.input_to_present.Record(cycle_count_ - applied);
+  }
+  pending_inputs_.clear();
+}
+
+void Cpu::NotifyHostInput() {
+  // A guest that never presents would otherwise grow the list forever.
+  if (latency_tracking_ && pending_inputs_.size() < kMaxPendingInputs) {
+    pending_inputs_.push_back(cycle_count_);
+  }
+}
+
+void Cpu::TrackIrqLatency() {
+  // An assertion starts an irq_entry sample once the line was low or the
+  // last handler returned, so a device still asserting while its handler
+  // runs is not counted as a new request.
+  if (!irq_line_.asserted()) {
+    irq_raised_at_.reset();
+    irq_armed_ = true;
+  } else if (irq_armed_ && !irq_raised_at_) {
+    irq_raised_at_ = cycle_count_;
+  }
+
+  if (!controller_.instruction_start().asserted()) {
+    return;
+  }
+  const RetiredInstruction retired =
+      retired_.OnInstructionStart(controller_.ir());
+  if (retired.kind == RetiredInstruction::Kind::Brk) {
+    if (irq_entries_.size() < kMaxIrqNesting) {
+      irq_entries_.push_back(std::nullopt);
+    }
+  } else if (retired.kind == RetiredInstruction::Kind::Rti &&
+             !irq_entries_.empty()) {
+    if (irq_entries_.back()) {
+      latency_.irq_handler.Record(cycle_count_ - *irq_entries_.back());
+    }
+    irq_entries_.pop_back();
+    irq_armed_ = true;
+  }
+
+  if (retired_.in_irq_entry()) {
+    latency_.irq_entry.Record(cycle_count_ -
+                              irq_raised_at_.value_or(cycle_count_));
+    irq_raised_at_.reset();
+    irq_armed_ = false;
+    if (irq_entries_.size() < kMaxIrqNesting) {
+      irq_entries_.push_back(cycle_count_);
+    }
+  }
+}
+
+void Cpu::TickChildren(base::TickPhase phase) {
+#if IRATA2_HOST_PROFILE
+  if (host_profile_.component_breakdown()) {
+    if (host_profile_slots_.size() != children_.size()) {
+      host_profile_slots_.clear();
+      for (auto* child : children_) {
+        host_profile_slots_.push_back(host_profile_.ComponentSlot(*child));
+      }
+    }
+    for (size_t i = 0; i < children_.size(); ++i) {
+      const auto start = HostProfile::Clock::now();
+      RunPhase(*children_[i], phase);
+      host_profile_.AddComponent(host_profile_slots_[i], phase,
+                                 HostProfile::ElapsedNs(start));
+    }
+    return;
+  }
+#endif
+  switch (phase) {
+    case base::TickPhase::Control:
+      Component::TickControl();
+      break;
+    case base::TickPhase::Write:
+      Component::TickWrite();
+      break;
+    case base::TickPhase::Read:
+      Component::TickRead();
+      break;
+    case base::TickPhase::Process:
+      Component::TickProcess();
+      break;
+    case base::TickPhase::Clear:
+      Component::TickClear();
+      break;
+    case base::TickPhase::None:
+      break;
+  }
+}
+
+void Cpu::AttachTimeline(GuestTimeline* timeline) {
+  timeline_ = timeline;
+  timeline_mmio_.clear();
+  memory_.set_mmio_log(timeline ? &timeline_mmio_ : nullptr);
+}
+
+void Cpu::AttachTraceWriter(TraceStreamWriter* writer) {
+  if (trace_writer_) {
+    EmitTraceRecords();
+  }
+  trace_writer_ = writer;
+  traced_instruction_.reset();
+  traced_accesses_.clear();
+  memory_.set_access_log(writer ? &traced_accesses_ : nullptr);
+}
+
+void Cpu::EmitTraceRecords() {
+  if (traced_instruction_) {
+    TraceRecord record;
+    record.kind = TraceRecord::Kind::Instruction;
+    record.cycle = traced_instruction_->cycle;
+    record.address = traced_instruction_->address;
+    record.value = traced_instruction_->irq
+                       ? base::Byte{InstructionRegister::kIrqOpcode}
+                       : controller_.ir().fetched_value();
+    record.a = a_.value();
+    record.x = x_.value();
+    record.y = y_.value();
+    record.sp = sp_.value();
+    record.status = status_.value();
+    trace_writer_->Append(record);
+    traced_instruction_.reset();
+  }
+  for (const auto& access : traced_accesses_) {
+    TraceRecord record;
+    record.kind = access.write ? TraceRecord::Kind::Write
+                               : TraceRecord::Kind::Read;
+    record.cycle = access.cycle;
+    record.address = access.address;
+    record.value = access.value;
+    trace_writer_->Append(record);
+  }
+  traced_accesses_.clear();
+}
+
+bool Cpu::CaptureTrace() {
+  const bool irq = controller_.ir().injecting_interrupt();
+  uint8_t opcode = 0;
+  if (trace_.filter().filters_opcode()) {
+    // The opcode is fetched after the instruction starts, so peek at it
+    // without bus side effects. Code in MMIO never matches.
+    if (irq) {
+      opcode = InstructionRegister::kIrqOpcode;
+    } else {
+      const auto bytes = memory_.ContentsAt(controller_.ipc().value(), 1);
+      if (bytes.empty()) {
+        return false;
+      }
+      opcode = bytes[0].value();
+    }
+  }
+  return trace_.ShouldCapture(controller_.ipc().value(), opcode, irq);
+}
+
 void Cpu::TickProcess() {
   // First propagate to all children
-  Component::TickProcess();
+  TickChildren(base::TickPhase::Process);
 
   // Then do CPU-specific processing
+  if (latency_tracking_) {
+    TrackIrqLatency();
+  }
   if (halt_control_.asserted()) {
     halted_ = true;
   }
@@ -493,7 +809,18 @@ void Cpu::TickProcess() {
   }
   if (controller_.instruction_start().asserted()) {
     ipc_valid_ = true;
-    if (trace_.enabled()) {
+    instruction_started_ = true;
+    ++perf_.instructions;
+    if (controller_.ir().injecting_interrupt()) {
+      ++perf_.irqs_taken;
+    }
+    if (trace_writer_) {
+      EmitTraceRecords();
+      traced_instruction_ = TracedInstruction{
+          cycle_count_, controller_.ipc().value(),
+          controller_.ir().injecting_interrupt()};
+    }
+    if (trace_.enabled() && CaptureTrace()) {
       DebugTraceEntry entry;
       entry.cycle = cycle_count_;
       entry.instruction_address = controller_.ipc().value();
@@ -503,9 +830,12 @@ void Cpu::TickProcess() {
       entry.a = a_.value();
       entry.x = x_.value();
       entry.status = status_.value();
-      trace_.Record(std::move(entry));
+      trace_.Record(entry);
     }
   }
+  if (halted_ && trace_writer_) {
+    EmitTraceRecords();  // the halting instruction never retires otherwise
+  }
 }
 
 }  // namespace irata2::sim
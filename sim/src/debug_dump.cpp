@@ -3,26 +3,11 @@
 #include "irata2/base/types.h"
 #include "irata2/sim/cpu.h"
 
-#include <iomanip>
 #include <sstream>
 
 namespace irata2::sim {
 
 namespace {
-std::string HexByte(base::Byte value) {
-  std::ostringstream out;
-  out << "0x" << std::hex << std::setw(2) << std::setfill('0')
-      << static_cast<int>(value.value()) << std::dec;
-  return out.str();
-}
-
-std::string HexWord(base::Word value) {
-  std::ostringstream out;
-  out << "0x" << std::hex << std::setw(4) << std::setfill('0')
-      << value.value() << std::dec;
-  return out.str();
-}
-
 std::string FormatLocation(const std::optional<SourceLocation>& location) {
   if (!location) {
     return "unknown";
@@ -52,14 +37,14 @@ std::string FormatBusValue(const ByteBus& bus) {
   if (!bus.has_value()) {
     return "--";
   }
-  return HexByte(bus.value());
+  return bus.value().to_string();
 }
 
 std::string FormatBusValue(const WordBus& bus) {
   if (!bus.has_value()) {
     return "--";
   }
-  return HexWord(bus.value());
+  return bus.value().to_string();
 }
 
 std::string FormatTraceLocation(const DebugSymbols* symbols,
@@ -78,31 +63,31 @@ std::string FormatDebugDump(const Cpu& cpu, std::string_view reason) {
 
   out << "Debug dump (" << reason << ")\n";
   out << "cycle: " << cpu.cycle_count() << "\n";
-  out << "instruction: " << HexWord(instruction_address) << " "
+  out << "instruction: " << instruction_address.to_string() << " "
       << FormatLocation(cpu.instruction_source_location()) << "\n";
-  out << "pc: " << HexWord(cpu.pc().value())
-      << " ipc: " << HexWord(cpu.controller().ipc().value())
-      << " ir: " << HexByte(cpu.controller().ir().value())
-      << " sc: " << HexByte(cpu.controller().sc().value()) << "\n";
-  out << "a: " << HexByte(cpu.a().value())
-      << " x: " << HexByte(cpu.x().value())
-      << " sr: " << HexByte(cpu.status().value())
+  out << "pc: " << cpu.pc().value().to_string()
+      << " ipc: " << cpu.controller().ipc().value().to_string()
+      << " ir: " << cpu.controller().ir().value().to_string()
+      << " sc: " << cpu.controller().sc().value().to_string() << "\n";
+  out << "a: " << cpu.a().value().to_string()
+      << " x: " << cpu.x().value().to_string()
+      << " sr: " << cpu.status().value().to_string()
       << " flags: " << FormatFlags(cpu.status()) << "\n";
   out << "buses: data=" << FormatBusValue(cpu.data_bus())
       << " address=" << FormatBusValue(cpu.address_bus()) << "\n";
 
-  const auto trace_entries = cpu.trace_entries();
-  out << "trace (" << trace_entries.size() << " entries):\n";
-  for (size_t i = 0; i < trace_entries.size(); ++i) {
-    const auto& entry = trace_entries[i];
+  const auto& trace = cpu.trace();
+  out << "trace (" << trace.size() << " entries):\n";
+  for (size_t i = 0; i < trace.size(); ++i) {
+    const auto& entry = trace.at(i);
     out << "  [" << i << "] cycle=" << entry.cycle
-        << " addr=" << HexWord(entry.instruction_address)
-        << " ir=" << HexByte(entry.ir)
-        << " pc=" << HexWord(entry.pc)
-        << " sc=" << HexByte(entry.sc)
-        << " a=" << HexByte(entry.a)
-        << " x=" << HexByte(entry.x)
-        << " sr=" << HexByte(entry.status)
+        << " addr=" << entry.instruction_address.to_string()
+        << " ir=" << entry.ir.to_string()
+        << " pc=" << entry.pc.to_string()
+        << " sc=" << entry.sc.to_string()
+        << " a=" << entry.a.to_string()
+        << " x=" << entry.x.to_string()
+        << " sr=" << entry.status.to_string()
         << " " << FormatTraceLocation(symbols, entry.instruction_address)
         << "\n";
   }
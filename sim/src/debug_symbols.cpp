@@ -2,8 +2,10 @@
 
 #include "irata2/sim/error.h"
 
+#include <algorithm>
 #include <cctype>
 #include <fstream>
+#include <iomanip>
 #include <map>
 #include <sstream>
 
@@ -318,8 +320,11 @@ std::optional<SourceLocation> DebugSymbols::Lookup(base::Word address) const {
 }
 
 DebugSymbols LoadDebugSymbols(const std::string& path) {
-  const std::string content = ReadFile(path);
-  JsonParser parser(content);
+  return ParseDebugSymbols(ReadFile(path));
+}
+
+DebugSymbols ParseDebugSymbols(std::string_view json) {
+  JsonParser parser(json);
   JsonValue root = parser.Parse();
   const auto& obj = RequireObject(root).object;
 
@@ -400,4 +405,51 @@ DebugSymbols LoadDebugSymbols(const std::string& path) {
   return symbols;
 }
 
+void SymbolResolver::Reset(const DebugSymbols* symbols) {
+  sorted_.clear();
+  if (!symbols) {
+    return;
+  }
+  sorted_.reserve(symbols->symbols.size());
+  for (const auto& [name, address] : symbols->symbols) {
+    sorted_.emplace_back(address.value(), name);
+  }
+  std::sort(sorted_.begin(), sorted_.end());
+}
+
+const SymbolResolver::Entry* SymbolResolver::Find(uint16_t address) const {
+  auto it = std::upper_bound(
+      sorted_.begin(), sorted_.end(), address,
+      [](uint16_t value, const Entry& entry) { return value < entry.first; });
+  if (it == sorted_.begin()) {
+    return nullptr;
+  }
+  --it;
+  while (it != sorted_.begin() && (it - 1)->first == it->first) {
+    --it;
+  }
+  return &*it;
+}
+
+std::string SymbolResolver::SymbolFor(base::Word address) const {
+  if (const Entry* entry = Find(address.value())) {
+    return entry->second;
+  }
+  std::ostringstream out;
+  out << '$' << std::uppercase << std::hex << std::setw(4)
+      << std::setfill('0') << address.value();
+  return out.str();
+}
+
+std::string SymbolResolver::NameFor(base::Word address) const {
+  const Entry* entry = Find(address.value());
+  if (!entry) {
+    return SymbolFor(address);
+  }
+  if (entry->first == address.value()) {
+    return entry->second;
+  }
+  return entry->second + "+" + std::to_string(address.value() - entry->first);
+}
+
 }  // namespace irata2::sim
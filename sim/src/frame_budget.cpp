@@ -0,0 +1,181 @@
+#include "irata2/sim/frame_budget.h"
+
+#include "irata2/sim/cpu.h"
+#include "irata2/sim/error.h"
+#include "irata2/sim/io/vector_graphics_coprocessor.h"
+
+#include <algorithm>
+#include <iomanip>
+#include <unordered_map>
+
+namespace irata2::sim {
+
+namespace {
+constexpr size_t kAddressSpace = 0x10000;
+
+// Region access counts restart on ResetPerfCounters(); count from zero
+// rather than wrapping when that happens mid-frame.
+uint64_t Delta(uint64_t now, uint64_t then) {
+  return now >= then ? now - then : now;
+}
+}  // namespace
+
+FrameBudget::FrameBudget(uint64_t cycles_per_frame)
+    : cycles_per_frame_(cycles_per_frame), address_cycles_(kAddressSpace, 0) {
+  if (cycles_per_frame_ == 0) {
+    throw SimError("frame budget must be at least one cycle");
+  }
+}
+
+FrameBudget::Counters FrameBudget::ReadCounters(const Cpu& cpu) const {
+  Counters counters;
+  if (vgc_) {
+    counters.commands = vgc_->commands_issued();
+    counters.lines = vgc_->lines_drawn();
+    counters.clears = vgc_->clears();
+  }
+  for (const auto& region : cpu.memory().regions()) {
+    if (region->is_mmio()) {
+      counters.mmio_writes += region->writes();
+    }
+  }
+  return counters;
+}
+
+void FrameBudget::ClearAddressCycles() {
+  for (uint16_t address : touched_) {
+    address_cycles_[address] = 0;
+  }
+  touched_.clear();
+}
+
+void FrameBudget::Resync(const Cpu& cpu) {
+  started_ = true;
+  presented_ = cpu.frames_presented();
+  frame_start_ = cpu.cycle_count();
+  draw_start_.reset();
+  baseline_ = ReadCounters(cpu);
+  ClearAddressCycles();
+}
+
+void FrameBudget::OnCycle(const Cpu& cpu) {
+  // The cycle that just ran; cycle_count() has already moved past it.
+  const uint64_t cycle = cpu.cycle_count() - 1;
+  if (!started_) {
+    Resync(cpu);
+    frame_start_ = cycle;
+  }
+
+  const uint16_t address = cpu.instruction_address().value();
+  if (address_cycles_[address]++ == 0) {
+    touched_.push_back(address);
+  }
+  if (vgc_ && !draw_start_ && vgc_->clears() != baseline_.clears) {
+    draw_start_ = cycle;
+  }
+  if (cpu.frames_presented() != presented_) {
+    presented_ = cpu.frames_presented();
+    EndFrame(cpu, cycle);
+  }
+}
+
+std::vector<FrameBudget::SymbolCycles> FrameBudget::TopSymbols() const {
+  std::unordered_map<std::string, uint64_t> by_symbol;
+  for (uint16_t address : touched_) {
+    by_symbol[resolver_.SymbolFor(base::Word{address})] +=
+        address_cycles_[address];
+  }
+  std::vector<SymbolCycles> symbols;
+  symbols.reserve(by_symbol.size());
+  for (auto& [name, cycles] : by_symbol) {
+    symbols.push_back({name, cycles});
+  }
+  const size_t keep = std::min(kTopSymbols, symbols.size());
+  std::partial_sort(symbols.begin(), symbols.begin() + keep, symbols.end(),
+                    [](const SymbolCycles& a, const SymbolCycles& b) {
+                      return a.cycles != b.cycles ? a.cycles > b.cycles
+                                                  : a.name < b.name;
+                    });
+  symbols.resize(keep);
+  return symbols;
+}
+
+void FrameBudget::EndFrame(const Cpu& cpu, uint64_t cycle) {
+  const Counters now = ReadCounters(cpu);
+  Frame frame;
+  frame.index = presented_;
+  frame.start_cycle = frame_start_;
+  frame.cycles = cycle + 1 - frame_start_;
+  frame.draw_cycles = draw_start_ ? cycle + 1 - *draw_start_ : 0;
+  frame.commands = Delta(now.commands, baseline_.commands);
+  frame.lines = Delta(now.lines, baseline_.lines);
+  frame.mmio_writes = Delta(now.mmio_writes, baseline_.mmio_writes);
+  frame.overrun = frame.cycles > cycles_per_frame_;
+  if (frame.overrun) {
+    frame.top_symbols = TopSymbols();
+    ++overruns_;
+  }
+  frame_cycles_.Record(frame.cycles);
+  frames_.push_back(std::move(frame));
+
+  frame_start_ = cycle + 1;
+  draw_start_.reset();
+  baseline_ = now;
+  ClearAddressCycles();
+}
+
+void FrameBudget::WriteText(std::ostream& out) const {
+  const auto flags = out.flags();
+  const auto precision = out.precision();
+  const double percent =
+      frames_.empty() ? 0.0
+                      : 100.0 * static_cast<double>(overruns_) /
+                            static_cast<double>(frames_.size());
+  out << "frames=" << frames_.size() << " budget=" << cycles_per_frame_
+      << " overruns=" << overruns_ << " (" << std::fixed
+      << std::setprecision(1) << percent << "%)\n";
+  out.flags(flags);
+  out.precision(precision);
+  frame_cycles_.WriteText(out, "frame_cycles");
+
+  std::vector<const Frame*> worst;
+  for (const auto& frame : frames_) {
+    if (frame.overrun) {
+      worst.push_back(&frame);
+    }
+  }
+  const size_t shown = std::min(kReportedOverruns, worst.size());
+  std::partial_sort(worst.begin(), worst.begin() + shown, worst.end(),
+                    [](const Frame* a, const Frame* b) {
+                      return a->cycles != b->cycles ? a->cycles > b->cycles
+                                                    : a->index < b->index;
+                    });
+  for (size_t i = 0; i < shown; ++i) {
+    const Frame& frame = *worst[i];
+    out << "overrun frame " << frame.index << ": cycles=" << frame.cycles
+        << " (+" << frame.cycles - cycles_per_frame_
+        << ") draw=" << frame.draw_cycles << " commands=" << frame.commands
+        << " lines=" << frame.lines << " mmio_writes=" << frame.mmio_writes
+        << "\n";
+    for (const auto& symbol : frame.top_symbols) {
+      out << "  " << std::setw(10) << symbol.cycles << "  " << symbol.name
+          << "\n";
+    }
+  }
+  out.flags(flags);
+}
+
+void FrameBudget::WriteCsv(std::ostream& out) const {
+  out << "frame,start_cycle,cycles,draw_cycles,commands,lines,mmio_writes,"
+         "overrun,top_symbol\n";
+  for (const auto& frame : frames_) {
+    out << frame.index << ',' << frame.start_cycle << ',' << frame.cycles
+        << ',' << frame.draw_cycles << ',' << frame.commands << ','
+        << frame.lines << ',' << frame.mmio_writes << ','
+        << (frame.overrun ? 1 : 0) << ','
+        << (frame.top_symbols.empty() ? "" : frame.top_symbols.front().name)
+        << '\n';
+  }
+}
+
+}  // namespace irata2::sim
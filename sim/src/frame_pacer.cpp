@@ -0,0 +1,122 @@
+#include "irata2/sim/frame_pacer.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <thread>
+
+namespace irata2::sim {
+
+std::string ToString(PacingMode mode) {
+  switch (mode) {
+    case PacingMode::Realtime:
+      return "realtime";
+    case PacingMode::Turbo:
+      return "turbo";
+    case PacingMode::Unthrottled:
+      return "unthrottled";
+  }
+  return "unknown";
+}
+
+std::string FrameStats::Format() const {
+  char buffer[160];
+  std::snprintf(buffer, sizeof(buffer),
+                "frames=%llu late=%llu mean=%.3fms min=%.3fms max=%.3fms "
+                "jitter=%.3fms",
+                static_cast<unsigned long long>(frames),
+                static_cast<unsigned long long>(late_frames),
+                mean_ms, min_ms, max_ms, jitter_ms);
+  return buffer;
+}
+
+namespace {
+class SteadyFrameClock final : public FrameClock {
+ public:
+  Clock::time_point Now() const override { return Clock::now(); }
+
+  void WaitUntil(Clock::time_point deadline) override {
+    if (deadline - Clock::now() > kSpinWindow) {
+      std::this_thread::sleep_until(deadline - kSpinWindow);
+    }
+    while (Clock::now() < deadline) {
+      // Spin out the last stretch; sleep granularity is too coarse.
+    }
+  }
+};
+}  // namespace
+
+FrameClock& FrameClock::Steady() {
+  static SteadyFrameClock clock;
+  return clock;
+}
+
+FramePacer::FramePacer(int fps, FrameClock& clock)
+    : clock_(clock),
+      base_period_(std::chrono::duration_cast<Clock::duration>(
+          std::chrono::duration<double>(1.0 / std::max(fps, 1)))) {
+  Start();
+}
+
+void FramePacer::Start() {
+  frame_start_ = clock_.Now();
+  deadline_ = frame_start_ + Period();
+}
+
+FramePacer::Clock::duration FramePacer::Period() const {
+  return mode_ == PacingMode::Turbo ? base_period_ / turbo_factor_
+                                    : base_period_;
+}
+
+void FramePacer::WaitForNextFrame() {
+  bool late = false;
+  if (mode_ == PacingMode::Unthrottled) {
+    deadline_ = clock_.Now();
+  } else {
+    const auto now = clock_.Now();
+    if (now > deadline_) {
+      late = true;
+      if (now - deadline_ > Period() * kMaxLagFrames) {
+        deadline_ = now;
+      }
+    } else {
+      clock_.WaitUntil(deadline_);
+    }
+  }
+
+  const auto start = clock_.Now();
+  Record(start - frame_start_, late);
+  frame_start_ = start;
+  deadline_ += Period();
+}
+
+void FramePacer::Record(Clock::duration frame_time, bool late) {
+  const double ms =
+      std::chrono::duration<double, std::milli>(frame_time).count();
+  if (stats_.frames == 0) {
+    stats_.min_ms = ms;
+    stats_.max_ms = ms;
+  } else {
+    stats_.min_ms = std::min(stats_.min_ms, ms);
+    stats_.max_ms = std::max(stats_.max_ms, ms);
+  }
+  ++stats_.frames;
+  if (late) {
+    ++stats_.late_frames;
+  }
+  sum_ms_ += ms;
+  sum_sq_ms_ += ms * ms;
+
+  const double n = static_cast<double>(stats_.frames);
+  stats_.mean_ms = sum_ms_ / n;
+  stats_.jitter_ms =
+      std::sqrt(std::max(0.0, sum_sq_ms_ / n - stats_.mean_ms * stats_.mean_ms));
+}
+
+void FramePacer::ResetStats() {
+  stats_ = FrameStats{};
+  sum_ms_ = 0.0;
+  sum_sq_ms_ = 0.0;
+}
+
+}  // namespace irata2::sim
@@ -0,0 +1,163 @@
+#include "irata2/sim/guest_coverage.h"
+
+#include "irata2/isa/isa.h"
+#include "irata2/sim/cpu.h"
+
+#include <algorithm>
+#include <cctype>
+#include <filesystem>
+#include <set>
+#include <string>
+#include <vector>
+
+namespace irata2::sim {
+
+namespace {
+std::string Mnemonic(std::string_view text) {
+  const size_t begin = text.find_first_not_of(" \t");
+  if (begin == std::string_view::npos) {
+    return {};
+  }
+  const size_t end = text.find_first_of(" \t", begin);
+  std::string mnemonic(text.substr(begin, end - begin));
+  for (char& c : mnemonic) {
+    c = static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+  }
+  return mnemonic;
+}
+
+struct LineCoverage {
+  uint64_t hits = 0;
+  std::vector<uint16_t> starts;  // first address of each emission
+  bool branch = false;
+};
+}  // namespace
+
+GuestCoverage::GuestCoverage() {
+  for (const auto& info : isa::IsaInfo::GetInstructions()) {
+    if (info.addressing_mode == isa::AddressingMode::REL) {
+      conditional_branches_.set(static_cast<uint8_t>(info.opcode));
+    }
+  }
+  const auto rel = isa::IsaInfo::GetAddressingMode(isa::AddressingMode::REL);
+  branch_length_ = static_cast<uint16_t>(1 + (rel ? rel->operand_bytes : 1));
+}
+
+void GuestCoverage::OnCycle(const Cpu& cpu) {
+  if (!cpu.instruction_started()) {
+    return;
+  }
+  const auto& ir = cpu.controller().ir();
+  const uint16_t address = cpu.instruction_address().value();
+  const RetiredInstruction retired = retired_.OnInstructionStart(ir);
+
+  // An IRQ entry is not a branch, so the start after one must not be read
+  // as following the interrupted branch.
+  if (retired.is_instruction() &&
+      conditional_branches_.test(retired.opcode)) {
+    BranchCounts& counts = branches_[*previous_start_];
+    if (address == static_cast<uint16_t>(*previous_start_ + branch_length_)) {
+      ++counts.not_taken;
+    } else {
+      ++counts.taken;
+    }
+  }
+  // An IRQ entry reports the interrupted address, which has not run yet.
+  if (!retired_.in_irq_entry()) {
+    executed_.set(address);
+  }
+  previous_start_ = address;
+}
+
+void GuestCoverage::WriteLcov(std::ostream& out,
+                              const DebugSymbols& symbols,
+                              std::string_view test_name) const {
+  std::set<std::string> branch_mnemonics;
+  for (const auto& info : isa::IsaInfo::GetInstructions()) {
+    if (info.addressing_mode == isa::AddressingMode::REL) {
+      branch_mnemonics.insert(Mnemonic(info.mnemonic));
+    }
+  }
+
+  // Records cover every emitted byte; a line's instruction starts at the
+  // first byte of each run of consecutive addresses.
+  std::map<std::string, std::map<int, LineCoverage>> files;
+  std::vector<const DebugRecord*> records;
+  records.reserve(symbols.records.size());
+  for (const auto& record : symbols.records) {
+    records.push_back(&record);
+  }
+  std::stable_sort(records.begin(), records.end(),
+                   [](const DebugRecord* a, const DebugRecord* b) {
+                     return a->address < b->address;
+                   });
+  const DebugRecord* previous = nullptr;
+  for (const DebugRecord* record : records) {
+    const bool continues =
+        previous && previous->location.file == record->location.file &&
+        previous->location.line == record->location.line &&
+        previous->address.value() + 1 == record->address.value();
+    previous = record;
+    if (continues) {
+      continue;
+    }
+    const std::string mnemonic = Mnemonic(record->location.text);
+    if (mnemonic.empty() || mnemonic[0] == '.') {
+      continue;
+    }
+    LineCoverage& line =
+        files[record->location.file][record->location.line];
+    const uint16_t address = record->address.value();
+    line.starts.push_back(address);
+    line.hits += executed_.test(address) ? 1 : 0;
+    line.branch = line.branch || branch_mnemonics.count(mnemonic) != 0;
+  }
+
+  for (const auto& [file, lines] : files) {
+    std::filesystem::path path(file);
+    if (path.is_relative() && !symbols.source_root.empty()) {
+      path = std::filesystem::path(symbols.source_root) / path;
+    }
+    out << "TN:" << test_name << "\n";
+    out << "SF:" << path.string() << "\n";
+
+    size_t branches_found = 0;
+    size_t branches_hit = 0;
+    for (const auto& [number, line] : lines) {
+      if (!line.branch) {
+        continue;
+      }
+      for (size_t block = 0; block < line.starts.size(); ++block) {
+        auto it = branches_.find(line.starts[block]);
+        const bool ran = executed_.test(line.starts[block]);
+        const uint64_t counts[2] = {
+            it == branches_.end() ? 0 : it->second.taken,
+            it == branches_.end() ? 0 : it->second.not_taken};
+        for (int branch = 0; branch < 2; ++branch) {
+          out << "BRDA:" << number << ',' << block << ',' << branch << ',';
+          if (ran) {
+            out << counts[branch];
+          } else {
+            out << '-';
+          }
+          out << "\n";
+          ++branches_found;
+          branches_hit += counts[branch] != 0 ? 1 : 0;
+        }
+      }
+    }
+    out << "BRF:" << branches_found << "\n";
+    out << "BRH:" << branches_hit << "\n";
+
+    size_t lines_hit = 0;
+    for (const auto& [number, line] : lines) {
+      out << "DA:" << number << ',' << line.hits << "\n";
+      lines_hit += line.hits != 0 ? 1 : 0;
+    }
+    out << "LF:" << lines.size() << "\n";
+    out << "LH:" << lines_hit << "\n";
+    out << "end_of_record\n";
+  }
+}
+
+}  // namespace irata2::sim
@@ -0,0 +1,310 @@
+#include "irata2/sim/guest_profiler.h"
+
+#include "irata2/sim/cpu.h"
+#include "irata2/sim/json.h"
+
+#include <algorithm>
+#include <iomanip>
+#include <sstream>
+#include <unordered_map>
+
+namespace irata2::sim {
+
+namespace {
+double Percent(uint64_t part, uint64_t total) {
+  return total == 0 ? 0.0
+                    : 100.0 * static_cast<double>(part) /
+                          static_cast<double>(total);
+}
+}  // namespace
+
+GuestProfiler::GuestProfiler()
+    : cycles_(kAddressSpace, 0), instructions_(kAddressSpace, 0), nodes_(1) {}
+
+void GuestProfiler::SetSymbols(const DebugSymbols* symbols) {
+  symbols_ = symbols;
+  resolver_.Reset(symbols);
+}
+
+void GuestProfiler::OnCycle(const Cpu& cpu) {
+  const uint16_t address = cpu.instruction_address().value();
+
+  if (cpu.instruction_started()) {
+    const RetiredInstruction retired =
+        retired_.OnInstructionStart(cpu.controller().ir());
+    if (retired.kind == RetiredInstruction::Kind::None) {
+      nodes_[0].entry = address;
+      nodes_[0].calls = 1;
+    } else if (retired.opens_frame()) {
+      if (depth_ < kMaxDepth) {
+        current_ = Child(current_, address);
+        ++nodes_[current_].calls;
+        ++depth_;
+      } else {
+        ++overflow_;
+      }
+    } else if (retired.closes_frame()) {
+      if (overflow_ > 0) {
+        --overflow_;
+      } else if (depth_ > 0) {
+        current_ = nodes_[current_].parent;
+        --depth_;
+      }
+    }
+    ++instructions_[address];
+    ++total_instructions_;
+  }
+
+  ++cycles_[address];
+  ++total_cycles_;
+  ++nodes_[current_].self_cycles;
+}
+
+size_t GuestProfiler::Child(size_t parent, uint16_t entry) {
+  auto it = nodes_[parent].children.find(entry);
+  if (it != nodes_[parent].children.end()) {
+    return it->second;
+  }
+  const size_t index = nodes_.size();
+  Node node;
+  node.parent = parent;
+  node.entry = entry;
+  nodes_.push_back(std::move(node));
+  nodes_[parent].children.emplace(entry, index);
+  return index;
+}
+
+std::string GuestProfiler::NameFor(base::Word address) const {
+  return resolver_.NameFor(address);
+}
+
+std::string GuestProfiler::FrameName(uint16_t entry) const {
+  return NameFor(base::Word{entry});
+}
+
+std::vector<uint64_t> GuestProfiler::InclusiveCycles() const {
+  // Children are always created after their parent, so a reverse sweep
+  // sees every subtree complete before adding it to its parent.
+  std::vector<uint64_t> inclusive(nodes_.size());
+  for (size_t i = nodes_.size(); i-- > 0;) {
+    inclusive[i] += nodes_[i].self_cycles;
+    if (i != 0) {
+      inclusive[nodes_[i].parent] += inclusive[i];
+    }
+  }
+  return inclusive;
+}
+
+std::vector<GuestProfiler::FunctionStats> GuestProfiler::Functions() const {
+  const std::vector<uint64_t> inclusive = InclusiveCycles();
+  std::unordered_map<uint16_t, FunctionStats> by_entry;
+  std::unordered_map<uint16_t, size_t> active;
+
+  // Depth-first so recursion can be detected from the active path.
+  struct Visit {
+    size_t node;
+    bool leaving;
+  };
+  std::vector<Visit> stack{{0, false}};
+  while (!stack.empty()) {
+    const Visit visit = stack.back();
+    stack.pop_back();
+    const Node& node = nodes_[visit.node];
+    if (visit.leaving) {
+      --active[node.entry];
+      continue;
+    }
+    FunctionStats& stats = by_entry[node.entry];
+    stats.entry = base::Word{node.entry};
+    stats.calls += node.calls;
+    stats.self_cycles += node.self_cycles;
+    if (active[node.entry]++ == 0) {
+      stats.inclusive_cycles += inclusive[visit.node];
+    }
+    stack.push_back({visit.node, true});
+    for (const auto& [entry, child] : node.children) {
+      stack.push_back({child, false});
+    }
+  }
+
+  std::vector<FunctionStats> functions;
+  functions.reserve(by_entry.size());
+  for (auto& [entry, stats] : by_entry) {
+    stats.name = FrameName(entry);
+    functions.push_back(std::move(stats));
+  }
+  std::sort(functions.begin(), functions.end(),
+            [](const FunctionStats& a, const FunctionStats& b) {
+              if (a.inclusive_cycles != b.inclusive_cycles) {
+                return a.inclusive_cycles > b.inclusive_cycles;
+              }
+              return a.entry < b.entry;
+            });
+  return functions;
+}
+
+std::string GuestProfiler::StackName(size_t node) const {
+  std::vector<size_t> path;
+  for (size_t i = node;; i = nodes_[i].parent) {
+    path.push_back(i);
+    if (i == 0) {
+      break;
+    }
+  }
+  std::string name;
+  for (auto it = path.rbegin(); it != path.rend(); ++it) {
+    if (!name.empty()) {
+      name += ';';
+    }
+    name += FrameName(nodes_[*it].entry);
+  }
+  return name;
+}
+
+void GuestProfiler::WriteCollapsedStacks(std::ostream& out) const {
+  for (size_t i = 0; i < nodes_.size(); ++i) {
+    if (nodes_[i].self_cycles == 0) {
+      continue;
+    }
+    out << StackName(i) << ' ' << nodes_[i].self_cycles << '\n';
+  }
+}
+
+void GuestProfiler::WriteJson(std::ostream& out, uint64_t frames) const {
+  out << "{\n";
+  out << "  \"total_cycles\": " << total_cycles_ << ",\n";
+  out << "  \"total_instructions\": " << total_instructions_ << ",\n";
+  if (frames != 0) {
+    out << "  \"frames\": " << frames << ",\n";
+    out << "  \"cycles_per_frame\": "
+        << static_cast<double>(total_cycles_) / static_cast<double>(frames)
+        << ",\n";
+  }
+
+  // Flat profile by address, hottest first.
+  std::vector<uint16_t> hot;
+  for (size_t address = 0; address < kAddressSpace; ++address) {
+    if (cycles_[address] != 0) {
+      hot.push_back(static_cast<uint16_t>(address));
+    }
+  }
+  std::stable_sort(hot.begin(), hot.end(), [this](uint16_t a, uint16_t b) {
+    return cycles_[a] > cycles_[b];
+  });
+  out << "  \"addresses\": [";
+  for (size_t i = 0; i < hot.size(); ++i) {
+    const uint16_t address = hot[i];
+    out << (i == 0 ? "\n" : ",\n");
+    out << "    {\"address\": \"" << base::Word{address}.to_string()
+        << "\", \"symbol\": \"" << EscapeJson(NameFor(base::Word{address}))
+        << "\", \"cycles\": "
+        << cycles_[address] << ", \"instructions\": "
+        << instructions_[address];
+    if (symbols_) {
+      if (auto location = symbols_->Lookup(base::Word{address})) {
+        out << ", \"source\": \"" << EscapeJson(location->file) << ":"
+            << location->line << "\"";
+      }
+    }
+    out << "}";
+  }
+  out << "\n  ],\n";
+
+  // Flat profile by symbol: each address counts towards the nearest
+  // symbol at or below it.
+  std::map<std::string, uint64_t> by_symbol;
+  for (uint16_t address : hot) {
+    std::string name = NameFor(base::Word{address});
+    if (const size_t plus = name.find('+'); plus != std::string::npos) {
+      name.resize(plus);
+    }
+    by_symbol[name] += cycles_[address];
+  }
+  std::vector<std::pair<std::string, uint64_t>> symbols(by_symbol.begin(),
+                                                        by_symbol.end());
+  std::stable_sort(symbols.begin(), symbols.end(),
+                   [](const auto& a, const auto& b) {
+                     return a.second > b.second;
+                   });
+  out << "  \"symbols\": [";
+  for (size_t i = 0; i < symbols.size(); ++i) {
+    out << (i == 0 ? "\n" : ",\n");
+    out << "    {\"name\": \"" << EscapeJson(symbols[i].first)
+        << "\", \"cycles\": " << symbols[i].second << ", \"percent\": "
+        << std::fixed << std::setprecision(2)
+        << Percent(symbols[i].second, total_cycles_) << std::defaultfloat
+        << "}";
+  }
+  out << "\n  ],\n";
+
+  const std::vector<FunctionStats> functions = Functions();
+  out << "  \"functions\": [";
+  for (size_t i = 0; i < functions.size(); ++i) {
+    const FunctionStats& f = functions[i];
+    out << (i == 0 ? "\n" : ",\n");
+    out << "    {\"name\": \"" << EscapeJson(f.name) << "\", \"entry\": \""
+        << f.entry.to_string() << "\", \"calls\": " << f.calls
+        << ", \"self_cycles\": " << f.self_cycles
+        << ", \"inclusive_cycles\": " << f.inclusive_cycles << "}";
+  }
+  out << "\n  ]\n";
+  out << "}\n";
+}
+
+void GuestProfiler::WriteAnnotatedListing(std::ostream& out) const {
+  out << "; total " << total_cycles_ << " cycles, " << total_instructions_
+      << " instructions\n";
+  out << ";  cycles      %     count  address  source\n";
+
+  auto write_line = [&](uint16_t address, const std::string& source) {
+    out << std::setw(8) << cycles_[address] << "  " << std::fixed
+        << std::setprecision(2) << std::setw(6)
+        << Percent(cycles_[address], total_cycles_) << std::defaultfloat
+        << "  " << std::setw(8) << instructions_[address] << "  $"
+        << base::Word{address}.to_string().substr(2) << "    " << source << '\n';
+  };
+
+  if (!symbols_ || symbols_->records.empty()) {
+    for (size_t address = 0; address < kAddressSpace; ++address) {
+      if (cycles_[address] != 0) {
+        write_line(static_cast<uint16_t>(address),
+                   NameFor(base::Word{static_cast<uint16_t>(address)}));
+      }
+    }
+    return;
+  }
+
+  std::vector<const DebugRecord*> records;
+  records.reserve(symbols_->records.size());
+  for (const auto& record : symbols_->records) {
+    records.push_back(&record);
+  }
+  std::stable_sort(records.begin(), records.end(),
+                   [](const DebugRecord* a, const DebugRecord* b) {
+                     return a->address < b->address;
+                   });
+
+  const auto& labels = resolver_.sorted();
+  auto label = labels.begin();
+  const DebugRecord* previous = nullptr;
+  for (const DebugRecord* record : records) {
+    const uint16_t address = record->address.value();
+    // Records cover every emitted byte; list each source line once, at
+    // the address its instruction or data starts.
+    if (previous && previous->location.file == record->location.file &&
+        previous->location.line == record->location.line) {
+      continue;
+    }
+    previous = record;
+    while (label != labels.end() && label->first <= address) {
+      out << label->second << ":\n";
+      ++label;
+    }
+    std::ostringstream source;
+    source << record->location.file << ":" << record->location.line << "  "
+           << record->location.text;
+    write_line(address, source.str());
+  }
+}
+
+}  // namespace irata2::sim
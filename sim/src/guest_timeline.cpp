@@ -0,0 +1,174 @@
+#include "irata2/sim/guest_timeline.h"
+
+#include "irata2/sim/cpu.h"
+#include "irata2/sim/json.h"
+
+namespace irata2::sim {
+
+namespace {
+constexpr int kPid = 1;
+}  // namespace
+
+void GuestTimeline::SetSymbols(const DebugSymbols* symbols) {
+  resolver_.Reset(symbols);
+}
+
+std::string GuestTimeline::NameFor(uint16_t address) const {
+  return resolver_.NameFor(base::Word{address});
+}
+
+std::string GuestTimeline::RegionName(const Cpu& cpu,
+                                      base::Word address) const {
+  for (const auto& region : cpu.memory().regions()) {
+    if (region->Contains(address)) {
+      return region->name();
+    }
+  }
+  return "unmapped";
+}
+
+void GuestTimeline::Add(Event event) {
+  if (events_.size() >= max_events_) {
+    ++dropped_;
+    return;
+  }
+  events_.push_back(std::move(event));
+}
+
+GuestTimeline::Event GuestTimeline::CallSpan(const OpenSpan& span,
+                                             uint64_t end) const {
+  Event event;
+  event.track = Track::Cpu;
+  event.cycle = span.cycle;
+  event.duration = end - span.cycle;
+  event.name = NameFor(span.entry);
+  event.category = span.irq ? "irq" : "call";
+  event.args = "\"entry\": \"" + base::Word{span.entry}.to_string() + "\"";
+  return event;
+}
+
+void GuestTimeline::OnInstructionStart(const Cpu& cpu, uint64_t cycle) {
+  const auto& ir = cpu.controller().ir();
+  const uint16_t address = cpu.instruction_address().value();
+  const RetiredInstruction retired = retired_.OnInstructionStart(ir);
+
+  if (retired.opens_frame()) {
+    if (stack_.size() < kMaxDepth) {
+      stack_.push_back(
+          {cycle, address, retired.kind != RetiredInstruction::Kind::Jsr});
+    } else {
+      ++overflow_;
+    }
+    if (retired.kind == RetiredInstruction::Kind::IrqEntry &&
+        irq_requested_at_) {
+      Add({Track::Irq, 'X', *irq_requested_at_, cycle - *irq_requested_at_,
+           "irq latency", "irq",
+           "\"handler\": \"" + EscapeJson(NameFor(address)) + "\""});
+      irq_requested_at_.reset();
+    }
+  } else if (retired.closes_frame()) {
+    if (overflow_ > 0) {
+      --overflow_;
+    } else if (!stack_.empty()) {
+      Add(CallSpan(stack_.back(), cycle));
+      stack_.pop_back();
+    }
+  }
+}
+
+void GuestTimeline::OnCycle(const Cpu& cpu,
+                            std::span<const memory::MemoryAccess> mmio) {
+  // The cycle that just ran; cycle_count() has already moved past it.
+  const uint64_t cycle = cpu.cycle_count() - 1;
+  last_cycle_ = cycle;
+  if (!started_) {
+    started_ = true;
+    frames_ = cpu.frames_presented();
+    frame_start_ = cycle;
+  }
+
+  if (cpu.irq_requested()) {
+    if (!irq_line_high_) {
+      irq_requested_at_ = cycle;
+    }
+  } else if (irq_requested_at_ && !retired_.in_irq_entry()) {
+    Add({Track::Irq, 'X', *irq_requested_at_, cycle - *irq_requested_at_,
+         "irq withdrawn", "irq", ""});
+    irq_requested_at_.reset();
+  }
+  irq_line_high_ = cpu.irq_requested();
+
+  if (cpu.instruction_started()) {
+    OnInstructionStart(cpu, cycle);
+  }
+
+  while (frames_ < cpu.frames_presented()) {
+    ++frames_;
+    const std::string args = "\"frame\": " + std::to_string(frames_);
+    Add({Track::Video, 'X', frame_start_, cycle + 1 - frame_start_,
+         "frame " + std::to_string(frames_), "frame", args});
+    Add({Track::Video, 'I', cycle, 0, "present", "frame", args});
+    frame_start_ = cycle + 1;
+  }
+
+  for (const auto& access : mmio) {
+    Add({Track::Mmio, 'i', access.cycle, 0,
+         RegionName(cpu, access.address) + (access.write ? " write" : " read"),
+         "mmio",
+         "\"address\": \"" + access.address.to_string() +
+             "\", \"value\": \"" + access.value.to_string() + "\""});
+  }
+}
+
+void GuestTimeline::WriteChromeTrace(std::ostream& out) const {
+  bool first = true;
+  auto write = [&](const Event& event) {
+    out << (first ? "\n" : ",\n");
+    first = false;
+    out << "    {\"name\": \"" << EscapeJson(event.name) << "\", \"cat\": \""
+        << event.category << "\", \"ph\": \""
+        << (event.phase == 'I' ? 'i' : event.phase) << "\", \"ts\": "
+        << event.cycle;
+    if (event.phase == 'X') {
+      out << ", \"dur\": " << event.duration;
+    } else {
+      out << ", \"s\": \"" << (event.phase == 'I' ? 'g' : 't') << "\"";
+    }
+    out << ", \"pid\": " << kPid << ", \"tid\": "
+        << static_cast<int>(event.track) << ", \"args\": {" << event.args
+        << "}}";
+  };
+  auto write_name = [&](const char* kind, int tid, const char* name) {
+    out << (first ? "\n" : ",\n");
+    first = false;
+    out << "    {\"name\": \"" << kind << "\", \"ph\": \"M\", \"pid\": "
+        << kPid << ", \"tid\": " << tid << ", \"args\": {\"name\": \""
+        << name << "\"}}";
+  };
+
+  out << "{\n  \"traceEvents\": [";
+  write_name("process_name", 0, "irata2");
+  write_name("thread_name", static_cast<int>(Track::Cpu), "cpu");
+  write_name("thread_name", static_cast<int>(Track::Irq), "irq");
+  write_name("thread_name", static_cast<int>(Track::Video), "video");
+  write_name("thread_name", static_cast<int>(Track::Mmio), "mmio");
+  for (const auto& event : events_) {
+    write(event);
+  }
+
+  // Close whatever is still open at the end of the recording.
+  const uint64_t end = last_cycle_ + 1;
+  for (auto it = stack_.rbegin(); it != stack_.rend(); ++it) {
+    write(CallSpan(*it, end));
+  }
+  if (irq_requested_at_) {
+    write({Track::Irq, 'X', *irq_requested_at_, end - *irq_requested_at_,
+           "irq pending", "irq", ""});
+  }
+  out << "\n  ],\n";
+  out << "  \"otherData\": {\"clock\": \"cpu cycles\", \"events\": "
+      << events_.size() << ", \"dropped_events\": " << dropped_ << "}\n";
+  out << "}\n";
+}
+
+}  // namespace irata2::sim
@@ -0,0 +1,128 @@
+#include "irata2/sim/host_profile.h"
+
+#include <cxxabi.h>
+
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+#include <iomanip>
+#include <memory>
+#include <typeinfo>
+
+#include "irata2/sim/component.h"
+
+namespace irata2::sim {
+
+namespace {
+constexpr base::TickPhase kPhases[HostProfile::kPhaseCount] = {
+    base::TickPhase::Control, base::TickPhase::Write, base::TickPhase::Read,
+    base::TickPhase::Process, base::TickPhase::Clear};
+
+// Demangled name of the component's dynamic type with the irata2
+// namespaces stripped, including from template arguments.
+std::string TypeName(const Component& component) {
+  const char* mangled = typeid(component).name();
+  int status = 0;
+  std::unique_ptr<char, void (*)(void*)> demangled(
+      abi::__cxa_demangle(mangled, nullptr, nullptr, &status), std::free);
+  std::string name = status == 0 && demangled ? demangled.get() : mangled;
+  for (auto start = name.find("irata2::"); start != std::string::npos;
+       start = name.find("irata2::", start)) {
+    auto end = start;
+    while (end < name.size() &&
+           (std::isalnum(static_cast<unsigned char>(name[end])) ||
+            name[end] == '_' || name[end] == ':')) {
+      ++end;
+    }
+    const auto scope = name.rfind("::", end);
+    name.erase(start, scope + 2 - start);
+  }
+  return name;
+}
+
+double PerTick(uint64_t ns, uint64_t ticks) {
+  return ticks == 0 ? 0.0 : static_cast<double>(ns) / ticks;
+}
+}  // namespace
+
+uint64_t HostProfile::total_ns() const {
+  uint64_t total = 0;
+  for (uint64_t ns : phase_ns_) {
+    total += ns;
+  }
+  return total;
+}
+
+void HostProfile::Reset() {
+  ticks_ = 0;
+  phase_ns_.fill(0);
+  // Keep the type slots so cached slot indices stay valid.
+  for (auto& component : components_) {
+    component.ns.fill(0);
+  }
+}
+
+size_t HostProfile::ComponentSlot(const Component& component) {
+  const std::string type = TypeName(component);
+  for (size_t i = 0; i < components_.size(); ++i) {
+    if (components_[i].type == type) {
+      return i;
+    }
+  }
+  components_.push_back(ComponentTimes{type, {}});
+  return components_.size() - 1;
+}
+
+void HostProfile::WriteTable(std::ostream& out) const {
+  const auto flags = out.flags();
+  const auto precision = out.precision();
+  const uint64_t total = total_ns();
+  out << std::fixed;
+  out << "host profile: " << ticks_ << " ticks, " << std::setprecision(3)
+      << static_cast<double>(total) / 1e6 << " ms\n";
+  out << std::left << std::setw(10) << "phase" << std::right
+      << std::setw(12) << "ms" << std::setw(12) << "ns/tick"
+      << std::setw(8) << "share" << "\n";
+  for (auto phase : kPhases) {
+    const uint64_t ns = phase_ns(phase);
+    const double share =
+        total == 0 ? 0.0 : 100.0 * static_cast<double>(ns) / total;
+    out << std::left << std::setw(10) << base::ToString(phase) << std::right
+        << std::setw(12) << std::setprecision(3)
+        << static_cast<double>(ns) / 1e6 << std::setw(12)
+        << std::setprecision(1) << PerTick(ns, ticks_) << std::setw(7)
+        << share << "%\n";
+  }
+
+  bool any_components = false;
+  for (const auto& component : components_) {
+    for (uint64_t ns : component.ns) {
+      any_components = any_components || ns != 0;
+    }
+  }
+  if (any_components) {
+    int width = 20;
+    for (const auto& component : components_) {
+      width = std::max(width, static_cast<int>(component.type.size()) + 2);
+    }
+    out << "\n" << std::left << std::setw(width) << "component (ns/tick)";
+    for (auto phase : kPhases) {
+      out << std::right << std::setw(9) << base::ToString(phase);
+    }
+    out << std::setw(9) << "total" << "\n";
+    for (const auto& component : components_) {
+      uint64_t component_total = 0;
+      out << std::left << std::setw(width) << component.type << std::right
+          << std::setprecision(1);
+      for (uint64_t ns : component.ns) {
+        component_total += ns;
+        out << std::setw(9) << PerTick(ns, ticks_);
+      }
+      out << std::setw(9) << PerTick(component_total, ticks_) << "\n";
+    }
+  }
+  out.flags(flags);
+  out.precision(precision);
+}
+
+}  // namespace irata2::sim
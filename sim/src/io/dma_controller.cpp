@@ -0,0 +1,211 @@
+#include "irata2/sim/io/dma_controller.h"
+
+#include <algorithm>
+#include <cstring>
+#include <type_traits>
+
+#include "irata2/sim/cpu.h"
+
+namespace irata2::sim::io {
+
+static_assert(std::is_trivially_copyable_v<base::Byte>,
+              "DMA bulk copies rely on memmove over Byte storage");
+
+DmaController::DmaController(std::string name,
+                             Component& parent,
+                             LatchedProcessControl& irq_line)
+    : Module(std::move(name), parent),
+      irq_line_(irq_line) {}
+
+base::Byte DmaController::Read(base::Word address) const {
+  switch (address.value()) {
+    case dma_reg::STATUS: {
+      uint8_t status = 0;
+      if (busy_) {
+        status |= dma_status::BUSY;
+      }
+      if (irq_pending()) {
+        status |= dma_status::IRQ_PENDING;
+      }
+      // Reading STATUS acknowledges completion, mirroring the input device's
+      // read-with-side-effect DATA register.
+      done_ = false;
+      return base::Byte{status};
+    }
+    default:
+      // Configuration registers are write-only
+      return base::Byte{0};
+  }
+}
+
+void DmaController::Write(base::Word address, base::Byte value) {
+  const uint8_t raw = value.value();
+
+  switch (address.value()) {
+    case dma_reg::SRC_LO:
+      src_lo_ = value;
+      break;
+    case dma_reg::SRC_HI:
+      src_hi_ = value;
+      break;
+    case dma_reg::DST_LO:
+      dst_lo_ = value;
+      break;
+    case dma_reg::DST_HI:
+      dst_hi_ = value;
+      break;
+    case dma_reg::LEN_LO:
+      len_lo_ = raw;
+      break;
+    case dma_reg::LEN_HI:
+      len_hi_ = raw;
+      break;
+    case dma_reg::FILL:
+      fill_ = value;
+      break;
+    case dma_reg::MODE:
+      mode_ = raw;
+      break;
+    case dma_reg::CONTROL:
+      irq_enabled_ = (raw & dma_control::IRQ_ENABLE) != 0;
+      if (raw & dma_control::START) {
+        Start();
+      }
+      break;
+    default:
+      // Writes to read-only or reserved registers are ignored
+      break;
+  }
+}
+
+uint64_t DmaController::TransferCycles(uint8_t mode, uint16_t length) {
+  const uint64_t per_byte =
+      (mode == dma_mode::FILL) ? kFillCyclesPerByte : kCopyCyclesPerByte;
+  return kSetupCycles + per_byte * length;
+}
+
+void DmaController::Start() {
+  if (busy_) {
+    // A transfer is already in flight; the start request is dropped.
+    return;
+  }
+  Transfer();
+  busy_ = true;
+  done_ = false;
+  complete_cycle_ = cpu().cycle_count() + TransferCycles(mode_, length());
+}
+
+void DmaController::Transfer() {
+  const uint16_t count = length();
+  if (count == 0) {
+    return;
+  }
+
+  auto& memory = cpu().memory();
+  const base::Word src = source();
+  const base::Word dst = destination();
+
+  switch (mode_) {
+    case dma_mode::COPY: {
+      const auto from = memory.ContentsAt(src, count);
+      const auto to = memory.MutableContentsAt(dst, count);
+      if (!from.empty() && !to.empty()) {
+        std::memmove(to.data(), from.data(), count);
+        return;
+      }
+      // Like memmove: when the destination starts inside the source range,
+      // copy from the end so no byte is overwritten before it is read.
+      const uint16_t distance =
+          static_cast<uint16_t>(dst.value() - src.value());
+      if (distance != 0 && distance < count) {
+        for (uint16_t i = count; i-- > 0;) {
+          const base::Word offset{i};
+          memory.WriteAt(dst + offset, memory.ReadAt(src + offset));
+        }
+        return;
+      }
+      for (uint16_t i = 0; i < count; ++i) {
+        const base::Word offset{i};
+        memory.WriteAt(dst + offset, memory.ReadAt(src + offset));
+      }
+      return;
+    }
+
+    case dma_mode::FILL: {
+      const auto to = memory.MutableContentsAt(dst, count);
+      if (!to.empty()) {
+        std::fill(to.begin(), to.end(), fill_);
+        return;
+      }
+      for (uint16_t i = 0; i < count; ++i) {
+        memory.WriteAt(dst + base::Word{i}, fill_);
+      }
+      return;
+    }
+
+    case dma_mode::STREAM: {
+      // The destination is a device port, so every byte must go through
+      // WriteAt; only the source side can be read in bulk.
+      const auto from = memory.ContentsAt(src, count);
+      if (!from.empty()) {
+        for (const base::Byte byte : from) {
+          memory.WriteAt(dst, byte);
+        }
+        return;
+      }
+      for (uint16_t i = 0; i < count; ++i) {
+        memory.WriteAt(dst, memory.ReadAt(src + base::Word{i}));
+      }
+      return;
+    }
+
+    default:
+      // Unknown modes move nothing but still report completion.
+      return;
+  }
+}
+
+void DmaController::TickControl() {
+  if (busy_ && cpu().cycle_count() >= complete_cycle_) {
+    busy_ = false;
+    done_ = true;
+  }
+  // The CPU clears the shared IRQ line each cycle; only drive it high.
+  if (irq_pending()) {
+    irq_line_.Assert();
+  }
+}
+
+void DmaController::SaveState(SnapshotWriter& out) const {
+  Module::SaveState(out);
+  out.Write(src_lo_);
+  out.Write(src_hi_);
+  out.Write(dst_lo_);
+  out.Write(dst_hi_);
+  out.Write(len_lo_);
+  out.Write(len_hi_);
+  out.Write(fill_);
+  out.Write(mode_);
+  out.Write(irq_enabled_);
+  out.Write(busy_);
+  out.Write(done_);
+  out.Write(complete_cycle_);
+}
+
+void DmaController::LoadState(SnapshotReader& in) {
+  Module::LoadState(in);
+  in.Read(src_lo_);
+  in.Read(src_hi_);
+  in.Read(dst_lo_);
+  in.Read(dst_hi_);
+  in.Read(len_lo_);
+  in.Read(len_hi_);
+  in.Read(fill_);
+  in.Read(mode_);
+  in.Read(irq_enabled_);
+  in.Read(busy_);
+  in.Read(done_);
+  in.Read(complete_cycle_);
+}
+
+}  // namespace irata2::sim::io
@@ -1,5 +1,8 @@
 #include "irata2/sim/io/input_device.h"
 
+#include "irata2/sim/cpu.h"
+#include "irata2/sim/error.h"
+
 namespace irata2::sim::io {
 
 InputDevice::InputDevice(std::string name,
@@ -80,9 +83,50 @@ void InputDevice::set_key_up(uint8_t bit) {
   key_state_ &= ~bit;
 }
 
+bool InputDevice::PostHostEvent(const HostInputEvent& event) {
+  return host_events_.TryPush(event);
+}
+
+void InputDevice::DrainHostEvents() {
+  const uint64_t now = cpu().cycle_count();
+  while (true) {
+    if (!held_event_) {
+      held_event_ = host_events_.TryPop();
+      if (!held_event_) {
+        return;
+      }
+    }
+    if (held_event_->cycle > now) {
+      return;
+    }
+    Apply(*held_event_);
+    cpu().NotifyHostInput();
+    held_event_.reset();
+  }
+}
+
+void InputDevice::Apply(const HostInputEvent& event) {
+  switch (event.kind) {
+    case HostInputEvent::Kind::KeyDown:
+      set_key_down(event.value);
+      break;
+    case HostInputEvent::Kind::KeyUp:
+      set_key_up(event.value);
+      break;
+    case HostInputEvent::Kind::KeyPress:
+      inject_key(event.value);
+      break;
+  }
+}
+
 void InputDevice::TickControl() {
-  const bool pending = irq_enabled_ && !empty();
-  irq_line_.Set(pending);
+  if (host_events_enabled_) {
+    DrainHostEvents();
+  }
+  // The CPU clears the shared IRQ line each cycle; only drive it high.
+  if (irq_pending()) {
+    irq_line_.Assert();
+  }
 }
 
 uint8_t InputDevice::pop() {
@@ -103,4 +147,28 @@ uint8_t InputDevice::peek() const {
   return queue_[read_idx_];
 }
 
+void InputDevice::SaveState(SnapshotWriter& out) const {
+  Module::SaveState(out);
+  out.Write(queue_);
+  out.Write(read_idx_);
+  out.Write(write_idx_);
+  out.Write(count_);
+  out.Write(irq_enabled_);
+  out.Write(key_state_);
+}
+
+void InputDevice::LoadState(SnapshotReader& in) {
+  Module::LoadState(in);
+  in.Read(queue_);
+  in.Read(read_idx_);
+  in.Read(write_idx_);
+  in.Read(count_);
+  if (read_idx_ >= QUEUE_SIZE || write_idx_ >= QUEUE_SIZE ||
+      count_ > QUEUE_SIZE) {
+    throw SimError("snapshot input queue state out of range");
+  }
+  in.Read(irq_enabled_);
+  in.Read(key_state_);
+}
+
 }  // namespace irata2::sim::io
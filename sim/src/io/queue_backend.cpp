@@ -0,0 +1,49 @@
+#include "irata2/sim/io/queue_backend.h"
+
+#include <utility>
+
+namespace irata2::sim::io {
+
+void QueueBackend::clear(uint8_t intensity) {
+  // Nothing drawn before a clear survives it.
+  frame_.commands.clear();
+  frame_.commands.push_back({VgcOp::Clear, 0, 0, 0, 0, intensity});
+}
+
+void QueueBackend::draw_point(uint8_t x, uint8_t y, uint8_t intensity) {
+  frame_.commands.push_back({VgcOp::Point, x, y, 0, 0, intensity});
+}
+
+void QueueBackend::draw_line(uint8_t x0,
+                             uint8_t y0,
+                             uint8_t x1,
+                             uint8_t y1,
+                             uint8_t intensity) {
+  frame_.commands.push_back({VgcOp::Line, x0, y0, x1, y1, intensity});
+}
+
+void QueueBackend::submit(std::span<const VgcCommand> commands) {
+  for (const auto& command : commands) {
+    if (command.op == VgcOp::Clear) {
+      frame_.commands.clear();
+    }
+    frame_.commands.push_back(command);
+  }
+}
+
+void QueueBackend::present() {
+  const size_t reserve = frame_.commands.size();
+  frame_.sequence = frames_pushed_ + frames_dropped_;
+  if (queue_.TryPush(std::move(frame_))) {
+    ++frames_pushed_;
+    // The moved-from frame is handed back empty; keep roughly the same
+    // capacity so steady-state frames do not reallocate as they grow.
+    frame_ = VgcFrame{};
+    frame_.commands.reserve(reserve);
+  } else {
+    ++frames_dropped_;
+  }
+  frame_.commands.clear();
+}
+
+}  // namespace irata2::sim::io
@@ -0,0 +1,91 @@
+#include "irata2/sim/io/sound_backend.h"
+
+#include <array>
+
+#include "irata2/sim/error.h"
+
+namespace irata2::sim::io {
+
+namespace {
+constexpr uint32_t kWavHeaderSize = 44;
+
+void PutU16(std::array<uint8_t, kWavHeaderSize>& header, size_t offset,
+            uint16_t value) {
+  header[offset] = static_cast<uint8_t>(value & 0xFF);
+  header[offset + 1] = static_cast<uint8_t>(value >> 8);
+}
+
+void PutU32(std::array<uint8_t, kWavHeaderSize>& header, size_t offset,
+            uint32_t value) {
+  for (size_t i = 0; i < 4; ++i) {
+    header[offset + i] = static_cast<uint8_t>((value >> (8 * i)) & 0xFF);
+  }
+}
+}  // namespace
+
+void BufferSoundBackend::submit(std::span<const int16_t> samples) {
+  samples_.insert(samples_.end(), samples.begin(), samples.end());
+  ++blocks_;
+}
+
+WavSoundBackend::WavSoundBackend(const std::string& path,
+                                 uint32_t sample_rate)
+    : out_(path, std::ios::binary), path_(path), sample_rate_(sample_rate) {
+  if (!out_) {
+    throw SimError("failed to open WAV output: " + path);
+  }
+  WriteHeader();
+}
+
+WavSoundBackend::~WavSoundBackend() {
+  try {
+    Close();
+  } catch (const SimError&) {
+    // Nowhere to report it; callers that care close explicitly.
+  }
+}
+
+void WavSoundBackend::submit(std::span<const int16_t> samples) {
+  // WAV is little-endian, like every host this builds on.
+  out_.write(reinterpret_cast<const char*>(samples.data()),
+             static_cast<std::streamsize>(samples.size_bytes()));
+  samples_written_ += samples.size();
+}
+
+void WavSoundBackend::Close() {
+  if (!out_.is_open()) {
+    return;
+  }
+  out_.seekp(0);
+  WriteHeader();
+  out_.close();
+  if (!out_) {
+    throw SimError("failed to write WAV output: " + path_);
+  }
+}
+
+void WavSoundBackend::WriteHeader() {
+  const uint32_t data_size =
+      static_cast<uint32_t>(samples_written_ * sizeof(int16_t));
+  std::array<uint8_t, kWavHeaderSize> header{};
+  const char* tags[] = {"RIFF", "WAVE", "fmt ", "data"};
+  const size_t tag_offsets[] = {0, 8, 12, 36};
+  for (size_t t = 0; t < 4; ++t) {
+    for (size_t i = 0; i < 4; ++i) {
+      header[tag_offsets[t] + i] = static_cast<uint8_t>(tags[t][i]);
+    }
+  }
+  PutU32(header, 4, 36 + data_size);
+  PutU32(header, 16, 16);               // fmt chunk size
+  PutU16(header, 20, 1);                // PCM
+  PutU16(header, 22, 1);                // mono
+  PutU32(header, 24, sample_rate_);
+  PutU32(header, 28, sample_rate_ * 2);  // byte rate
+  PutU16(header, 32, 2);                // block align
+  PutU16(header, 34, 16);               // bits per sample
+  PutU32(header, 40, data_size);
+  out_.write(reinterpret_cast<const char*>(header.data()),
+             static_cast<std::streamsize>(header.size()));
+}
+
+}  // namespace irata2::sim::io
@@ -0,0 +1,179 @@
+#include "irata2/sim/io/sound_device.h"
+
+#include <algorithm>
+
+#include "irata2/sim/cpu.h"
+#include "irata2/sim/error.h"
+
+namespace irata2::sim::io {
+
+SoundDevice::SoundDevice(std::string name,
+                         Component& parent,
+                         std::unique_ptr<SoundBackend> backend,
+                         SoundConfig config)
+    : Module(std::move(name), parent),
+      backend_(std::move(backend)),
+      config_(config) {
+  if (!backend_) {
+    throw SimError("sound backend is null");
+  }
+  if (config_.cpu_hz == 0 || config_.sample_rate == 0 ||
+      config_.duration_tick_hz == 0) {
+    throw SimError("sound device rates must be non-zero");
+  }
+}
+
+base::Byte SoundDevice::Read(base::Word address) const {
+  switch (address.value()) {
+    case sound_reg::STATUS:
+      return base::Byte{playing() ? sound_status::PLAYING : uint8_t{0}};
+    default:
+      // Configuration registers are write-only
+      return base::Byte{0};
+  }
+}
+
+void SoundDevice::Write(base::Word address, base::Byte value) {
+  const uint64_t now = cpu().cycle_count();
+  // Everything before this write was played with the old settings.
+  AdvanceTo(now);
+
+  const uint8_t raw = value.value();
+  switch (address.value()) {
+    case sound_reg::FREQ_LO:
+      freq_lo_ = raw;
+      break;
+    case sound_reg::FREQ_HI:
+      freq_hi_ = raw;
+      break;
+    case sound_reg::DURATION:
+      duration_ = raw;
+      break;
+    case sound_reg::VOLUME:
+      volume_ = static_cast<uint8_t>(raw & 0x0F);
+      break;
+    case sound_reg::CONTROL:
+      if (raw & sound_control::RESET) {
+        Reset();
+        break;
+      }
+      playing_ = (raw & sound_control::PLAY) != 0;
+      phase_ = 0;
+      end_cycle_ = (playing_ && duration_ != 0)
+                       ? now + static_cast<uint64_t>(duration_) *
+                                   config_.cpu_hz / config_.duration_tick_hz
+                       : 0;
+      break;
+    default:
+      // Writes to read-only or reserved registers are ignored
+      break;
+  }
+}
+
+bool SoundDevice::playing() const {
+  return playing_ && (end_cycle_ == 0 || cpu().cycle_count() < end_cycle_);
+}
+
+void SoundDevice::Sync() {
+  AdvanceTo(cpu().cycle_count());
+  FlushBlock();
+}
+
+uint64_t SoundDevice::SampleAt(uint64_t cycle) const {
+  return cycle * config_.sample_rate / config_.cpu_hz;
+}
+
+void SoundDevice::AdvanceTo(uint64_t cycle) {
+  const uint64_t target = SampleAt(cycle);
+  while (samples_generated_ < target) {
+    uint64_t count = std::min<uint64_t>(target - samples_generated_,
+                                        kBlockSize - block_fill_);
+    if (playing_ && end_cycle_ != 0) {
+      const uint64_t end_sample = SampleAt(end_cycle_);
+      if (samples_generated_ >= end_sample) {
+        playing_ = false;
+      } else {
+        count = std::min(count, end_sample - samples_generated_);
+      }
+    }
+    Fill(block_.data() + block_fill_, static_cast<size_t>(count));
+    block_fill_ += static_cast<size_t>(count);
+    samples_generated_ += count;
+    if (block_fill_ == kBlockSize) {
+      FlushBlock();
+    }
+  }
+}
+
+void SoundDevice::Fill(int16_t* out, size_t count) {
+  const uint32_t frequency =
+      static_cast<uint32_t>(freq_lo_) | (static_cast<uint32_t>(freq_hi_) << 8);
+  if (!playing_ || volume_ == 0 || frequency == 0) {
+    std::fill(out, out + count, int16_t{0});
+    return;
+  }
+  const auto amplitude =
+      static_cast<int16_t>(kMaxAmplitude * volume_ / 15);
+  const auto step = static_cast<uint32_t>(
+      (static_cast<uint64_t>(frequency) << 32) / config_.sample_rate);
+  uint32_t phase = phase_;
+  for (size_t i = 0; i < count; ++i) {
+    out[i] = (phase < 0x80000000u) ? amplitude
+                                   : static_cast<int16_t>(-amplitude);
+    phase += step;
+  }
+  phase_ = phase;
+}
+
+void SoundDevice::FlushBlock() {
+  if (block_fill_ == 0) {
+    return;
+  }
+  if (output_enabled_) {
+    backend_->submit(std::span<const int16_t>(block_.data(), block_fill_));
+  }
+  block_fill_ = 0;
+}
+
+void SoundDevice::Reset() {
+  freq_lo_ = 0;
+  freq_hi_ = 0;
+  duration_ = 0;
+  volume_ = 0;
+  playing_ = false;
+  end_cycle_ = 0;
+  phase_ = 0;
+}
+
+void SoundDevice::SaveState(SnapshotWriter& out) const {
+  Module::SaveState(out);
+  out.Write(freq_lo_);
+  out.Write(freq_hi_);
+  out.Write(duration_);
+  out.Write(volume_);
+  out.Write(playing_);
+  out.Write(end_cycle_);
+  out.Write(phase_);
+  out.Write(samples_generated_);
+  out.Write(block_fill_);
+  out.WriteSpan(std::span<const int16_t>(block_.data(), block_fill_));
+}
+
+void SoundDevice::LoadState(SnapshotReader& in) {
+  Module::LoadState(in);
+  in.Read(freq_lo_);
+  in.Read(freq_hi_);
+  in.Read(duration_);
+  in.Read(volume_);
+  in.Read(playing_);
+  in.Read(end_cycle_);
+  in.Read(phase_);
+  in.Read(samples_generated_);
+  in.Read(block_fill_);
+  if (block_fill_ > block_.size()) {
+    throw SimError("snapshot sound block size out of range");
+  }
+  in.ReadSpan(std::span<int16_t>(block_.data(), block_fill_));
+}
+
+}  // namespace irata2::sim::io
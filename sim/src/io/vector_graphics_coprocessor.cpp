@@ -1,9 +1,84 @@
 #include "irata2/sim/io/vector_graphics_coprocessor.h"
 
+#include "irata2/sim/cpu.h"
 #include "irata2/sim/error.h"
+#include "irata2/sim/io/vgc_font.h"
+
+#include <algorithm>
+#include <cmath>
+#include <numbers>
+#include <string_view>
+#include <vector>
 
 namespace irata2::sim::io {
 
+namespace {
+constexpr int kSinShift = 14;  // sine table is Q1.14
+constexpr int kScaleShift = 4;  // SCALE is 4.4
+constexpr int kScreenMax = 255;
+
+const std::array<int32_t, 256>& SinTable() {
+  static const std::array<int32_t, 256> table = [] {
+    std::array<int32_t, 256> values{};
+    for (size_t i = 0; i < values.size(); ++i) {
+      const double angle = 2.0 * std::numbers::pi * static_cast<double>(i) /
+                           static_cast<double>(values.size());
+      values[i] = static_cast<int32_t>(
+          std::lround(std::sin(angle) * (1 << kSinShift)));
+    }
+    return values;
+  }();
+  return table;
+}
+
+/// Round a value carrying `shift` fraction bits to the nearest integer.
+int RoundShift(int32_t value, int shift) {
+  return static_cast<int>((value + (1 << (shift - 1))) >> shift);
+}
+
+/// Liang-Barsky clip of a segment to the 256x256 screen. Returns false when
+/// nothing of the segment is visible.
+bool ClipToScreen(int& x0, int& y0, int& x1, int& y1) {
+  const double dx = x1 - x0;
+  const double dy = y1 - y0;
+  double enter = 0.0;
+  double leave = 1.0;
+  const double p[] = {-dx, dx, -dy, dy};
+  const double q[] = {static_cast<double>(x0),
+                      static_cast<double>(kScreenMax - x0),
+                      static_cast<double>(y0),
+                      static_cast<double>(kScreenMax - y0)};
+  for (int edge = 0; edge < 4; ++edge) {
+    if (p[edge] == 0.0) {
+      if (q[edge] < 0.0) {
+        return false;
+      }
+      continue;
+    }
+    const double t = q[edge] / p[edge];
+    if (p[edge] < 0.0) {
+      enter = std::max(enter, t);
+    } else {
+      leave = std::min(leave, t);
+    }
+  }
+  if (enter > leave) {
+    return false;
+  }
+  const int start_x = x0;
+  const int start_y = y0;
+  if (leave < 1.0) {
+    x1 = static_cast<int>(std::lround(start_x + leave * dx));
+    y1 = static_cast<int>(std::lround(start_y + leave * dy));
+  }
+  if (enter > 0.0) {
+    x0 = static_cast<int>(std::lround(start_x + enter * dx));
+    y0 = static_cast<int>(std::lround(start_y + enter * dy));
+  }
+  return true;
+}
+}  // namespace
+
 VectorGraphicsCoprocessor::VectorGraphicsCoprocessor(
     std::string name,
     Component& parent,
@@ -56,36 +131,368 @@ void VectorGraphicsCoprocessor::Write(base::Word address, base::Byte value) {
     case vgc_reg::CONTROL:
       ApplyControl(raw);
       break;
+    case vgc_reg::STREAM:
+      WriteStream(raw);
+      break;
+    case vgc_reg::DL_ADDR_LO:
+      dl_addr_lo_ = raw;
+      break;
+    case vgc_reg::DL_ADDR_HI:
+      dl_addr_hi_ = raw;
+      break;
+    case vgc_reg::DL_COUNT:
+      RunDisplayList(base::Word(base::Byte{dl_addr_hi_}, base::Byte{dl_addr_lo_}),
+                     raw);
+      break;
+    case vgc_reg::SHAPE_ADDR_LO:
+      shape_addr_lo_ = raw;
+      break;
+    case vgc_reg::SHAPE_ADDR_HI:
+      shape_addr_hi_ = raw;
+      break;
+    case vgc_reg::SHAPE_LOAD:
+      LoadShape(raw, base::Word(base::Byte{shape_addr_hi_},
+                                base::Byte{shape_addr_lo_}));
+      break;
+    case vgc_reg::SCALE:
+      scale_ = raw;
+      break;
     default:
       break;
   }
 }
 
 void VectorGraphicsCoprocessor::ExecuteCommand() {
-  switch (cmd_) {
+  Dispatch(cmd_, x0_, y0_, x1_, y1_, intensity());
+}
+
+void VectorGraphicsCoprocessor::Dispatch(uint8_t cmd,
+                                         uint8_t x0,
+                                         uint8_t y0,
+                                         uint8_t x1,
+                                         uint8_t y1,
+                                         uint8_t intensity) {
+  if (cmd != vgc_cmd::NOP) {
+    ++commands_issued_;
+  }
+  switch (cmd) {
     case vgc_cmd::NOP:
       break;
     case vgc_cmd::CLEAR:
-      backend_->clear(intensity());
+      Append({VgcOp::Clear, 0, 0, 0, 0, intensity});
       break;
     case vgc_cmd::POINT:
-      backend_->draw_point(x0_, y0_, intensity());
+      Append({VgcOp::Point, x0, y0, 0, 0, intensity});
       break;
     case vgc_cmd::LINE:
-      backend_->draw_line(x0_, y0_, x1_, y1_, intensity());
+      Append({VgcOp::Line, x0, y0, x1, y1, intensity});
+      break;
+    case vgc_cmd::DRAW_SHAPE:
+      DrawShape(x0, y0, x1, y1, intensity);
+      break;
+    case vgc_cmd::GLYPH:
+      DrawGlyph(x0, y0, static_cast<char>(x1), intensity);
+      break;
+    case vgc_cmd::TEXT:
+      DrawText(x0, y0, base::Word(base::Byte{y1}, base::Byte{x1}), intensity);
       break;
     default:
       break;
   }
 }
 
+void VectorGraphicsCoprocessor::LoadShape(uint8_t id, base::Word address) {
+  auto& memory = cpu().memory();
+  Shape& shape = shapes_[id % vgc_shape::kShapeCount];
+  const uint8_t header = memory.ReadAt(address).value();
+  shape.count = std::min<uint8_t>(header & vgc_shape::COUNT_MASK,
+                                  vgc_shape::kMaxVertices);
+  shape.closed = (header & vgc_shape::CLOSED) != 0;
+  shape.vertices.fill(0);
+  for (size_t i = 0; i < static_cast<size_t>(shape.count) * 2; ++i) {
+    shape.vertices[i] = static_cast<int8_t>(
+        memory.ReadAt(address + base::Word{static_cast<uint16_t>(i + 1)})
+            .value());
+  }
+}
+
+void VectorGraphicsCoprocessor::DrawShape(uint8_t x,
+                                          uint8_t y,
+                                          uint8_t id,
+                                          uint8_t rotation,
+                                          uint8_t intensity) {
+  const Shape& shape = shapes_[id % vgc_shape::kShapeCount];
+  if (shape.count == 0) {
+    return;
+  }
+
+  // Scale (4.4) times sine (1.14) leaves 18 fraction bits to round off.
+  const auto& sin_table = SinTable();
+  const int32_t sin = sin_table[rotation];
+  const int32_t cos = sin_table[static_cast<uint8_t>(rotation + 64)];
+  const int32_t scale = scale_;
+  constexpr int kShift = kSinShift + kScaleShift;
+
+  std::array<int, vgc_shape::kMaxVertices> xs{};
+  std::array<int, vgc_shape::kMaxVertices> ys{};
+  for (size_t i = 0; i < shape.count; ++i) {
+    const int32_t vx = shape.vertices[2 * i] * scale;
+    const int32_t vy = shape.vertices[2 * i + 1] * scale;
+    xs[i] = x + RoundShift(vx * cos - vy * sin, kShift);
+    ys[i] = y + RoundShift(vx * sin + vy * cos, kShift);
+  }
+
+  if (shape.count == 1) {
+    if (xs[0] >= 0 && xs[0] <= kScreenMax && ys[0] >= 0 &&
+        ys[0] <= kScreenMax) {
+      Append({VgcOp::Point, static_cast<uint8_t>(xs[0]),
+              static_cast<uint8_t>(ys[0]), 0, 0, intensity});
+    }
+    return;
+  }
+  for (size_t i = 0; i + 1 < shape.count; ++i) {
+    AppendClippedLine(xs[i], ys[i], xs[i + 1], ys[i + 1], intensity);
+  }
+  if (shape.closed && shape.count > 2) {
+    const size_t last = shape.count - 1;
+    AppendClippedLine(xs[last], ys[last], xs[0], ys[0], intensity);
+  }
+}
+
+void VectorGraphicsCoprocessor::DrawGlyph(int x,
+                                          int y,
+                                          char c,
+                                          uint8_t intensity) {
+  const std::string_view strokes = VgcGlyphStrokes(c);
+  const int32_t unit = vgc_font::kUnitPixels * scale_;
+  auto to_x = [&](char digit) {
+    return x + RoundShift((digit - '0') * unit, kScaleShift);
+  };
+  auto to_y = [&](char digit) {
+    return y + RoundShift((digit - '0') * unit, kScaleShift);
+  };
+
+  size_t start = 0;
+  while (start < strokes.size()) {
+    size_t end = strokes.find(' ', start);
+    if (end == std::string_view::npos) {
+      end = strokes.size();
+    }
+    const std::string_view stroke = strokes.substr(start, end - start);
+    if (stroke.size() == 2) {
+      const int px = to_x(stroke[0]);
+      const int py = to_y(stroke[1]);
+      if (px >= 0 && px <= kScreenMax && py >= 0 && py <= kScreenMax) {
+        Append({VgcOp::Point, static_cast<uint8_t>(px),
+                static_cast<uint8_t>(py), 0, 0, intensity});
+      }
+    }
+    for (size_t i = 0; i + 3 < stroke.size(); i += 2) {
+      AppendClippedLine(to_x(stroke[i]), to_y(stroke[i + 1]),
+                        to_x(stroke[i + 2]), to_y(stroke[i + 3]), intensity);
+    }
+    start = end + 1;
+  }
+}
+
+void VectorGraphicsCoprocessor::DrawText(uint8_t x,
+                                         uint8_t y,
+                                         base::Word address,
+                                         uint8_t intensity) {
+  auto& memory = cpu().memory();
+  const int32_t unit = vgc_font::kUnitPixels * scale_;
+  const int advance = RoundShift(vgc_font::kAdvance * unit, kScaleShift);
+  const int line_height =
+      RoundShift(vgc_font::kLineHeight * unit, kScaleShift);
+
+  int pen_x = x;
+  int pen_y = y;
+  for (size_t i = 0; i < vgc_font::kMaxTextLength; ++i) {
+    // Peek the backing store so a string pointer into a device region
+    // cannot fire its read side effects; such a string ends there.
+    const auto byte =
+        memory.ContentsAt(address + base::Word{static_cast<uint16_t>(i)}, 1);
+    if (byte.empty()) {
+      break;
+    }
+    const char c = static_cast<char>(byte[0].value());
+    if (c == '\0') {
+      break;
+    }
+    if (c == '\n') {
+      pen_x = x;
+      pen_y += line_height;
+      continue;
+    }
+    DrawGlyph(pen_x, pen_y, c, intensity);
+    pen_x += advance;
+  }
+}
+
+void VectorGraphicsCoprocessor::AppendClippedLine(int x0,
+                                                  int y0,
+                                                  int x1,
+                                                  int y1,
+                                                  uint8_t intensity) {
+  if (!ClipToScreen(x0, y0, x1, y1)) {
+    return;
+  }
+  Append({VgcOp::Line, static_cast<uint8_t>(x0), static_cast<uint8_t>(y0),
+          static_cast<uint8_t>(x1), static_cast<uint8_t>(y1), intensity});
+}
+
+void VectorGraphicsCoprocessor::Append(const VgcCommand& command) {
+  if (command.op == VgcOp::Line) {
+    ++lines_drawn_;
+  } else if (command.op == VgcOp::Clear) {
+    ++clears_;
+    // Everything queued before a clear would be overwritten anyway.
+    batch_size_ = 0;
+  }
+  batch_cycles_[batch_size_] = cpu().cycle_count();
+  batch_[batch_size_++] = command;
+  if (batch_size_ == batch_.size()) {
+    Flush();
+  }
+}
+
+void VectorGraphicsCoprocessor::Flush() {
+  if (batch_size_ == 0) {
+    return;
+  }
+  if (output_enabled_) {
+    if (capture_) {
+      for (size_t i = 0; i < batch_size_; ++i) {
+        capture_->WriteCommand(batch_cycles_[i], batch_[i]);
+      }
+    }
+    backend_->submit(std::span<const VgcCommand>(batch_.data(), batch_size_));
+  }
+  batch_size_ = 0;
+}
+
+void VectorGraphicsCoprocessor::SaveState(SnapshotWriter& out) const {
+  Module::SaveState(out);
+  out.Write(cmd_);
+  out.Write(x0_);
+  out.Write(y0_);
+  out.Write(x1_);
+  out.Write(y1_);
+  out.Write(color_);
+  out.Write(irq_enabled_);
+  out.Write(stream_);
+  out.Write(stream_fill_);
+  out.Write(dl_addr_lo_);
+  out.Write(dl_addr_hi_);
+  out.Write(shape_addr_lo_);
+  out.Write(shape_addr_hi_);
+  out.Write(scale_);
+  out.Write(shapes_);
+  out.Write(batch_size_);
+  out.WriteSpan(std::span<const VgcCommand>(batch_.data(), batch_size_));
+}
+
+void VectorGraphicsCoprocessor::LoadState(SnapshotReader& in) {
+  Module::LoadState(in);
+  in.Read(cmd_);
+  in.Read(x0_);
+  in.Read(y0_);
+  in.Read(x1_);
+  in.Read(y1_);
+  in.Read(color_);
+  in.Read(irq_enabled_);
+  in.Read(stream_);
+  in.Read(stream_fill_);
+  if (stream_fill_ >= stream_.size()) {
+    throw SimError("snapshot VGC stream fill out of range");
+  }
+  in.Read(dl_addr_lo_);
+  in.Read(dl_addr_hi_);
+  in.Read(shape_addr_lo_);
+  in.Read(shape_addr_hi_);
+  in.Read(scale_);
+  in.Read(shapes_);
+  for (const auto& shape : shapes_) {
+    if (shape.count > vgc_shape::kMaxVertices) {
+      throw SimError("snapshot VGC shape vertex count out of range");
+    }
+  }
+  in.Read(batch_size_);
+  if (batch_size_ > batch_.size()) {
+    throw SimError("snapshot VGC batch size out of range");
+  }
+  in.ReadSpan(std::span<VgcCommand>(batch_.data(), batch_size_));
+  batch_cycles_.fill(cpu().cycle_count());
+}
+
+void VectorGraphicsCoprocessor::RunDisplayList(base::Word address,
+                                               uint8_t count) {
+  if (count == 0) {
+    return;
+  }
+  const size_t length = static_cast<size_t>(count) * vgc_packed::kCommandSize;
+  auto& memory = cpu().memory();
+
+  // Display lists normally live in RAM or ROM, so decode straight from the
+  // backing store. Lists that straddle regions are gathered byte by byte.
+  std::vector<base::Byte> gathered;
+  auto list = memory.ContentsAt(address, length);
+  if (list.empty()) {
+    gathered.reserve(length);
+    for (size_t i = 0; i < length; ++i) {
+      gathered.push_back(
+          memory.ReadAt(address + base::Word{static_cast<uint16_t>(i)}));
+    }
+    list = gathered;
+  }
+
+  // Display-list commands do not disturb the discrete command registers.
+  for (size_t offset = 0; offset < length;
+       offset += vgc_packed::kCommandSize) {
+    const base::Byte* packed = list.data() + offset;
+    Dispatch(packed[0].value(),
+             packed[1].value(),
+             packed[2].value(),
+             packed[3].value(),
+             packed[4].value(),
+             static_cast<uint8_t>(packed[5].value() & 0x03));
+  }
+}
+
+void VectorGraphicsCoprocessor::ExecutePacked(const uint8_t* packed) {
+  // Packed commands latch through the same registers as discrete writes so
+  // the two interfaces can be mixed freely.
+  cmd_ = packed[0];
+  x0_ = packed[1];
+  y0_ = packed[2];
+  x1_ = packed[3];
+  y1_ = packed[4];
+  color_ = packed[5];
+  ExecuteCommand();
+}
+
+void VectorGraphicsCoprocessor::WriteStream(uint8_t raw) {
+  stream_[stream_fill_++] = raw;
+  if (stream_fill_ == stream_.size()) {
+    stream_fill_ = 0;
+    ExecutePacked(stream_.data());
+  }
+}
+
 void VectorGraphicsCoprocessor::ApplyControl(uint8_t control) {
   irq_enabled_ = (control & vgc_control::IRQ_ENABLE) != 0;
   if (control & vgc_control::CLEAR) {
-    backend_->clear(intensity());
+    Append({VgcOp::Clear, 0, 0, 0, 0, intensity()});
   }
   if (control & vgc_control::PRESENT) {
-    backend_->present();
+    Flush();
+    if (output_enabled_) {
+      backend_->present();
+      if (capture_) {
+        capture_->WritePresent(cpu().cycle_count());
+      }
+    }
+    cpu().NotifyFramePresented();
   }
 }
 
@@ -2,20 +2,36 @@
 
 #include <algorithm>
 #include <cstdlib>
+#include <cstring>
 
 namespace irata2::sim::io {
 
+static_assert(ImageBackend::kWidth == 256 && ImageBackend::kHeight == 256,
+              "ImageBackend relies on uint8_t coordinates never clipping");
+
+void VgcBackend::submit(std::span<const VgcCommand> commands) {
+  for (const auto& command : commands) {
+    switch (command.op) {
+      case VgcOp::Clear:
+        clear(command.intensity);
+        break;
+      case VgcOp::Point:
+        draw_point(command.x0, command.y0, command.intensity);
+        break;
+      case VgcOp::Line:
+        draw_line(command.x0, command.y0, command.x1, command.y1,
+                  command.intensity);
+        break;
+    }
+  }
+}
+
 void ImageBackend::clear(uint8_t intensity) {
-  std::fill(framebuffer_.begin(), framebuffer_.end(), intensity);
+  Record({VgcOp::Clear, 0, 0, 0, 0, intensity});
 }
 
 void ImageBackend::draw_point(uint8_t x, uint8_t y, uint8_t intensity) {
-  const size_t px = static_cast<size_t>(x);
-  const size_t py = static_cast<size_t>(y);
-  if (px >= kWidth || py >= kHeight) {
-    return;
-  }
-  framebuffer_[py * kWidth + px] = intensity;
+  Record({VgcOp::Point, x, y, 0, 0, intensity});
 }
 
 void ImageBackend::draw_line(uint8_t x0,
@@ -23,27 +39,150 @@ void ImageBackend::draw_line(uint8_t x0,
                              uint8_t x1,
                              uint8_t y1,
                              uint8_t intensity) {
+  Record({VgcOp::Line, x0, y0, x1, y1, intensity});
+}
+
+void ImageBackend::present() {
+  ++frames_presented_;
+  if (rasterize_interval_ != 0 &&
+      frames_presented_ % rasterize_interval_ == 0) {
+    Rasterize();
+  }
+}
+
+void ImageBackend::submit(std::span<const VgcCommand> commands) {
+  for (const auto& command : commands) {
+    Record(command);
+  }
+}
+
+void ImageBackend::reset_dirty() {
+  Rasterize();
+  dirty_rows_.reset();
+  dirty_rect_ = DirtyRect{};
+}
+
+void ImageBackend::Record(const VgcCommand& command) {
+  if (command.op == VgcOp::Clear) {
+    // Pixels drawn before a clear cannot survive it, so neither do their
+    // commands; the clear's own dirty marking covers the rows they touched.
+    recorded_.clear();
+    stream_hash_ = kFnvOffset;
+  } else if (recorded_.size() >= kMaxRecordedCommands) {
+    Rasterize();
+  }
+  recorded_.push_back(command);
+
+  const uint8_t bytes[] = {static_cast<uint8_t>(command.op), command.x0,
+                           command.y0, command.x1, command.y1,
+                           command.intensity};
+  for (uint8_t byte : bytes) {
+    stream_hash_ = (stream_hash_ ^ byte) * kFnvPrime;
+  }
+}
+
+void ImageBackend::Rasterize() const {
+  if (recorded_.empty()) {
+    return;
+  }
+  for (const auto& command : recorded_) {
+    switch (command.op) {
+      case VgcOp::Clear:
+        Clear(command.intensity);
+        break;
+      case VgcOp::Point:
+        Plot(command.x0, command.y0, command.intensity);
+        break;
+      case VgcOp::Line:
+        RasterizeLine(command.x0, command.y0, command.x1, command.y1,
+                      command.intensity);
+        break;
+    }
+  }
+  recorded_.clear();
+}
+
+void ImageBackend::Clear(uint8_t intensity) const {
+  if (intensity != background_ || drawn_rows_.all()) {
+    std::memset(framebuffer_.data(), intensity, framebuffer_.size());
+    background_ = intensity;
+    drawn_rows_.reset();
+    dirty_rows_.set();
+    ExtendDirtyRect(0, 0, kWidth, kHeight);
+    return;
+  }
+
+  // Same background as before: only rows drawn since then can differ.
+  if (drawn_rows_.none()) {
+    return;
+  }
+  size_t first = kHeight;
+  size_t last = 0;
+  for (size_t y = 0; y < kHeight; ++y) {
+    if (!drawn_rows_.test(y)) {
+      continue;
+    }
+    std::memset(framebuffer_.data() + y * kWidth, intensity, kWidth);
+    dirty_rows_.set(y);
+    first = std::min(first, y);
+    last = y;
+  }
+  drawn_rows_.reset();
+  ExtendDirtyRect(0, first, kWidth, last + 1);
+}
+
+void ImageBackend::Plot(size_t x, size_t y, uint8_t intensity) const {
+  framebuffer_[y * kWidth + x] = intensity;
+  MarkDirty(x, y, x + 1, y + 1);
+}
+
+void ImageBackend::RasterizeLine(int x0, int y0, int x1, int y1,
+                                 uint8_t intensity) const {
+  // Coordinates come from uint8_t, so every plotted pixel is on screen and
+  // stays inside the endpoints' bounding box.
+  MarkDirty(static_cast<size_t>(std::min(x0, x1)),
+            static_cast<size_t>(std::min(y0, y1)),
+            static_cast<size_t>(std::max(x0, x1)) + 1,
+            static_cast<size_t>(std::max(y0, y1)) + 1);
+
+  const int dx = std::abs(x1 - x0);
+  const int dy = std::abs(y1 - y0);
+  const int width = static_cast<int>(kWidth);
+  uint8_t* const fb = framebuffer_.data();
+
+  if (dy == 0) {
+    const int left = std::min(x0, x1);
+    std::memset(fb + y0 * width + left, intensity,
+                static_cast<size_t>(dx + 1));
+    return;
+  }
+
+  if (dx == 0 || dx == dy) {
+    // Vertical and 45-degree lines are a constant stride through the buffer.
+    const int step_x = (dx == 0) ? 0 : ((x0 < x1) ? 1 : -1);
+    const int step_y = (y0 < y1) ? width : -width;
+    uint8_t* pixel = fb + y0 * width + x0;
+    for (int i = 0; i <= dy; ++i) {
+      *pixel = intensity;
+      pixel += step_x + step_y;
+    }
+    return;
+  }
+
   int x = x0;
   int y = y0;
-  const int target_x = x1;
-  const int target_y = y1;
-
-  const int dx = std::abs(target_x - x);
-  const int dy = -std::abs(target_y - y);
-  const int step_x = (x < target_x) ? 1 : -1;
-  const int step_y = (y < target_y) ? 1 : -1;
-  int error = dx + dy;
+  const int step_x = (x < x1) ? 1 : -1;
+  const int step_y = (y < y1) ? 1 : -1;
+  int error = dx - dy;
 
   while (true) {
-    draw_point(static_cast<uint8_t>(x),
-               static_cast<uint8_t>(y),
-               intensity);
-    if (x == target_x && y == target_y) {
+    fb[y * width + x] = intensity;
+    if (x == x1 && y == y1) {
       break;
     }
     const int error2 = 2 * error;
-    if (error2 >= dy) {
-      error += dy;
+    if (error2 >= -dy) {
+      error -= dy;
       x += step_x;
     }
     if (error2 <= dx) {
@@ -53,4 +192,25 @@ void ImageBackend::draw_line(uint8_t x0,
   }
 }
 
+void ImageBackend::MarkDirty(size_t x0, size_t y0, size_t x1,
+                             size_t y1) const {
+  for (size_t y = y0; y < y1; ++y) {
+    drawn_rows_.set(y);
+    dirty_rows_.set(y);
+  }
+  ExtendDirtyRect(x0, y0, x1, y1);
+}
+
+void ImageBackend::ExtendDirtyRect(size_t x0, size_t y0, size_t x1,
+                                   size_t y1) const {
+  if (dirty_rect_.empty()) {
+    dirty_rect_ = DirtyRect{x0, y0, x1, y1};
+    return;
+  }
+  dirty_rect_.x0 = std::min(dirty_rect_.x0, x0);
+  dirty_rect_.y0 = std::min(dirty_rect_.y0, y0);
+  dirty_rect_.x1 = std::max(dirty_rect_.x1, x1);
+  dirty_rect_.y1 = std::max(dirty_rect_.y1, y1);
+}
+
 }  // namespace irata2::sim::io
@@ -0,0 +1,197 @@
+#include "irata2/sim/io/vgc_capture.h"
+
+#include <fstream>
+#include <iterator>
+
+#include "irata2/sim/error.h"
+#include "irata2/sim/varint.h"
+
+namespace irata2::sim::io {
+
+namespace {
+constexpr uint8_t kTagClear = 0;
+constexpr uint8_t kTagPoint = 1;
+constexpr uint8_t kTagLine = 2;
+constexpr uint8_t kTagPresent = 3;
+}  // namespace
+
+VgcCaptureWriter::VgcCaptureWriter(std::ostream& out) : out_(out) {
+  buffer_.reserve(kFlushThreshold + 16);
+  buffer_.insert(buffer_.end(), vgc_capture::kMagic.begin(),
+                 vgc_capture::kMagic.end());
+  buffer_.push_back(static_cast<uint8_t>(vgc_capture::kVersion & 0xFF));
+  buffer_.push_back(static_cast<uint8_t>(vgc_capture::kVersion >> 8));
+  buffer_.push_back(0);
+  buffer_.push_back(0);
+  Flush();
+}
+
+VgcCaptureWriter::~VgcCaptureWriter() {
+  try {
+    Flush();
+  } catch (const SimError&) {
+    // Nowhere to report it; callers that care flush explicitly.
+  }
+}
+
+void VgcCaptureWriter::WriteCommand(uint64_t cycle,
+                                    const VgcCommand& command) {
+  switch (command.op) {
+    case VgcOp::Clear:
+      WriteTag(kTagClear, command.intensity, cycle);
+      break;
+    case VgcOp::Point:
+      WriteTag(kTagPoint, command.intensity, cycle);
+      buffer_.push_back(command.x0);
+      buffer_.push_back(command.y0);
+      break;
+    case VgcOp::Line:
+      WriteTag(kTagLine, command.intensity, cycle);
+      buffer_.push_back(command.x0);
+      buffer_.push_back(command.y0);
+      buffer_.push_back(command.x1);
+      buffer_.push_back(command.y1);
+      break;
+  }
+  ++commands_written_;
+  if (buffer_.size() >= kFlushThreshold) {
+    Flush();
+  }
+}
+
+void VgcCaptureWriter::WritePresent(uint64_t cycle) {
+  WriteTag(kTagPresent, 0, cycle);
+  ++frames_written_;
+  if (buffer_.size() >= kFlushThreshold) {
+    Flush();
+  }
+}
+
+void VgcCaptureWriter::Flush() {
+  if (!buffer_.empty()) {
+    out_.write(reinterpret_cast<const char*>(buffer_.data()),
+               static_cast<std::streamsize>(buffer_.size()));
+    buffer_.clear();
+  }
+  out_.flush();
+  if (!out_) {
+    throw SimError("failed to write VGC capture");
+  }
+}
+
+void VgcCaptureWriter::WriteTag(uint8_t kind, uint8_t intensity,
+                                uint64_t cycle) {
+  buffer_.push_back(static_cast<uint8_t>(kind | ((intensity & 0x03) << 2)));
+  varint::Put(buffer_,
+              varint::ZigZag(static_cast<int64_t>(cycle - last_cycle_)));
+  last_cycle_ = cycle;
+}
+
+VgcCaptureReader::VgcCaptureReader(std::vector<uint8_t> data)
+    : data_(std::move(data)) {
+  if (data_.size() < vgc_capture::kHeaderSize) {
+    throw SimError("VGC capture header truncated");
+  }
+  for (size_t i = 0; i < vgc_capture::kMagic.size(); ++i) {
+    if (static_cast<char>(data_[i]) != vgc_capture::kMagic[i]) {
+      throw SimError("VGC capture magic mismatch");
+    }
+  }
+  const uint16_t version =
+      static_cast<uint16_t>(data_[4] | (static_cast<uint16_t>(data_[5]) << 8));
+  if (version != vgc_capture::kVersion) {
+    throw SimError("unsupported VGC capture version " +
+                   std::to_string(version));
+  }
+}
+
+VgcCaptureReader VgcCaptureReader::FromFile(const std::string& path) {
+  std::ifstream input(path, std::ios::binary);
+  if (!input) {
+    throw SimError("failed to open VGC capture: " + path);
+  }
+  std::vector<uint8_t> data((std::istreambuf_iterator<char>(input)),
+                            std::istreambuf_iterator<char>());
+  return VgcCaptureReader(std::move(data));
+}
+
+std::optional<VgcCaptureRecord> VgcCaptureReader::Next() {
+  if (at_end()) {
+    return std::nullopt;
+  }
+  const uint8_t tag = ReadByte();
+  if (tag >> 4) {
+    throw SimError("VGC capture record has reserved tag bits set");
+  }
+
+  const uint64_t delta = varint::Read([this] { return ReadByte(); },
+                                      "VGC capture cycle delta too long");
+  cycle_ += static_cast<uint64_t>(varint::UnZigZag(delta));
+
+  VgcCaptureRecord record;
+  record.cycle = cycle_;
+  record.command.intensity = static_cast<uint8_t>((tag >> 2) & 0x03);
+  switch (tag & 0x03) {
+    case kTagClear:
+      record.command.op = VgcOp::Clear;
+      break;
+    case kTagPoint:
+      record.command.op = VgcOp::Point;
+      record.command.x0 = ReadByte();
+      record.command.y0 = ReadByte();
+      break;
+    case kTagLine:
+      record.command.op = VgcOp::Line;
+      record.command.x0 = ReadByte();
+      record.command.y0 = ReadByte();
+      record.command.x1 = ReadByte();
+      record.command.y1 = ReadByte();
+      break;
+    case kTagPresent:
+      record.kind = VgcCaptureRecord::Kind::Present;
+      record.command = VgcCommand{};
+      break;
+  }
+  return record;
+}
+
+uint8_t VgcCaptureReader::ReadByte() {
+  if (offset_ >= data_.size()) {
+    throw SimError("VGC capture truncated");
+  }
+  return data_[offset_++];
+}
+
+VgcReplayResult ReplayVgcCapture(
+    VgcCaptureReader& reader,
+    VgcBackend& backend,
+    uint64_t max_frames,
+    const std::function<void(uint64_t frame, uint64_t cycle)>& on_present) {
+  VgcReplayResult result;
+  std::vector<VgcCommand> frame;
+  while (max_frames == 0 || result.frames < max_frames) {
+    auto record = reader.Next();
+    if (!record) {
+      break;
+    }
+    result.last_cycle = record->cycle;
+    if (record->kind == VgcCaptureRecord::Kind::Command) {
+      frame.push_back(record->command);
+      ++result.commands;
+      continue;
+    }
+    backend.submit(frame);
+    frame.clear();
+    backend.present();
+    if (on_present) {
+      on_present(result.frames, record->cycle);
+    }
+    ++result.frames;
+  }
+  if (!frame.empty()) {
+    backend.submit(frame);
+  }
+  return result;
+}
+
+}  // namespace irata2::sim::io
@@ -0,0 +1,60 @@
+#include "irata2/sim/io/vgc_font.h"
+
+namespace irata2::sim::io {
+
+std::string_view VgcGlyphStrokes(char c) {
+  switch (c) {
+    case '0': return "0040460600 0640";
+    case '1': return "102026 1636";
+    case '2': return "004043030646";
+    case '3': return "00404606 1343";
+    case '4': return "000343 4046";
+    case '5': return "400003434606";
+    case '6': return "400006464303";
+    case '7': return "004016";
+    case '8': return "0040460600 0343";
+    case '9': return "430300404606";
+    case 'A': return "0602204246 0343";
+    case 'B': return "003041423303 334445360600";
+    case 'C': return "40000646";
+    case 'D': return "00304145360600";
+    case 'E': return "40000646 0333";
+    case 'F': return "400006 0333";
+    case 'G': return "400006464323";
+    case 'H': return "0006 4046 0343";
+    case 'I': return "0040 2026 0646";
+    case 'J': return "40460604";
+    case 'K': return "0006 400346";
+    case 'L': return "000646";
+    case 'M': return "0600234046";
+    case 'N': return "06004640";
+    case 'O': return "0040460600";
+    case 'P': return "0600404303";
+    case 'Q': return "0040460600 2446";
+    case 'R': return "0600404303 2346";
+    case 'S': return "400003434606";
+    case 'T': return "0040 2026";
+    case 'U': return "00064640";
+    case 'V': return "002640";
+    case 'W': return "0016233640";
+    case 'X': return "0046 4006";
+    case 'Y': return "002340 2326";
+    case 'Z': return "00400646";
+    case '-': return "1333";
+    case '.': return "2526";
+    case ':': return "2122 2425";
+    case '!': return "2024 2526";
+    case '?': return "0040422224 2526";
+    case '/': return "0640";
+    case '+': return "1333 2224";
+    case '=': return "0242 0444";
+    default:
+      break;
+  }
+  if (c >= 'a' && c <= 'z') {
+    return VgcGlyphStrokes(static_cast<char>(c - 'a' + 'A'));
+  }
+  return {};
+}
+
+}  // namespace irata2::sim::io
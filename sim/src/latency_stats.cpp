@@ -0,0 +1,75 @@
+#include "irata2/sim/latency_stats.h"
+
+#include <algorithm>
+#include <bit>
+#include <iomanip>
+
+namespace irata2::sim {
+
+void LatencyHistogram::Record(uint64_t cycles) {
+  ++buckets_[std::bit_width(cycles)];
+  ++count_;
+  sum_ += cycles;
+  min_ = std::min(min_, cycles);
+  max_ = std::max(max_, cycles);
+}
+
+uint64_t LatencyHistogram::BucketLow(size_t index) {
+  return index == 0 ? 0 : uint64_t{1} << (index - 1);
+}
+
+uint64_t LatencyHistogram::BucketHigh(size_t index) {
+  if (index == 0) {
+    return 0;
+  }
+  return index == kBuckets - 1 ? UINT64_MAX : (uint64_t{1} << index) - 1;
+}
+
+uint64_t LatencyHistogram::Percentile(double fraction) const {
+  if (count_ == 0) {
+    return 0;
+  }
+  const double clamped = std::clamp(fraction, 0.0, 1.0);
+  const uint64_t rank = std::max<uint64_t>(
+      1, static_cast<uint64_t>(clamped * static_cast<double>(count_) + 0.5));
+  uint64_t seen = 0;
+  for (size_t i = 0; i < kBuckets; ++i) {
+    seen += buckets_[i];
+    if (seen >= rank) {
+      return std::min(BucketHigh(i), max_);
+    }
+  }
+  return max_;
+}
+
+void LatencyHistogram::WriteText(std::ostream& out,
+                                 std::string_view name) const {
+  const auto flags = out.flags();
+  const auto precision = out.precision();
+  out << name << ": count=" << count_;
+  if (count_ != 0) {
+    out << std::fixed << std::setprecision(1) << " min=" << min()
+        << " mean=" << mean() << " p50=" << Percentile(0.5)
+        << " p90=" << Percentile(0.9) << " p99=" << Percentile(0.99)
+        << " max=" << max_;
+  }
+  out << "\n";
+  for (size_t i = 0; i < kBuckets; ++i) {
+    if (buckets_[i] == 0) {
+      continue;
+    }
+    out << "  " << std::setw(8) << BucketLow(i) << " - " << std::left
+        << std::setw(8) << BucketHigh(i) << std::right << std::setw(10)
+        << buckets_[i] << "\n";
+  }
+  out.flags(flags);
+  out.precision(precision);
+}
+
+void LatencyStats::WriteText(std::ostream& out) const {
+  irq_entry.WriteText(out, "irq_entry");
+  irq_handler.WriteText(out, "irq_handler");
+  input_to_present.WriteText(out, "input_to_present");
+}
+
+}  // namespace irata2::sim
@@ -2,6 +2,8 @@
 
 #include <sstream>
 
+#include "irata2/sim/cpu.h"
+
 namespace irata2::sim::memory {
 
 Memory::Memory(std::string name,
@@ -68,4 +70,64 @@ void Memory::WriteAt(base::Word address, base::Byte value) {
   region->Write(address, value);
 }
 
+base::Byte Memory::read_value() const {
+  const base::Word address = mar_.value();
+  CheckAccessWatch(address);
+  const auto* region = FindRegion(address);
+  if (!region) {
+    return base::Byte{0xFF};
+  }
+  region->CountRead();
+  const base::Byte value = region->Read(address);
+  if (access_log_) {
+    access_log_->push_back({cpu().cycle_count(), address, value, false});
+  }
+  if (mmio_log_ && region->is_mmio()) {
+    mmio_log_->push_back({cpu().cycle_count(), address, value, false});
+  }
+  return value;
+}
+
+void Memory::write_value(base::Byte value) {
+  const base::Word address = mar_.value();
+  CheckAccessWatch(address);
+  auto* region = FindRegion(address);
+  if (!region) {
+    WriteAt(address, value);  // throws for the unmapped address
+    return;
+  }
+  region->CountWrite();
+  region->Write(address, value);
+  if (access_log_) {
+    access_log_->push_back({cpu().cycle_count(), address, value, true});
+  }
+  if (mmio_log_ && region->is_mmio()) {
+    mmio_log_->push_back({cpu().cycle_count(), address, value, true});
+  }
+}
+
+void Memory::ResetAccessCounts() {
+  for (auto& region : regions_) {
+    region->ResetAccessCounts();
+  }
+}
+
+std::span<const base::Byte> Memory::ContentsAt(base::Word address,
+                                               size_t length) const {
+  const auto* region = FindRegion(address);
+  if (!region) {
+    return {};
+  }
+  return region->ContentsAt(address, length);
+}
+
+std::span<base::Byte> Memory::MutableContentsAt(base::Word address,
+                                                size_t length) {
+  auto* region = FindRegion(address);
+  if (!region) {
+    return {};
+  }
+  return region->MutableContentsAt(address, length);
+}
+
 }  // namespace irata2::sim::memory
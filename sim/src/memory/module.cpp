@@ -37,6 +37,16 @@ void Ram::Write(base::Word address, base::Byte value) {
   data_[index] = value;
 }
 
+void Ram::SaveState(SnapshotWriter& out) const {
+  Module::SaveState(out);
+  out.WriteSpan(std::span<const base::Byte>(data_));
+}
+
+void Ram::LoadState(SnapshotReader& in) {
+  Module::LoadState(in);
+  in.ReadSpan(std::span<base::Byte>(data_));
+}
+
 Rom::Rom(std::string name, Component& parent, size_t size, base::Byte fill)
     : Module(std::move(name), parent),
       storage_("storage", *this, size, fill) {
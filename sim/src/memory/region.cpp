@@ -72,4 +72,34 @@ void Region::Write(base::Word address, base::Byte value) {
   module_->Write(Translate(address), value);
 }
 
+bool Region::is_mmio() const {
+  return ContentsAt(offset_, 1).empty();
+}
+
+std::span<const base::Byte> Region::ContentsAt(base::Word address,
+                                               size_t length) const {
+  if (!Contains(address)) {
+    return {};
+  }
+  const auto contents = module_->contents();
+  const size_t start = Translate(address).value();
+  if (start + length > contents.size()) {
+    return {};
+  }
+  return contents.subspan(start, length);
+}
+
+std::span<base::Byte> Region::MutableContentsAt(base::Word address,
+                                                size_t length) {
+  if (!Contains(address)) {
+    return {};
+  }
+  const auto contents = module_->mutable_contents();
+  const size_t start = Translate(address).value();
+  if (start + length > contents.size()) {
+    return {};
+  }
+  return contents.subspan(start, length);
+}
+
 }  // namespace irata2::sim::memory
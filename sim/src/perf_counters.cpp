@@ -0,0 +1,86 @@
+#include "irata2/sim/perf_counters.h"
+
+#include "irata2/sim/json.h"
+
+#include <iomanip>
+#include <sstream>
+
+namespace irata2::sim {
+
+uint64_t PerfCounters::memory_reads() const {
+  uint64_t total = 0;
+  for (const auto& region : regions) {
+    total += region.reads;
+  }
+  return total;
+}
+
+uint64_t PerfCounters::memory_writes() const {
+  uint64_t total = 0;
+  for (const auto& region : regions) {
+    total += region.writes;
+  }
+  return total;
+}
+
+uint64_t PerfCounters::mmio_accesses() const {
+  uint64_t total = 0;
+  for (const auto& region : regions) {
+    if (region.mmio) {
+      total += region.reads + region.writes;
+    }
+  }
+  return total;
+}
+
+void PerfCounters::WriteText(std::ostream& out) const {
+  const auto flags = out.flags();
+  const auto precision = out.precision();
+  out << std::fixed << std::setprecision(3);
+  out << "cycles: " << cycles << "\n";
+  out << "instructions: " << instructions << "\n";
+  out << "cpi: " << cycles_per_instruction() << "\n";
+  out << "data_bus_utilization: " << data_bus_utilization() << "\n";
+  out << "address_bus_utilization: " << address_bus_utilization() << "\n";
+  out << "irqs_taken: " << irqs_taken << "\n";
+  out << "irq_masked_cycles: " << irq_masked_cycles << "\n";
+  out << "memory_reads: " << memory_reads() << "\n";
+  out << "memory_writes: " << memory_writes() << "\n";
+  for (const auto& region : regions) {
+    out << "  " << region.name << " @" << region.offset.to_string()
+        << (region.mmio ? " (mmio)" : "") << ": reads=" << region.reads
+        << " writes=" << region.writes << "\n";
+  }
+  out.flags(flags);
+  out.precision(precision);
+}
+
+void PerfCounters::WriteJson(std::ostream& out) const {
+  const auto flags = out.flags();
+  const auto precision = out.precision();
+  out << std::fixed << std::setprecision(6);
+  out << "{\"cycles\": " << cycles << ", \"instructions\": " << instructions
+      << ", \"cpi\": " << cycles_per_instruction()
+      << ", \"data_bus_cycles\": " << data_bus_cycles
+      << ", \"address_bus_cycles\": " << address_bus_cycles
+      << ", \"data_bus_utilization\": " << data_bus_utilization()
+      << ", \"address_bus_utilization\": " << address_bus_utilization()
+      << ", \"irqs_taken\": " << irqs_taken
+      << ", \"irq_masked_cycles\": " << irq_masked_cycles
+      << ", \"memory_reads\": " << memory_reads()
+      << ", \"memory_writes\": " << memory_writes()
+      << ", \"mmio_accesses\": " << mmio_accesses() << ", \"regions\": [";
+  for (size_t i = 0; i < regions.size(); ++i) {
+    const auto& region = regions[i];
+    out << (i == 0 ? "" : ", ") << "{\"name\": \"" << EscapeJson(region.name)
+        << "\", \"offset\": \"" << region.offset.to_string()
+        << "\", \"mmio\": " << (region.mmio ? "true" : "false")
+        << ", \"reads\": " << region.reads
+        << ", \"writes\": " << region.writes << "}";
+  }
+  out << "]}";
+  out.flags(flags);
+  out.precision(precision);
+}
+
+}  // namespace irata2::sim
@@ -0,0 +1,46 @@
+#include "irata2/sim/retired_instruction.h"
+
+#include "irata2/isa/isa.h"
+#include "irata2/sim/instruction_register.h"
+
+namespace irata2::sim {
+
+namespace {
+RetiredInstruction::Kind KindFor(uint8_t opcode) {
+  using Kind = RetiredInstruction::Kind;
+  switch (static_cast<isa::Opcode>(opcode)) {
+    case isa::Opcode::JSR_ABS:
+      return Kind::Jsr;
+    case isa::Opcode::BRK_IMP:
+      return Kind::Brk;
+    case isa::Opcode::RTS_IMP:
+      return Kind::Rts;
+    case isa::Opcode::RTI_IMP:
+      return Kind::Rti;
+    default:
+      return Kind::Other;
+  }
+}
+}  // namespace
+
+RetiredInstruction RetiredInstructionTracker::OnInstructionStart(
+    const InstructionRegister& ir) {
+  const bool after_irq_entry = in_irq_entry_;
+  const bool first = !seen_start_;
+  in_irq_entry_ = ir.injecting_interrupt();
+  seen_start_ = true;
+
+  RetiredInstruction retired;
+  if (first) {
+    return retired;
+  }
+  if (after_irq_entry) {
+    retired.kind = RetiredInstruction::Kind::IrqEntry;
+    return retired;
+  }
+  retired.opcode = ir.fetched_value().value();
+  retired.kind = KindFor(retired.opcode);
+  return retired;
+}
+
+}  // namespace irata2::sim
@@ -1,21 +1,182 @@
 #include "irata2/sim.h"
 #include "irata2/sim/debug_dump.h"
+#include "irata2/sim/frame_budget.h"
+#include "irata2/sim/guest_coverage.h"
+#include "irata2/sim/guest_profiler.h"
+#include "irata2/sim/guest_timeline.h"
+#include "irata2/sim/io/input_device.h"
+#include "irata2/sim/io/sound_device.h"
+#include "irata2/sim/io/vector_graphics_coprocessor.h"
+#include "irata2/sim/io/vgc_backend.h"
+#include "irata2/sim/trace_stream.h"
 #include "irata2/base/log.h"
 
+#include <algorithm>
 #include <cstdint>
 #include <cstdlib>
+#include <filesystem>
+#include <fstream>
 #include <iostream>
+#include <memory>
 #include <optional>
+#include <sstream>
+#include <stdexcept>
+#include <vector>
 
 namespace {
 void PrintUsage(const char* argv0) {
   std::cerr << "Usage: " << argv0
             << " [--expect-crash] [--max-cycles N] [--debug debug.json]"
             << " [--trace-depth N] [--log-level {info,warning,error,debug}]"
-            << " <cartridge.bin>\n"
+            << " [--wav out.wav] [--profile out.json]"
+            << " [--microcode-profile run.prof] [--perf] [--latency]"
+            << " [--trace-out run.i2t] [--trace-range LO:HI]"
+            << " [--trace-opcode OP]\n"
+            << "  [--trace-irq-only] [--trace-every N] [--timeline out.json]"
+            << " [--frame-budget CYCLES] [--frame-csv out.csv]\n"
+            << "  [--coverage out.info] [--input-script keys.txt]"
+            << " [--headless-devices] <cartridge.bin>\n"
+            << "\n--profile also writes a collapsed-stack file (.folded) and an"
+            << " annotated listing (.lst)\nnext to out.json; pass --debug for"
+            << " symbol names.\n"
+            << "--microcode-profile counts microcode entries for"
+            << " microcode_dump --profile.\n"
+            << "--perf prints the CPU performance counters after the run.\n"
+            << "--latency prints IRQ entry, IRQ handler and input-to-present"
+            << " latency histograms;\ninput-to-present needs --input-script.\n"
+            << "--input-script feeds host input events, one per line as"
+            << " 'CYCLE press|down|up VALUE'.\n"
+            << "--trace-out streams every instruction and memory access for"
+            << " irata2_trace.\n"
+            << "--timeline writes calls, IRQs, frames and device accesses as a"
+            << " Chrome trace\n(chrome://tracing or ui.perfetto.dev).\n"
+            << "--frame-budget reports per-frame cycles, flagging frames over"
+            << " CYCLES;\n--frame-csv also writes one row per frame.\n"
+            << "--headless-devices maps the VGC and input device so"
+            << " interactive cartridges run\nheadless; --input-script and"
+            << " --frame-budget need them and imply it. Observers\nsuch as"
+            << " --profile, --timeline and --latency keep the cartridge's"
+            << " memory map.\n"
+            << "--coverage writes lcov line and branch coverage against the"
+            << " source in --debug;\npair it with --microcode-profile and"
+            << " microcode_dump --coverage for microcode.\n"
+            << "--trace-range, --trace-opcode (both repeatable), --trace-irq-only"
+            << " and --trace-every\nlimit what the crash trace buffer"
+            << " records.\n"
             << "\nLog level can also be set via IRATA2_LOG_LEVEL environment variable.\n";
 }
 
+// $hex, 0xhex or decimal.
+std::optional<irata2::base::Word> ParseAddress(const std::string& text) {
+  try {
+    size_t idx = 0;
+    unsigned long value = 0;
+    if (!text.empty() && text[0] == '$') {
+      value = std::stoul(text.substr(1), &idx, 16);
+      ++idx;
+    } else {
+      value = std::stoul(text, &idx, 0);
+    }
+    if (idx != text.size() || value > 0xFFFF) {
+      return std::nullopt;
+    }
+    return irata2::base::Word{static_cast<uint16_t>(value)};
+  } catch (const std::exception&) {
+    return std::nullopt;
+  }
+}
+
+// One event per line: CYCLE {press,down,up} VALUE, where press queues a
+// key code and down/up set and clear KEY_STATE bits. Cycles must not
+// decrease. Blank lines and # comments are skipped.
+std::vector<irata2::sim::io::HostInputEvent> LoadInputScript(
+    const std::string& path) {
+  using irata2::sim::io::HostInputEvent;
+  std::ifstream in(path);
+  if (!in) {
+    throw std::runtime_error("failed to open input script " + path);
+  }
+  std::vector<HostInputEvent> events;
+  std::string line;
+  for (int number = 1; std::getline(in, line); ++number) {
+    const std::string where = path + ":" + std::to_string(number);
+    line = line.substr(0, line.find('#'));
+    std::istringstream fields(line);
+    std::string cycle_text, kind_text, value_text, extra;
+    if (!(fields >> cycle_text)) {
+      continue;
+    }
+    if (!(fields >> kind_text >> value_text) || (fields >> extra)) {
+      throw std::runtime_error(where + ": expected CYCLE KIND VALUE");
+    }
+
+    HostInputEvent event;
+    try {
+      size_t idx = 0;
+      event.cycle = std::stoull(cycle_text, &idx, 0);
+      if (idx != cycle_text.size()) {
+        throw std::invalid_argument(cycle_text);
+      }
+    } catch (const std::exception&) {
+      throw std::runtime_error(where + ": invalid cycle '" + cycle_text + "'");
+    }
+    if (!events.empty() && event.cycle < events.back().cycle) {
+      throw std::runtime_error(where + ": cycles must not decrease");
+    }
+    if (kind_text == "press") {
+      event.kind = HostInputEvent::Kind::KeyPress;
+    } else if (kind_text == "down") {
+      event.kind = HostInputEvent::Kind::KeyDown;
+    } else if (kind_text == "up") {
+      event.kind = HostInputEvent::Kind::KeyUp;
+    } else {
+      throw std::runtime_error(where + ": unknown event '" + kind_text + "'");
+    }
+    const auto value = ParseAddress(value_text);
+    if (!value || value->value() > 0xFF) {
+      throw std::runtime_error(where + ": invalid value '" + value_text + "'");
+    }
+    event.value = static_cast<uint8_t>(value->value());
+    events.push_back(event);
+  }
+  return events;
+}
+
+// The input device's host ring holds only kHostEventCapacity events, so
+// post what fits and stop the run at the first event still waiting.
+irata2::sim::Cpu::RunResult RunWithInputScript(
+    irata2::sim::Cpu& cpu,
+    irata2::sim::io::InputDevice& input,
+    const std::vector<irata2::sim::io::HostInputEvent>& script,
+    std::optional<uint64_t> max_cycles) {
+  const uint64_t start = cpu.cycle_count();
+  size_t next = 0;
+  while (true) {
+    while (next < script.size() && input.PostHostEvent(script[next])) {
+      ++next;
+    }
+    irata2::sim::Cpu::StopConditions conditions;
+    if (max_cycles) {
+      conditions.max_cycles = *max_cycles - (cpu.cycle_count() - start);
+    }
+    bool paused = false;
+    if (next < script.size()) {
+      const uint64_t until =
+          std::max(script[next].cycle, cpu.cycle_count() + 1) -
+          cpu.cycle_count();
+      if (!conditions.max_cycles || until < *conditions.max_cycles) {
+        conditions.max_cycles = until;
+        paused = true;
+      }
+    }
+    const irata2::sim::Cpu::RunResult result = cpu.RunUntil(conditions);
+    if (!paused ||
+        result.reason != irata2::sim::Cpu::HaltReason::Timeout) {
+      return result;
+    }
+  }
+}
+
 std::optional<irata2::base::LogLevel> ParseLogLevel(const std::string& level_str) {
   if (level_str == "info") return irata2::base::LogLevel::kInfo;
   if (level_str == "warning") return irata2::base::LogLevel::kWarning;
@@ -46,6 +207,19 @@ int main(int argc, char** argv) {
   int64_t max_cycles = -1;
   int64_t trace_depth = -1;
   std::string debug_path;
+  std::string wav_path;
+  std::string profile_path;
+  std::string timeline_path;
+  std::string microcode_profile_path;
+  int64_t frame_budget_cycles = -1;
+  std::string frame_csv_path;
+  std::string coverage_path;
+  bool print_perf = false;
+  bool print_latency = false;
+  std::string input_script_path;
+  bool headless_devices = false;
+  std::string trace_out_path;
+  irata2::sim::DebugTraceFilter trace_filter;
   std::string cartridge_path;
 
   for (int i = 1; i < argc; ++i) {
@@ -70,6 +244,137 @@ int main(int argc, char** argv) {
       debug_path = argv[++i];
       continue;
     }
+    if (arg == "--wav") {
+      if (i + 1 >= argc) {
+        PrintUsage(argv[0]);
+        return 1;
+      }
+      wav_path = argv[++i];
+      continue;
+    }
+    if (arg == "--profile") {
+      if (i + 1 >= argc) {
+        PrintUsage(argv[0]);
+        return 1;
+      }
+      profile_path = argv[++i];
+      continue;
+    }
+    if (arg == "--timeline") {
+      if (i + 1 >= argc) {
+        PrintUsage(argv[0]);
+        return 1;
+      }
+      timeline_path = argv[++i];
+      continue;
+    }
+    if (arg == "--frame-budget") {
+      if (i + 1 >= argc) {
+        PrintUsage(argv[0]);
+        return 1;
+      }
+      frame_budget_cycles = std::stoll(argv[++i]);
+      if (frame_budget_cycles <= 0) {
+        PrintUsage(argv[0]);
+        return 1;
+      }
+      continue;
+    }
+    if (arg == "--frame-csv") {
+      if (i + 1 >= argc) {
+        PrintUsage(argv[0]);
+        return 1;
+      }
+      frame_csv_path = argv[++i];
+      continue;
+    }
+    if (arg == "--coverage") {
+      if (i + 1 >= argc) {
+        PrintUsage(argv[0]);
+        return 1;
+      }
+      coverage_path = argv[++i];
+      continue;
+    }
+    if (arg == "--microcode-profile") {
+      if (i + 1 >= argc) {
+        PrintUsage(argv[0]);
+        return 1;
+      }
+      microcode_profile_path = argv[++i];
+      continue;
+    }
+    if (arg == "--trace-out") {
+      if (i + 1 >= argc) {
+        PrintUsage(argv[0]);
+        return 1;
+      }
+      trace_out_path = argv[++i];
+      continue;
+    }
+    if (arg == "--trace-range") {
+      if (i + 1 >= argc) {
+        PrintUsage(argv[0]);
+        return 1;
+      }
+      const std::string range = argv[++i];
+      const auto colon = range.find(':');
+      const auto first = ParseAddress(range.substr(0, colon));
+      const auto last = colon == std::string::npos
+                            ? first
+                            : ParseAddress(range.substr(colon + 1));
+      if (!first || !last) {
+        std::cerr << "Error: Invalid trace range '" << range << "'\n";
+        return 1;
+      }
+      trace_filter.address_ranges.push_back({*first, *last});
+      continue;
+    }
+    if (arg == "--trace-opcode") {
+      if (i + 1 >= argc) {
+        PrintUsage(argv[0]);
+        return 1;
+      }
+      const auto opcode = ParseAddress(argv[++i]);
+      if (!opcode || opcode->value() > 0xFF) {
+        std::cerr << "Error: Invalid opcode '" << argv[i] << "'\n";
+        return 1;
+      }
+      trace_filter.opcodes.set(opcode->value());
+      continue;
+    }
+    if (arg == "--trace-irq-only") {
+      trace_filter.irq_only = true;
+      continue;
+    }
+    if (arg == "--trace-every") {
+      if (i + 1 >= argc) {
+        PrintUsage(argv[0]);
+        return 1;
+      }
+      trace_filter.every_nth = static_cast<uint32_t>(std::stoul(argv[++i]));
+      continue;
+    }
+    if (arg == "--perf") {
+      print_perf = true;
+      continue;
+    }
+    if (arg == "--latency") {
+      print_latency = true;
+      continue;
+    }
+    if (arg == "--headless-devices") {
+      headless_devices = true;
+      continue;
+    }
+    if (arg == "--input-script") {
+      if (i + 1 >= argc) {
+        PrintUsage(argv[0]);
+        return 1;
+      }
+      input_script_path = argv[++i];
+      continue;
+    }
     if (arg == "--trace-depth") {
       if (i + 1 >= argc) {
         PrintUsage(argv[0]);
@@ -101,7 +406,9 @@ int main(int argc, char** argv) {
     return 1;
   }
 
-  if (cartridge_path.empty()) {
+  if (cartridge_path.empty() ||
+      (!frame_csv_path.empty() && frame_budget_cycles < 0) ||
+      (!coverage_path.empty() && debug_path.empty())) {
     PrintUsage(argv[0]);
     return 1;
   }
@@ -109,10 +416,76 @@ int main(int argc, char** argv) {
   try {
     irata2::sim::LoadedCartridge cartridge =
         irata2::sim::LoadCartridge(cartridge_path);
+    std::vector<irata2::sim::io::HostInputEvent> input_script;
+    if (!input_script_path.empty()) {
+      input_script = LoadInputScript(input_script_path);
+    }
+
+    // With --wav, map the sound device and record what it plays.
+    std::vector<irata2::sim::memory::Memory::RegionFactory> factories;
+    irata2::sim::io::SoundDevice* sound = nullptr;
+    irata2::sim::io::WavSoundBackend* wav = nullptr;
+    if (!wav_path.empty()) {
+      factories.push_back([&](irata2::sim::memory::Memory& mem,
+                              irata2::sim::LatchedProcessControl&) {
+        return std::make_unique<irata2::sim::memory::Region>(
+            "sound", mem, irata2::base::Word{irata2::sim::io::SOUND_BASE},
+            [&](irata2::sim::memory::Region& region)
+                -> std::unique_ptr<irata2::sim::memory::Module> {
+              const irata2::sim::io::SoundConfig config;
+              auto backend = std::make_unique<irata2::sim::io::WavSoundBackend>(
+                  wav_path, config.sample_rate);
+              wav = backend.get();
+              auto device = std::make_unique<irata2::sim::io::SoundDevice>(
+                  "sound", region, std::move(backend), config);
+              sound = device.get();
+              return device;
+            });
+      });
+    }
+
+    // --headless-devices maps the devices an interactive cartridge expects
+    // so it runs headless: the VGC rendering off screen and an input device
+    // fed only by --input-script. The options that cannot work without them
+    // imply it; pure observers leave the memory map alone so they measure
+    // the same machine as a plain run.
+    irata2::sim::io::VectorGraphicsCoprocessor* vgc = nullptr;
+    irata2::sim::io::InputDevice* input = nullptr;
+    if (headless_devices || frame_budget_cycles > 0 ||
+        !input_script_path.empty()) {
+      factories.push_back([&](irata2::sim::memory::Memory& mem,
+                              irata2::sim::LatchedProcessControl& irq_line) {
+        return std::make_unique<irata2::sim::memory::Region>(
+            "input_device", mem,
+            irata2::base::Word{irata2::sim::io::INPUT_DEVICE_BASE},
+            [&](irata2::sim::memory::Region& region)
+                -> std::unique_ptr<irata2::sim::memory::Module> {
+              auto device = std::make_unique<irata2::sim::io::InputDevice>(
+                  "input", region, irq_line);
+              input = device.get();
+              return device;
+            });
+      });
+      factories.push_back([&](irata2::sim::memory::Memory& mem,
+                              irata2::sim::LatchedProcessControl&) {
+        return std::make_unique<irata2::sim::memory::Region>(
+            "vgc", mem, irata2::base::Word{irata2::sim::io::VGC_BASE},
+            [&](irata2::sim::memory::Region& region)
+                -> std::unique_ptr<irata2::sim::memory::Module> {
+              auto device =
+                  std::make_unique<irata2::sim::io::VectorGraphicsCoprocessor>(
+                      "vgc", region,
+                      std::make_unique<irata2::sim::io::ImageBackend>());
+              vgc = device.get();
+              return device;
+            });
+      });
+    }
 
     irata2::sim::Cpu cpu(irata2::sim::DefaultHdl(),
                          irata2::sim::DefaultMicrocodeProgram(),
-                         std::move(cartridge.rom));
+                         std::move(cartridge.rom),
+                         std::move(factories));
     cpu.pc().set_value(cartridge.header.entry);
     cpu.controller().sc().set_value(irata2::base::Byte{0});
     cpu.controller().ir().set_value(cpu.memory().ReadAt(cartridge.header.entry));
@@ -123,6 +496,55 @@ int main(int argc, char** argv) {
     } else if (trace_depth >= 0) {
       cpu.EnableTrace(static_cast<size_t>(trace_depth));
     }
+    cpu.SetTraceFilter(trace_filter);
+    cpu.set_latency_tracking(print_latency);
+
+    std::unique_ptr<irata2::sim::GuestProfiler> profiler;
+    if (!profile_path.empty()) {
+      profiler = std::make_unique<irata2::sim::GuestProfiler>();
+      profiler->SetSymbols(cpu.debug_symbols());
+      cpu.AttachProfiler(profiler.get());
+    }
+
+    std::unique_ptr<irata2::sim::GuestTimeline> timeline;
+    if (!timeline_path.empty()) {
+      timeline = std::make_unique<irata2::sim::GuestTimeline>();
+      timeline->SetSymbols(cpu.debug_symbols());
+      cpu.AttachTimeline(timeline.get());
+    }
+
+    std::unique_ptr<irata2::sim::GuestCoverage> coverage;
+    if (!coverage_path.empty()) {
+      coverage = std::make_unique<irata2::sim::GuestCoverage>();
+      cpu.AttachCoverage(coverage.get());
+    }
+
+    std::unique_ptr<irata2::sim::FrameBudget> frame_budget;
+    if (frame_budget_cycles > 0) {
+      frame_budget = std::make_unique<irata2::sim::FrameBudget>(
+          static_cast<uint64_t>(frame_budget_cycles));
+      frame_budget->SetSymbols(cpu.debug_symbols());
+      frame_budget->AttachVgc(vgc);
+      cpu.AttachFrameBudget(frame_budget.get());
+    }
+
+    irata2::microcode::debug::MicrocodeProfile microcode_profile;
+    if (!microcode_profile_path.empty()) {
+      cpu.controller().set_microcode_profile(&microcode_profile);
+    }
+
+    std::ofstream trace_out;
+    std::unique_ptr<irata2::sim::TraceStreamWriter> trace_writer;
+    if (!trace_out_path.empty()) {
+      trace_out.open(trace_out_path, std::ios::binary);
+      if (!trace_out) {
+        std::cerr << "Error: failed to open trace " << trace_out_path << "\n";
+        return 1;
+      }
+      trace_writer =
+          std::make_unique<irata2::sim::TraceStreamWriter>(trace_out);
+      cpu.AttachTraceWriter(trace_writer.get());
+    }
 
     // Log sim.start
     IRATA2_LOG_INFO << "sim.start: cartridge=" << cartridge_path
@@ -132,7 +554,12 @@ int main(int argc, char** argv) {
 
     irata2::sim::Cpu::RunResult result;
     bool timed_out = false;
-    if (max_cycles < 0) {
+    if (!input_script.empty()) {
+      result = RunWithInputScript(
+          cpu, *input, input_script,
+          max_cycles < 0 ? std::nullopt
+                         : std::optional<uint64_t>(max_cycles));
+    } else if (max_cycles < 0) {
       result = cpu.RunUntilHalt();
     } else {
       result = cpu.RunUntilHalt(static_cast<uint64_t>(max_cycles));
@@ -140,6 +567,119 @@ int main(int argc, char** argv) {
 
     timed_out = (result.reason == irata2::sim::Cpu::HaltReason::Timeout);
 
+    if (sound != nullptr) {
+      sound->Sync();
+      wav->Close();
+    }
+
+    if (trace_writer) {
+      cpu.AttachTraceWriter(nullptr);
+      trace_writer->Close();
+      IRATA2_LOG_INFO << "sim.trace: records="
+                      << trace_writer->records_appended()
+                      << ", bytes=" << trace_writer->bytes_written()
+                      << ", path=" << trace_out_path;
+    }
+
+    if (profiler) {
+      std::filesystem::path path(profile_path);
+      std::ofstream json(path);
+      path.replace_extension(".folded");
+      std::ofstream folded(path);
+      path.replace_extension(".lst");
+      std::ofstream listing(path);
+      if (!json || !folded || !listing) {
+        std::cerr << "Error: failed to write profile " << profile_path << "\n";
+        return 1;
+      }
+      profiler->WriteJson(json, cpu.frames_presented());
+      profiler->WriteCollapsedStacks(folded);
+      profiler->WriteAnnotatedListing(listing);
+      IRATA2_LOG_INFO << "sim.profile: cycles=" << profiler->total_cycles()
+                      << ", path=" << profile_path;
+    }
+
+    if (timeline) {
+      std::ofstream out(timeline_path);
+      if (!out) {
+        std::cerr << "Error: failed to write timeline " << timeline_path
+                  << "\n";
+        return 1;
+      }
+      timeline->WriteChromeTrace(out);
+      IRATA2_LOG_INFO << "sim.timeline: events=" << timeline->event_count()
+                      << ", dropped=" << timeline->dropped_events()
+                      << ", path=" << timeline_path;
+    }
+
+    if (coverage) {
+      std::ofstream out(coverage_path);
+      if (!out) {
+        std::cerr << "Error: failed to write coverage " << coverage_path
+                  << "\n";
+        return 1;
+      }
+      coverage->WriteLcov(out, *cpu.debug_symbols(),
+                          std::filesystem::path(cartridge_path).stem().string());
+      IRATA2_LOG_INFO << "sim.coverage: instructions="
+                      << coverage->executed_count()
+                      << ", branches=" << coverage->branches().size()
+                      << ", path=" << coverage_path;
+    }
+
+    if (frame_budget) {
+      if (!frame_csv_path.empty()) {
+        std::ofstream out(frame_csv_path);
+        if (!out) {
+          std::cerr << "Error: failed to write frame CSV " << frame_csv_path
+                    << "\n";
+          return 1;
+        }
+        frame_budget->WriteCsv(out);
+      }
+      frame_budget->WriteText(std::cout);
+      const irata2::sim::LatencyHistogram& frame_cycles =
+          frame_budget->frame_cycles();
+      IRATA2_LOG_INFO << "sim.frames: frames=" << frame_cycles.count()
+                      << ", budget=" << frame_budget->cycles_per_frame()
+                      << ", overruns=" << frame_budget->overruns()
+                      << ", p50=" << frame_cycles.Percentile(0.5)
+                      << ", max=" << frame_cycles.max();
+    }
+
+    if (!microcode_profile_path.empty()) {
+      std::ofstream out(microcode_profile_path);
+      if (!out) {
+        std::cerr << "Error: failed to write microcode profile "
+                  << microcode_profile_path << "\n";
+        return 1;
+      }
+      microcode_profile.Write(out);
+    }
+
+    const irata2::sim::PerfCounters perf = cpu.perf_counters();
+    IRATA2_LOG_INFO << "sim.perf: instructions=" << perf.instructions
+                    << ", cpi=" << perf.cycles_per_instruction()
+                    << ", memory_reads=" << perf.memory_reads()
+                    << ", memory_writes=" << perf.memory_writes()
+                    << ", mmio_accesses=" << perf.mmio_accesses()
+                    << ", irqs_taken=" << perf.irqs_taken;
+    if (print_perf) {
+      perf.WriteText(std::cout);
+    }
+    const irata2::sim::LatencyStats& latency = cpu.latency_stats();
+    if (latency.irq_entry.count() != 0) {
+      IRATA2_LOG_INFO << "sim.latency: irqs=" << latency.irq_entry.count()
+                      << ", irq_entry_p50=" << latency.irq_entry.Percentile(0.5)
+                      << ", irq_entry_max=" << latency.irq_entry.max()
+                      << ", irq_handler_p50="
+                      << latency.irq_handler.Percentile(0.5)
+                      << ", irq_handler_max=" << latency.irq_handler.max();
+    }
+    if (print_latency) {
+      latency.WriteText(std::cout);
+    }
+
     // Log lifecycle events
     if (timed_out) {
       IRATA2_LOG_INFO << "sim.timeout: max_cycles=" << max_cycles
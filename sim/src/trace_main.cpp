@@ -0,0 +1,339 @@
+#include "irata2/sim/trace_stream.h"
+
+#include <cstdint>
+#include <deque>
+#include <fstream>
+#include <iostream>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include <fmt/format.h>
+
+#include "irata2/isa/isa.h"
+
+namespace {
+using irata2::sim::TraceRecord;
+using irata2::sim::TraceStreamReader;
+
+void PrintUsage(const char* argv0) {
+  std::cerr
+      << "Usage: " << argv0 << " <command> [options] <trace.i2t> [trace.i2t]\n"
+      << "\nCommands:\n"
+      << "  dump    print records, optionally filtered\n"
+      << "  search  print records matching the filters with the instruction"
+      << " that made them\n"
+      << "  diff    report the first record where two traces diverge"
+      << " (exit status 2)\n"
+      << "  stats   summarize a trace\n"
+      << "\nFilters (dump, search):\n"
+      << "  --cycles FROM:TO     cycle range, inclusive\n"
+      << "  --address LO[:HI]    instruction or accessed address range\n"
+      << "  --kind {all,inst,read,write,access}\n"
+      << "  --value V            opcode or data byte\n"
+      << "  --limit N            stop after N matches (search default 10)\n"
+      << "\ndiff options:\n"
+      << "  --context N          records to show before the divergence"
+      << " (default 5)\n"
+      << "\nAddresses and values accept $hex, 0xhex or decimal.\n";
+}
+
+std::optional<uint64_t> ParseNumber(const std::string& text) {
+  try {
+    size_t idx = 0;
+    uint64_t value = 0;
+    if (!text.empty() && text[0] == '$') {
+      value = std::stoull(text.substr(1), &idx, 16);
+      ++idx;
+    } else {
+      value = std::stoull(text, &idx, 0);
+    }
+    if (idx != text.size()) {
+      return std::nullopt;
+    }
+    return value;
+  } catch (const std::exception&) {
+    return std::nullopt;
+  }
+}
+
+/// "LO:HI" or a single value, inclusive.
+std::optional<std::pair<uint64_t, uint64_t>> ParseRange(
+    const std::string& text) {
+  const auto colon = text.find(':');
+  const auto lo = ParseNumber(text.substr(0, colon));
+  if (!lo) {
+    return std::nullopt;
+  }
+  if (colon == std::string::npos) {
+    return std::make_pair(*lo, *lo);
+  }
+  const auto hi = ParseNumber(text.substr(colon + 1));
+  if (!hi || *hi < *lo) {
+    return std::nullopt;
+  }
+  return std::make_pair(*lo, *hi);
+}
+
+struct Filter {
+  std::optional<std::pair<uint64_t, uint64_t>> cycles;
+  std::optional<std::pair<uint64_t, uint64_t>> addresses;
+  std::string kind = "all";
+  std::optional<uint8_t> value;
+  uint64_t limit = 0;
+
+  bool Matches(const TraceRecord& record) const {
+    if (cycles && (record.cycle < cycles->first ||
+                   record.cycle > cycles->second)) {
+      return false;
+    }
+    const uint16_t address = record.address.value();
+    if (addresses && (address < addresses->first ||
+                      address > addresses->second)) {
+      return false;
+    }
+    if (value && record.value.value() != *value) {
+      return false;
+    }
+    switch (record.kind) {
+      case TraceRecord::Kind::Instruction:
+        return kind == "all" || kind == "inst";
+      case TraceRecord::Kind::Read:
+        return kind == "all" || kind == "read" || kind == "access";
+      case TraceRecord::Kind::Write:
+        return kind == "all" || kind == "write" || kind == "access";
+    }
+    return false;
+  }
+};
+
+std::string Format(const TraceRecord& record) {
+  if (record.kind != TraceRecord::Kind::Instruction) {
+    return fmt::format(
+        "{:>10}    {:<5} ${:04X} = ${:02X}", record.cycle,
+        record.kind == TraceRecord::Kind::Read ? "read" : "write",
+        record.address.value(), record.value.value());
+  }
+  const auto info = irata2::isa::IsaInfo::GetInstruction(record.value.value());
+  const std::string mnemonic = info ? std::string(info->mnemonic) : "???";
+  return fmt::format(
+      "{:>10}  ${:04X}  {:02X} {:<4} A={:02X} X={:02X} Y={:02X} SP={:02X} "
+      "P={:02X}",
+      record.cycle, record.address.value(), record.value.value(), mnemonic,
+      record.a.value(), record.x.value(), record.y.value(), record.sp.value(),
+      record.status.value());
+}
+
+bool SameRecord(const TraceRecord& a, const TraceRecord& b) {
+  if (a.kind != b.kind || a.cycle != b.cycle || a.address != b.address ||
+      a.value != b.value) {
+    return false;
+  }
+  if (a.kind != TraceRecord::Kind::Instruction) {
+    return true;
+  }
+  return a.a == b.a && a.x == b.x && a.y == b.y && a.sp == b.sp &&
+         a.status == b.status;
+}
+
+int Dump(TraceStreamReader& reader, const Filter& filter, bool search) {
+  uint64_t index = 0;
+  uint64_t matches = 0;
+  std::optional<TraceRecord> instruction;
+  while (auto record = reader.Next()) {
+    if (record->kind == TraceRecord::Kind::Instruction) {
+      instruction = record;
+    }
+    if (filter.Matches(*record)) {
+      ++matches;
+      if (filter.limit == 0 || matches <= filter.limit) {
+        std::cout << fmt::format("#{:<9} ", index) << Format(*record) << "\n";
+        if (search && record->kind != TraceRecord::Kind::Instruction &&
+            instruction) {
+          std::cout << "           by " << Format(*instruction) << "\n";
+        }
+      }
+    }
+    ++index;
+  }
+  if (search) {
+    std::cout << "matches: " << matches << "\n";
+  }
+  return 0;
+}
+
+int Diff(TraceStreamReader& left, TraceStreamReader& right, size_t context) {
+  std::deque<TraceRecord> history;
+  uint64_t index = 0;
+  while (true) {
+    auto a = left.Next();
+    auto b = right.Next();
+    if (!a && !b) {
+      std::cout << "traces are identical (" << index << " records)\n";
+      return 0;
+    }
+    if (a && b && SameRecord(*a, *b)) {
+      history.push_back(*a);
+      if (history.size() > context) {
+        history.pop_front();
+      }
+      ++index;
+      continue;
+    }
+    std::cout << "traces diverge at record #" << index << "\n";
+    for (const auto& record : history) {
+      std::cout << "  " << Format(record) << "\n";
+    }
+    std::cout << "- " << (a ? Format(*a) : std::string("<end of trace>"))
+              << "\n";
+    std::cout << "+ " << (b ? Format(*b) : std::string("<end of trace>"))
+              << "\n";
+    return 2;
+  }
+}
+
+int Stats(TraceStreamReader& reader) {
+  uint64_t instructions = 0;
+  uint64_t reads = 0;
+  uint64_t writes = 0;
+  std::optional<uint64_t> first_cycle;
+  uint64_t last_cycle = 0;
+  while (auto record = reader.Next()) {
+    switch (record->kind) {
+      case TraceRecord::Kind::Instruction:
+        ++instructions;
+        break;
+      case TraceRecord::Kind::Read:
+        ++reads;
+        break;
+      case TraceRecord::Kind::Write:
+        ++writes;
+        break;
+    }
+    if (!first_cycle) {
+      first_cycle = record->cycle;
+    }
+    last_cycle = record->cycle;
+  }
+  std::cout << "instructions: " << instructions << "\n"
+            << "reads: " << reads << "\n"
+            << "writes: " << writes << "\n"
+            << "cycles: " << first_cycle.value_or(0) << ".." << last_cycle
+            << "\n";
+  return 0;
+}
+}  // namespace
+
+int main(int argc, char** argv) {
+  if (argc < 2) {
+    PrintUsage(argv[0]);
+    return 1;
+  }
+  const std::string command = argv[1];
+  if (command != "dump" && command != "search" && command != "diff" &&
+      command != "stats") {
+    PrintUsage(argv[0]);
+    return 1;
+  }
+
+  Filter filter;
+  if (command == "search") {
+    filter.limit = 10;
+  }
+  size_t context = 5;
+  std::vector<std::string> paths;
+
+  for (int i = 2; i < argc; ++i) {
+    std::string arg = argv[i];
+    const bool has_value = i + 1 < argc;
+    if (arg == "--cycles" && has_value) {
+      filter.cycles = ParseRange(argv[++i]);
+      if (!filter.cycles) {
+        std::cerr << "Invalid cycle range\n";
+        return 1;
+      }
+      continue;
+    }
+    if (arg == "--address" && has_value) {
+      filter.addresses = ParseRange(argv[++i]);
+      if (!filter.addresses || filter.addresses->second > 0xFFFF) {
+        std::cerr << "Invalid address range\n";
+        return 1;
+      }
+      continue;
+    }
+    if (arg == "--kind" && has_value) {
+      filter.kind = argv[++i];
+      if (filter.kind != "all" && filter.kind != "inst" &&
+          filter.kind != "read" && filter.kind != "write" &&
+          filter.kind != "access") {
+        std::cerr << "Unknown kind: " << filter.kind << "\n";
+        return 1;
+      }
+      continue;
+    }
+    if (arg == "--value" && has_value) {
+      const auto value = ParseNumber(argv[++i]);
+      if (!value || *value > 0xFF) {
+        std::cerr << "Invalid value\n";
+        return 1;
+      }
+      filter.value = static_cast<uint8_t>(*value);
+      continue;
+    }
+    if (arg == "--limit" && has_value) {
+      const auto limit = ParseNumber(argv[++i]);
+      if (!limit) {
+        std::cerr << "Invalid limit\n";
+        return 1;
+      }
+      filter.limit = *limit;
+      continue;
+    }
+    if (arg == "--context" && has_value) {
+      const auto value = ParseNumber(argv[++i]);
+      if (!value) {
+        std::cerr << "Invalid context\n";
+        return 1;
+      }
+      context = static_cast<size_t>(*value);
+      continue;
+    }
+    if (!arg.empty() && arg[0] == '-') {
+      PrintUsage(argv[0]);
+      return 1;
+    }
+    paths.push_back(arg);
+  }
+
+  const size_t expected_paths = command == "diff" ? 2 : 1;
+  if (paths.size() != expected_paths) {
+    PrintUsage(argv[0]);
+    return 1;
+  }
+
+  try {
+    std::ifstream first(paths[0], std::ios::binary);
+    if (!first) {
+      std::cerr << "Error: failed to open " << paths[0] << "\n";
+      return 1;
+    }
+    TraceStreamReader reader(first);
+    if (command == "diff") {
+      std::ifstream second(paths[1], std::ios::binary);
+      if (!second) {
+        std::cerr << "Error: failed to open " << paths[1] << "\n";
+        return 1;
+      }
+      TraceStreamReader other(second);
+      return Diff(reader, other, context);
+    }
+    if (command == "stats") {
+      return Stats(reader);
+    }
+    return Dump(reader, filter, command == "search");
+  } catch (const std::exception& error) {
+    std::cerr << "Error: " << error.what() << "\n";
+    return 1;
+  }
+}
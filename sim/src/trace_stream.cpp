@@ -0,0 +1,225 @@
+#include "irata2/sim/trace_stream.h"
+
+#include <chrono>
+#include <span>
+
+#include "irata2/sim/error.h"
+#include "irata2/sim/varint.h"
+
+namespace irata2::sim {
+
+namespace {
+constexpr uint8_t kKindMask = 0x03;
+constexpr uint8_t kRegisterShift = 2;
+constexpr size_t kRegisterCount = 5;
+constexpr size_t kBatchSize = 256;
+
+std::array<base::Byte*, kRegisterCount> Registers(TraceRecord& record) {
+  return {&record.a, &record.x, &record.y, &record.sp, &record.status};
+}
+
+std::array<const base::Byte*, kRegisterCount> Registers(
+    const TraceRecord& record) {
+  return {&record.a, &record.x, &record.y, &record.sp, &record.status};
+}
+}  // namespace
+
+TraceStreamWriter::TraceStreamWriter(std::ostream& out) : out_(out) {
+  buffer_.reserve(kFlushThreshold + 64);
+  buffer_.insert(buffer_.end(), trace_stream::kMagic.begin(),
+                 trace_stream::kMagic.end());
+  buffer_.push_back(static_cast<uint8_t>(trace_stream::kVersion & 0xFF));
+  buffer_.push_back(static_cast<uint8_t>(trace_stream::kVersion >> 8));
+  buffer_.push_back(0);
+  buffer_.push_back(0);
+  WriteBuffer();
+  thread_ = std::thread([this] { Run(); });
+}
+
+TraceStreamWriter::~TraceStreamWriter() {
+  try {
+    Close();
+  } catch (const SimError&) {
+    // Nowhere to report it; callers that care close explicitly.
+  }
+}
+
+void TraceStreamWriter::Append(const TraceRecord& record) {
+  if (closed_) {
+    return;
+  }
+  while (!queue_.TryPush(record)) {
+    std::this_thread::yield();
+  }
+  ++records_appended_;
+}
+
+void TraceStreamWriter::Close() {
+  if (closed_) {
+    return;
+  }
+  closed_ = true;
+  closing_.store(true, std::memory_order_release);
+  thread_.join();
+  if (failed_.load(std::memory_order_relaxed)) {
+    throw SimError("failed to write execution trace");
+  }
+}
+
+void TraceStreamWriter::Run() {
+  std::array<TraceRecord, kBatchSize> batch;
+  while (true) {
+    // Read the flag first: once it is set, every record appended before
+    // Close() is visible to the pops below.
+    const bool closing = closing_.load(std::memory_order_acquire);
+    const size_t count = queue_.PopSome(std::span<TraceRecord>(batch));
+    for (size_t i = 0; i < count; ++i) {
+      Encode(batch[i]);
+    }
+    if (buffer_.size() >= kFlushThreshold) {
+      WriteBuffer();
+    }
+    if (count == 0) {
+      if (closing) {
+        break;
+      }
+      std::this_thread::sleep_for(std::chrono::microseconds(100));
+    }
+  }
+  WriteBuffer();
+  out_.flush();
+  if (!out_) {
+    failed_.store(true, std::memory_order_relaxed);
+  }
+}
+
+void TraceStreamWriter::Encode(const TraceRecord& record) {
+  uint8_t tag = static_cast<uint8_t>(record.kind);
+  uint8_t changed = 0;
+  if (record.kind == TraceRecord::Kind::Instruction) {
+    const auto current = Registers(record);
+    const auto previous = Registers(last_instruction_);
+    for (size_t i = 0; i < kRegisterCount; ++i) {
+      if (*current[i] != *previous[i]) {
+        changed = static_cast<uint8_t>(changed | (1u << i));
+      }
+    }
+    tag = static_cast<uint8_t>(tag | (changed << kRegisterShift));
+  }
+  buffer_.push_back(tag);
+  varint::Put(buffer_, varint::ZigZag(
+                           static_cast<int64_t>(record.cycle - last_cycle_)));
+  last_cycle_ = record.cycle;
+
+  const uint16_t address = record.address.value();
+  if (record.kind == TraceRecord::Kind::Instruction) {
+    varint::Put(buffer_,
+                varint::ZigZag(static_cast<int64_t>(address) -
+                               last_instruction_.address.value()));
+    buffer_.push_back(record.value.value());
+    const auto current = Registers(record);
+    for (size_t i = 0; i < kRegisterCount; ++i) {
+      if (changed & (1u << i)) {
+        buffer_.push_back(current[i]->value());
+      }
+    }
+    last_instruction_ = record;
+  } else {
+    varint::Put(buffer_, varint::ZigZag(static_cast<int64_t>(address) -
+                                        last_access_address_));
+    buffer_.push_back(record.value.value());
+    last_access_address_ = address;
+  }
+}
+
+void TraceStreamWriter::WriteBuffer() {
+  if (buffer_.empty()) {
+    return;
+  }
+  out_.write(reinterpret_cast<const char*>(buffer_.data()),
+             static_cast<std::streamsize>(buffer_.size()));
+  if (!out_) {
+    failed_.store(true, std::memory_order_relaxed);
+  }
+  bytes_written_.fetch_add(buffer_.size(), std::memory_order_relaxed);
+  buffer_.clear();
+}
+
+TraceStreamReader::TraceStreamReader(std::istream& in) : in_(in) {
+  std::array<uint8_t, trace_stream::kHeaderSize> header{};
+  in_.read(reinterpret_cast<char*>(header.data()),
+           static_cast<std::streamsize>(header.size()));
+  if (in_.gcount() != static_cast<std::streamsize>(header.size())) {
+    throw SimError("execution trace header truncated");
+  }
+  for (size_t i = 0; i < trace_stream::kMagic.size(); ++i) {
+    if (static_cast<char>(header[i]) != trace_stream::kMagic[i]) {
+      throw SimError("execution trace magic mismatch");
+    }
+  }
+  const uint16_t version = static_cast<uint16_t>(
+      header[4] | (static_cast<uint16_t>(header[5]) << 8));
+  if (version != trace_stream::kVersion) {
+    throw SimError("unsupported execution trace version " +
+                   std::to_string(version));
+  }
+}
+
+std::optional<TraceRecord> TraceStreamReader::Next() {
+  if (in_.peek() == std::char_traits<char>::eof()) {
+    return std::nullopt;
+  }
+  const uint8_t tag = ReadByte();
+  const uint8_t kind = tag & kKindMask;
+  if (kind > static_cast<uint8_t>(TraceRecord::Kind::Write)) {
+    throw SimError("execution trace record has an unknown kind");
+  }
+  if ((tag & 0x80) ||
+      (kind != 0 && (tag >> kRegisterShift) != 0)) {
+    throw SimError("execution trace record has reserved tag bits set");
+  }
+  cycle_ += static_cast<uint64_t>(varint::UnZigZag(ReadVarint()));
+
+  TraceRecord record;
+  record.kind = static_cast<TraceRecord::Kind>(kind);
+  record.cycle = cycle_;
+  if (record.kind == TraceRecord::Kind::Instruction) {
+    const int64_t delta = varint::UnZigZag(ReadVarint());
+    record = last_instruction_;
+    record.kind = TraceRecord::Kind::Instruction;
+    record.cycle = cycle_;
+    record.address = base::Word{static_cast<uint16_t>(
+        last_instruction_.address.value() + delta)};
+    record.value = base::Byte{ReadByte()};
+    const uint8_t changed = static_cast<uint8_t>(tag >> kRegisterShift);
+    const auto registers = Registers(record);
+    for (size_t i = 0; i < kRegisterCount; ++i) {
+      if (changed & (1u << i)) {
+        *registers[i] = base::Byte{ReadByte()};
+      }
+    }
+    last_instruction_ = record;
+  } else {
+    const int64_t delta = varint::UnZigZag(ReadVarint());
+    last_access_address_ =
+        static_cast<uint16_t>(last_access_address_ + delta);
+    record.address = base::Word{last_access_address_};
+    record.value = base::Byte{ReadByte()};
+  }
+  return record;
+}
+
+uint8_t TraceStreamReader::ReadByte() {
+  const int value = in_.get();
+  if (value == std::char_traits<char>::eof()) {
+    throw SimError("execution trace truncated");
+  }
+  return static_cast<uint8_t>(value);
+}
+
+uint64_t TraceStreamReader::ReadVarint() {
+  return varint::Read([this] { return ReadByte(); },
+                      "execution trace varint too long");
+}
+
+}  // namespace irata2::sim
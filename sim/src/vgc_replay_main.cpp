@@ -0,0 +1,207 @@
+#include "irata2/sim/io/vgc_backend.h"
+#include "irata2/sim/io/vgc_capture.h"
+
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <memory>
+#include <optional>
+#include <span>
+#include <string>
+
+namespace {
+void PrintUsage(const char* argv0) {
+  std::cerr << "Usage: " << argv0
+            << " [--frames N] [--backend {null,image,raster}] [--hashes]"
+            << " [--dump-frames DIR] <capture.vgc>\n"
+            << "\nReplays a VGC capture without running the CPU.\n"
+            << "  null    decode only\n"
+            << "  image   record into an ImageBackend, rasterize at the end"
+            << " (default)\n"
+            << "  raster  rasterize every frame\n"
+            << "\n--dump-frames writes each presented frame to"
+            << " DIR/frame_NNNNNN.pgm.\n";
+}
+
+std::optional<int64_t> ParseI64(const std::string& value) {
+  try {
+    size_t idx = 0;
+    int64_t parsed = std::stoll(value, &idx);
+    if (idx != value.size()) {
+      return std::nullopt;
+    }
+    return parsed;
+  } catch (const std::exception&) {
+    return std::nullopt;
+  }
+}
+
+/// Discards everything, so a replay measures decoding alone.
+class NullBackend final : public irata2::sim::io::VgcBackend {
+ public:
+  void clear(uint8_t) override {}
+  void draw_point(uint8_t, uint8_t, uint8_t) override {}
+  void draw_line(uint8_t, uint8_t, uint8_t, uint8_t, uint8_t) override {}
+  void present() override {}
+  void submit(std::span<const irata2::sim::io::VgcCommand>) override {}
+};
+
+/// Writes the framebuffer as a binary PGM, scaling the four VGC intensities
+/// to the full grey range.
+void WriteFramePgm(const std::filesystem::path& path,
+                   const irata2::sim::io::ImageBackend& image) {
+  using irata2::sim::io::ImageBackend;
+  std::ofstream out(path, std::ios::binary);
+  if (!out) {
+    throw std::runtime_error("failed to open " + path.string());
+  }
+  out << "P5\n" << ImageBackend::kWidth << " " << ImageBackend::kHeight
+      << "\n255\n";
+  std::string pixels;
+  pixels.reserve(ImageBackend::kWidth * ImageBackend::kHeight);
+  for (uint8_t intensity : image.framebuffer()) {
+    pixels.push_back(static_cast<char>((intensity & 0x03) * 85));
+  }
+  out.write(pixels.data(), static_cast<std::streamsize>(pixels.size()));
+  if (!out) {
+    throw std::runtime_error("failed to write " + path.string());
+  }
+}
+}  // namespace
+
+int main(int argc, char** argv) {
+  uint64_t max_frames = 0;
+  std::string backend_name = "image";
+  bool hashes = false;
+  std::string dump_dir;
+  std::string capture_path;
+
+  for (int i = 1; i < argc; ++i) {
+    std::string arg = argv[i];
+    if (arg == "--frames") {
+      if (i + 1 >= argc) {
+        PrintUsage(argv[0]);
+        return 1;
+      }
+      auto parsed = ParseI64(argv[++i]);
+      if (!parsed || *parsed < 0) {
+        std::cerr << "Invalid frame count\n";
+        return 1;
+      }
+      max_frames = static_cast<uint64_t>(*parsed);
+      continue;
+    }
+    if (arg == "--backend") {
+      if (i + 1 >= argc) {
+        PrintUsage(argv[0]);
+        return 1;
+      }
+      backend_name = argv[++i];
+      if (backend_name != "null" && backend_name != "image" &&
+          backend_name != "raster") {
+        std::cerr << "Unknown backend '" << backend_name << "'\n";
+        return 1;
+      }
+      continue;
+    }
+    if (arg == "--hashes") {
+      hashes = true;
+      continue;
+    }
+    if (arg == "--dump-frames") {
+      if (i + 1 >= argc) {
+        PrintUsage(argv[0]);
+        return 1;
+      }
+      dump_dir = argv[++i];
+      continue;
+    }
+    if (capture_path.empty()) {
+      capture_path = std::move(arg);
+      continue;
+    }
+    PrintUsage(argv[0]);
+    return 1;
+  }
+
+  if (capture_path.empty()) {
+    PrintUsage(argv[0]);
+    return 1;
+  }
+  if (hashes && backend_name == "null") {
+    std::cerr << "--hashes needs an image or raster backend\n";
+    return 1;
+  }
+  if (!dump_dir.empty() && backend_name == "null") {
+    std::cerr << "--dump-frames needs an image or raster backend\n";
+    return 1;
+  }
+
+  try {
+    auto reader = irata2::sim::io::VgcCaptureReader::FromFile(capture_path);
+
+    std::unique_ptr<irata2::sim::io::VgcBackend> backend;
+    irata2::sim::io::ImageBackend* image = nullptr;
+    if (backend_name == "null") {
+      backend = std::make_unique<NullBackend>();
+    } else {
+      auto image_backend = std::make_unique<irata2::sim::io::ImageBackend>();
+      if (backend_name == "raster") {
+        image_backend->set_rasterize_interval(1);
+      }
+      image = image_backend.get();
+      backend = std::move(image_backend);
+    }
+
+    if (!dump_dir.empty()) {
+      std::filesystem::create_directories(dump_dir);
+    }
+
+    std::function<void(uint64_t, uint64_t)> on_present;
+    if (hashes || !dump_dir.empty()) {
+      on_present = [image, hashes, &dump_dir](uint64_t frame, uint64_t cycle) {
+        if (hashes) {
+          std::cout << "frame " << frame << " cycle " << cycle << " hash "
+                    << std::hex << std::setw(16) << std::setfill('0')
+                    << image->stream_hash() << std::dec << "\n";
+        }
+        if (!dump_dir.empty()) {
+          std::ostringstream name;
+          name << "frame_" << std::setw(6) << std::setfill('0') << frame
+               << ".pgm";
+          WriteFramePgm(std::filesystem::path(dump_dir) / name.str(), *image);
+        }
+      };
+    }
+
+    const auto start = std::chrono::steady_clock::now();
+    const auto result = irata2::sim::io::ReplayVgcCapture(
+        reader, *backend, max_frames, on_present);
+    if (image) {
+      // Force any deferred rasterization into the measurement.
+      image->framebuffer();
+    }
+    const double seconds = std::chrono::duration<double>(
+                               std::chrono::steady_clock::now() - start)
+                               .count();
+
+    std::cout << "backend=" << backend_name << " frames=" << result.frames
+              << " commands=" << result.commands
+              << " last_cycle=" << result.last_cycle << " seconds=" << seconds;
+    if (seconds > 0.0) {
+      std::cout << " frames_per_second="
+                << static_cast<double>(result.frames) / seconds;
+    }
+    std::cout << "\n";
+    return 0;
+  } catch (const std::exception& error) {
+    std::cerr << "Error: " << error.what() << "\n";
+    return 1;
+  }
+}
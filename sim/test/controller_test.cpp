@@ -53,6 +53,28 @@ TEST(SimControllerTest, AssertsHaltControlFromMicrocode) {
   EXPECT_TRUE(sim.halted());
 }
 
+TEST(SimControllerTest, RecordsMicrocodeEntriesIntoProfile) {
+  auto hdl = std::make_shared<irata2::hdl::Cpu>();
+  auto program = MakeProgramWithControls(*hdl, {"halt"});
+
+  Cpu sim(hdl, program);
+  irata2::microcode::debug::MicrocodeProfile profile;
+  sim.controller().set_microcode_profile(&profile);
+  sim.controller().ir().set_value(irata2::base::Byte{0x01});
+  sim.controller().sc().set_value(irata2::base::Byte{0});
+
+  sim.Tick();
+  EXPECT_EQ(profile.total(), 1u);
+  EXPECT_EQ(profile.count({0x01, 0, 0}), 1u);
+
+  const auto control_counts = profile.ControlCounts(*program);
+  const auto halt = std::find(program->control_paths.begin(),
+                              program->control_paths.end(), "halt");
+  EXPECT_EQ(control_counts[static_cast<size_t>(
+                halt - program->control_paths.begin())],
+            1u);
+}
+
 TEST(SimControllerTest, RejectsMissingMicrocodeEntry) {
   auto hdl = std::make_shared<irata2::hdl::Cpu>();
   auto program = std::make_shared<MicrocodeProgram>();
@@ -1,11 +1,14 @@
 #include "irata2/sim/debug_symbols.h"
 
+#include "irata2/sim/error.h"
+
 #include <filesystem>
 #include <fstream>
 
 #include <gtest/gtest.h>
 
 using namespace irata2::sim;
+using irata2::base::Word;
 
 namespace {
 std::string WriteTempDebugJson(const std::string& content) {
@@ -61,3 +64,39 @@ TEST(DebugSymbolsTest, LoadsDebugSymbolsFromJson) {
   EXPECT_EQ(location->column, 1);
   EXPECT_EQ(location->text, "HLT");
 }
+
+TEST(DebugSymbolsTest, ParsesDebugSymbolsFromString) {
+  const DebugSymbols symbols = ParseDebugSymbols(R"({
+    "version": "v1",
+    "entry": "0x8000",
+    "rom_size": 32768,
+    "source_root": ".",
+    "source_files": [],
+    "symbols": {"start": "0x8000"},
+    "pc_to_source": {},
+    "records": []
+  })");
+  EXPECT_EQ(symbols.entry.value(), 0x8000);
+  EXPECT_EQ(symbols.symbols.at("start").value(), 0x8000);
+
+  EXPECT_THROW(ParseDebugSymbols("{"), SimError);
+}
+
+TEST(DebugSymbolsTest, SymbolResolverNamesNearestSymbolBelow) {
+  DebugSymbols symbols;
+  symbols.symbols.emplace("main", Word{0x8000});
+  symbols.symbols.emplace("zeta", Word{0x8010});
+  symbols.symbols.emplace("alias", Word{0x8010});
+
+  const SymbolResolver resolver(&symbols);
+  EXPECT_EQ(resolver.NameFor(Word{0x8000}), "main");
+  EXPECT_EQ(resolver.NameFor(Word{0x8004}), "main+4");
+  EXPECT_EQ(resolver.NameFor(Word{0x8012}), "alias+2");
+  EXPECT_EQ(resolver.SymbolFor(Word{0x8012}), "alias");
+  EXPECT_EQ(resolver.NameFor(Word{0x7FFF}), "$7FFF");
+  EXPECT_EQ(resolver.SymbolFor(Word{0x0010}), "$0010");
+  ASSERT_EQ(resolver.sorted().size(), 3u);
+  EXPECT_EQ(resolver.sorted()[1].second, "alias");
+
+  EXPECT_TRUE(SymbolResolver(nullptr).empty());
+}
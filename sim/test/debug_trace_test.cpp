@@ -1,8 +1,13 @@
 #include "irata2/sim/debug_trace.h"
 
+#include "irata2/isa/isa.h"
+#include "irata2/sim.h"
+
 #include <gtest/gtest.h>
 
 using namespace irata2::sim;
+using irata2::base::Byte;
+using irata2::base::Word;
 
 TEST(DebugTraceBufferTest, DisabledByDefaultDropsEntries) {
   DebugTraceBuffer buffer;
@@ -33,3 +38,85 @@ TEST(DebugTraceBufferTest, RetainsMostRecentEntries) {
   EXPECT_EQ(entries[0].cycle, 2u);
   EXPECT_EQ(entries[1].cycle, 3u);
 }
+
+TEST(DebugTraceBufferTest, RoundsDepthUpAndWrapsInPlace) {
+  DebugTraceBuffer buffer;
+  buffer.Configure(3);
+  EXPECT_EQ(buffer.depth(), 4u);
+
+  for (uint64_t cycle = 1; cycle <= 6; ++cycle) {
+    DebugTraceEntry entry;
+    entry.cycle = cycle;
+    buffer.Record(entry);
+  }
+  ASSERT_EQ(buffer.size(), 4u);
+  EXPECT_EQ(buffer.at(0).cycle, 3u);
+  EXPECT_EQ(buffer.at(3).cycle, 6u);
+
+  const auto spans = buffer.spans();
+  ASSERT_EQ(spans[0].size() + spans[1].size(), 4u);
+  EXPECT_EQ(spans[0].front().cycle, 3u);
+  EXPECT_EQ(spans[1].back().cycle, 6u);
+  // The spans view the ring itself rather than a copy.
+  EXPECT_EQ(&spans[0].front(), &buffer.at(0));
+}
+
+TEST(DebugTraceBufferTest, FiltersByAddressOpcodeAndIrq) {
+  DebugTraceBuffer buffer;
+  buffer.Configure(8);
+  DebugTraceFilter filter;
+  filter.address_ranges.push_back({Word{0x8000}, Word{0x80FF}});
+  filter.opcodes.set(0x10);
+  buffer.set_filter(filter);
+
+  EXPECT_TRUE(buffer.ShouldCapture(Word{0x8010}, 0x10, false));
+  EXPECT_FALSE(buffer.ShouldCapture(Word{0x9000}, 0x10, false));
+  EXPECT_FALSE(buffer.ShouldCapture(Word{0x8010}, 0x11, false));
+
+  filter = DebugTraceFilter{};
+  filter.irq_only = true;
+  buffer.set_filter(filter);
+  EXPECT_FALSE(buffer.ShouldCapture(Word{0x8010}, 0x10, false));
+  EXPECT_TRUE(buffer.ShouldCapture(Word{0x8010}, 0x00, true));
+}
+
+TEST(DebugTraceBufferTest, KeepsEveryNthMatch) {
+  DebugTraceBuffer buffer;
+  buffer.Configure(8);
+  DebugTraceFilter filter;
+  filter.every_nth = 3;
+  buffer.set_filter(filter);
+
+  std::vector<bool> captured;
+  for (int i = 0; i < 6; ++i) {
+    captured.push_back(buffer.ShouldCapture(Word{0x8000}, 0xEA, false));
+  }
+  EXPECT_EQ(captured,
+            (std::vector<bool>{false, false, true, false, false, true}));
+}
+
+TEST(DebugTraceBufferTest, CpuAppliesOpcodeFilter) {
+  // LDA #$01; NOP; LDA #$02; HLT
+  const uint8_t lda = static_cast<uint8_t>(irata2::isa::Opcode::LDA_IMM);
+  const uint8_t nop = static_cast<uint8_t>(irata2::isa::Opcode::NOP_IMP);
+  const uint8_t hlt = static_cast<uint8_t>(irata2::isa::Opcode::HLT_IMP);
+  std::vector<Byte> rom(0x8000, Byte{0});
+  const std::vector<uint8_t> program = {lda, 0x01, nop, lda, 0x02, hlt};
+  for (size_t i = 0; i < program.size(); ++i) {
+    rom[i] = Byte{program[i]};
+  }
+  Cpu cpu(DefaultHdl(), DefaultMicrocodeProgram(), std::move(rom));
+  cpu.pc().set_value(Word{0x8000});
+  cpu.controller().sc().set_value(Byte{0});
+  cpu.controller().ir().set_value(Byte{lda});
+
+  cpu.EnableTrace(8);
+  DebugTraceFilter filter;
+  filter.opcodes.set(lda);
+  cpu.SetTraceFilter(filter);
+  ASSERT_EQ(cpu.RunUntilHalt(1000).reason, Cpu::HaltReason::Halt);
+
+  ASSERT_EQ(cpu.trace().size(), 2u);
+  EXPECT_EQ(cpu.trace().at(0).instruction_address, Word{0x8000});
+  EXPECT_EQ(cpu.trace().at(1).instruction_address, Word{0x8003});
+}
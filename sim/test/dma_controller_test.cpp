@@ -0,0 +1,281 @@
+#include "irata2/sim/io/dma_controller.h"
+
+#include <gtest/gtest.h>
+
+#include <array>
+#include <memory>
+
+#include "irata2/sim.h"
+#include "irata2/sim/io/vector_graphics_coprocessor.h"
+#include "irata2/sim/io/vgc_backend.h"
+#include "test_helpers.h"
+
+using namespace irata2::sim;
+using namespace irata2::sim::io;
+using namespace irata2::base;
+
+namespace {
+
+struct DmaRig {
+  std::unique_ptr<Cpu> cpu;
+  DmaController* dma = nullptr;
+  VectorGraphicsCoprocessor* vgc = nullptr;
+  ImageBackend* backend = nullptr;
+};
+
+// Byte storage without contents(), so transfers over it take the
+// byte-at-a-time path.
+class ScratchModule final : public memory::Module {
+ public:
+  ScratchModule(std::string name, Component& parent)
+      : memory::Module(std::move(name), parent) {}
+
+  size_t size() const override { return data_.size(); }
+  Byte Read(Word address) const override { return data_[address.value()]; }
+  void Write(Word address, Byte value) override {
+    data_[address.value()] = value;
+  }
+
+ private:
+  std::array<Byte, 0x20> data_{};
+};
+
+constexpr uint16_t kScratchBase = 0x5000;
+
+// Scratch, VGC and DMA regions; the factories fill in @p rig's pointers
+// when the CPU is built.
+std::vector<memory::Memory::RegionFactory> DmaFactories(DmaRig& rig) {
+  std::vector<memory::Memory::RegionFactory> factories;
+  factories.push_back([](memory::Memory& m, LatchedProcessControl&)
+                          -> std::unique_ptr<memory::Region> {
+    return std::make_unique<memory::Region>(
+        "scratch", m, Word{kScratchBase},
+        [](memory::Region& r) -> std::unique_ptr<memory::Module> {
+          return std::make_unique<ScratchModule>("scratch", r);
+        });
+  });
+  factories.push_back([&rig](memory::Memory& m, LatchedProcessControl&)
+                          -> std::unique_ptr<memory::Region> {
+    return std::make_unique<memory::Region>(
+        "vgc", m, Word{VGC_BASE},
+        [&rig](memory::Region& r) -> std::unique_ptr<memory::Module> {
+          auto backend = std::make_unique<ImageBackend>();
+          rig.backend = backend.get();
+          auto vgc = std::make_unique<VectorGraphicsCoprocessor>(
+              "vgc", r, std::move(backend));
+          rig.vgc = vgc.get();
+          return vgc;
+        });
+  });
+  factories.push_back([&rig](memory::Memory& m, LatchedProcessControl& irq_line)
+                          -> std::unique_ptr<memory::Region> {
+    return std::make_unique<memory::Region>(
+        "dma", m, Word{DMA_BASE},
+        [&rig, &irq_line](memory::Region& r) -> std::unique_ptr<memory::Module> {
+          auto device = std::make_unique<DmaController>("dma", r, irq_line);
+          rig.dma = device.get();
+          return device;
+        });
+  });
+  return factories;
+}
+
+DmaRig MakeCpuWithDma(std::shared_ptr<const irata2::microcode::output::MicrocodeProgram> program,
+                      std::vector<Byte> rom = {}) {
+  DmaRig rig;
+  rig.cpu = std::make_unique<Cpu>(DefaultHdl(), std::move(program),
+                                  std::move(rom), DmaFactories(rig));
+  return rig;
+}
+
+}  // namespace
+
+class DmaControllerTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    rig_ = MakeCpuWithDma(test::MakeNoopProgram());
+  }
+
+  void Program(uint16_t src, uint16_t dst, uint16_t len, uint8_t mode) {
+    auto& dma = *rig_.dma;
+    dma.Write(Word{dma_reg::SRC_LO}, Word{src}.low());
+    dma.Write(Word{dma_reg::SRC_HI}, Word{src}.high());
+    dma.Write(Word{dma_reg::DST_LO}, Word{dst}.low());
+    dma.Write(Word{dma_reg::DST_HI}, Word{dst}.high());
+    dma.Write(Word{dma_reg::LEN_LO}, Word{len}.low());
+    dma.Write(Word{dma_reg::LEN_HI}, Word{len}.high());
+    dma.Write(Word{dma_reg::MODE}, Byte{mode});
+  }
+
+  Byte Ram(uint16_t address) { return rig_.cpu->memory().ReadAt(Word{address}); }
+
+  DmaRig rig_;
+};
+
+TEST_F(DmaControllerTest, CopyMovesBlockImmediately) {
+  for (uint16_t i = 0; i < 32; ++i) {
+    rig_.cpu->memory().WriteAt(Word{static_cast<uint16_t>(0x0200 + i)},
+                               Byte{static_cast<uint8_t>(i + 1)});
+  }
+  Program(0x0200, 0x0300, 32, dma_mode::COPY);
+  rig_.dma->Write(Word{dma_reg::CONTROL}, Byte{dma_control::START});
+
+  for (uint16_t i = 0; i < 32; ++i) {
+    EXPECT_EQ(Ram(0x0300 + i), Byte{static_cast<uint8_t>(i + 1)});
+  }
+  EXPECT_EQ(Ram(0x0320), Byte{0x00});
+}
+
+TEST_F(DmaControllerTest, CopyHandlesOverlappingRanges) {
+  for (uint16_t i = 0; i < 8; ++i) {
+    rig_.cpu->memory().WriteAt(Word{static_cast<uint16_t>(0x0100 + i)},
+                               Byte{static_cast<uint8_t>(0x10 + i)});
+  }
+  Program(0x0100, 0x0102, 8, dma_mode::COPY);
+  rig_.dma->Write(Word{dma_reg::CONTROL}, Byte{dma_control::START});
+
+  for (uint16_t i = 0; i < 8; ++i) {
+    EXPECT_EQ(Ram(0x0102 + i), Byte{static_cast<uint8_t>(0x10 + i)});
+  }
+}
+
+TEST_F(DmaControllerTest, CopyHandlesOverlappingRangesOutsideRam) {
+  auto& memory = rig_.cpu->memory();
+  for (uint16_t i = 0; i < 8; ++i) {
+    memory.WriteAt(Word{static_cast<uint16_t>(kScratchBase + i)},
+                   Byte{static_cast<uint8_t>(0x10 + i)});
+  }
+  Program(kScratchBase, kScratchBase + 2, 8, dma_mode::COPY);
+  rig_.dma->Write(Word{dma_reg::CONTROL}, Byte{dma_control::START});
+
+  for (uint16_t i = 0; i < 8; ++i) {
+    EXPECT_EQ(memory.ReadAt(Word{static_cast<uint16_t>(kScratchBase + 2 + i)}),
+              Byte{static_cast<uint8_t>(0x10 + i)});
+  }
+}
+
+TEST_F(DmaControllerTest, CopyFromRomUsesBulkPath) {
+  rig_ = MakeCpuWithDma(test::MakeNoopProgram(),
+                        std::vector<Byte>(0x8000, Byte{0x5A}));
+  Program(0x8000, 0x0000, 16, dma_mode::COPY);
+  rig_.dma->Write(Word{dma_reg::CONTROL}, Byte{dma_control::START});
+  EXPECT_EQ(Ram(0x0000), Byte{0x5A});
+  EXPECT_EQ(Ram(0x000F), Byte{0x5A});
+}
+
+TEST_F(DmaControllerTest, FillWritesValue) {
+  Program(0x0000, 0x0400, 100, dma_mode::FILL);
+  rig_.dma->Write(Word{dma_reg::FILL}, Byte{0xEE});
+  rig_.dma->Write(Word{dma_reg::CONTROL}, Byte{dma_control::START});
+
+  EXPECT_EQ(Ram(0x03FF), Byte{0x00});
+  EXPECT_EQ(Ram(0x0400), Byte{0xEE});
+  EXPECT_EQ(Ram(0x0463), Byte{0xEE});
+  EXPECT_EQ(Ram(0x0464), Byte{0x00});
+}
+
+TEST_F(DmaControllerTest, StreamFeedsVgcPort) {
+  const uint8_t commands[] = {
+      vgc_cmd::CLEAR, 0, 0, 0, 0, 0x00,
+      vgc_cmd::LINE, 0, 0, 10, 0, 0x03,
+  };
+  for (uint16_t i = 0; i < sizeof(commands); ++i) {
+    rig_.cpu->memory().WriteAt(Word{static_cast<uint16_t>(0x0200 + i)},
+                               Byte{commands[i]});
+  }
+  Program(0x0200, VGC_BASE + vgc_reg::STREAM, sizeof(commands),
+          dma_mode::STREAM);
+  rig_.dma->Write(Word{dma_reg::CONTROL}, Byte{dma_control::START});
+  EXPECT_EQ(rig_.vgc->pending_commands(), 2u);
+  rig_.vgc->Flush();
+
+  const auto& fb = rig_.backend->framebuffer();
+  EXPECT_EQ(fb[0], 0x03);
+  EXPECT_EQ(fb[10], 0x03);
+  EXPECT_EQ(fb[11], 0x00);
+}
+
+TEST_F(DmaControllerTest, BusyUntilModeledCostElapses) {
+  Program(0x0000, 0x0400, 10, dma_mode::FILL);
+  rig_.dma->Write(Word{dma_reg::CONTROL}, Byte{dma_control::START});
+  EXPECT_TRUE(rig_.dma->busy());
+
+  const uint64_t cost = DmaController::TransferCycles(dma_mode::FILL, 10);
+  EXPECT_EQ(cost, DmaController::kSetupCycles + 10);
+  for (uint64_t i = 0; i < cost; ++i) {
+    rig_.cpu->Tick();
+    EXPECT_TRUE(rig_.dma->busy());
+  }
+  rig_.cpu->Tick();
+  EXPECT_FALSE(rig_.dma->busy());
+}
+
+TEST_F(DmaControllerTest, StartWhileBusyIsIgnored) {
+  Program(0x0000, 0x0400, 4, dma_mode::FILL);
+  rig_.dma->Write(Word{dma_reg::FILL}, Byte{0x11});
+  rig_.dma->Write(Word{dma_reg::CONTROL}, Byte{dma_control::START});
+  rig_.dma->Write(Word{dma_reg::FILL}, Byte{0x22});
+  rig_.dma->Write(Word{dma_reg::CONTROL}, Byte{dma_control::START});
+  EXPECT_EQ(Ram(0x0400), Byte{0x11});
+}
+
+TEST_F(DmaControllerTest, CompletionRaisesIrqUntilStatusRead) {
+  Program(0x0000, 0x0400, 1, dma_mode::FILL);
+  rig_.dma->Write(Word{dma_reg::CONTROL},
+                  Byte{dma_control::START | dma_control::IRQ_ENABLE});
+  EXPECT_FALSE(rig_.dma->irq_pending());
+
+  for (uint64_t i = 0; i <= DmaController::TransferCycles(dma_mode::FILL, 1); ++i) {
+    rig_.cpu->Tick();
+  }
+  EXPECT_TRUE(rig_.dma->irq_pending());
+  test::SetPhase(*rig_.cpu, TickPhase::Process);
+  EXPECT_TRUE(rig_.cpu->irq_line().asserted());
+
+  const uint8_t status = rig_.dma->Read(Word{dma_reg::STATUS}).value();
+  EXPECT_EQ(status & dma_status::IRQ_PENDING, dma_status::IRQ_PENDING);
+  EXPECT_FALSE(rig_.dma->irq_pending());
+
+  rig_.cpu->Tick();
+  test::SetPhase(*rig_.cpu, TickPhase::Process);
+  EXPECT_FALSE(rig_.cpu->irq_line().asserted());
+}
+
+TEST(DmaControllerIntegrationTest, ProgramCopiesTableAndPollsBusy) {
+  const std::string program = R"(
+    LDA #$AB
+    STA $0200
+    LDA #$CD
+    STA $0201
+
+    LDA #$00
+    STA $4300
+    LDA #$02
+    STA $4301
+    LDA #$40
+    STA $4302
+    LDA #$02
+    STA $4303
+    LDA #$02
+    STA $4304
+    LDA #$00
+    STA $4305
+    STA $4307
+    LDA #$01
+    STA $4308
+  wait:
+    LDA $4309
+    AND #$01
+    BNE wait
+    HLT
+  )";
+
+  DmaRig rig;
+  rig.cpu = test::MakeAssembledCpu(program, DmaFactories(rig));
+
+  const auto result = rig.cpu->RunUntilHalt(5000);
+  ASSERT_EQ(result.reason, Cpu::HaltReason::Halt);
+  EXPECT_EQ(rig.cpu->memory().ReadAt(Word{0x0240}), Byte{0xAB});
+  EXPECT_EQ(rig.cpu->memory().ReadAt(Word{0x0241}), Byte{0xCD});
+  EXPECT_FALSE(rig.dma->busy());
+}
@@ -0,0 +1,137 @@
+#include "irata2/sim/frame_budget.h"
+
+#include "irata2/sim.h"
+#include "test_helpers.h"
+
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <sstream>
+
+using namespace irata2::sim;
+
+namespace {
+
+// Frame 1 clears, draws one line and presents; frame 2 burns cycles in
+// `slow` before presenting without drawing.
+constexpr const char* kFrameProgram = R"(
+start:
+    LDA #$01
+    STA $4100
+    LDA #$01
+    STA $4106
+    LDA #$03
+    STA $4100
+    LDA #$0A
+    STA $4103
+    LDA #$01
+    STA $4106
+    LDA #$02
+    STA $4107
+    LDX #$40
+    JSR slow
+    LDA #$02
+    STA $4107
+    HLT
+slow:
+    DEX
+    BNE slow
+    RTS
+)";
+
+constexpr uint64_t kBudget = 300;
+
+struct BudgetRun {
+  test::VgcRig rig;
+  std::unique_ptr<FrameBudget> budget;
+};
+
+BudgetRun RunWithBudget(uint64_t cycles_per_frame) {
+  BudgetRun run;
+  run.rig = test::MakeAssembledVgcRig(kFrameProgram);
+
+  run.budget = std::make_unique<FrameBudget>(cycles_per_frame);
+  run.budget->SetSymbols(run.rig.cpu->debug_symbols());
+  run.budget->AttachVgc(run.rig.vgc);
+  run.rig.cpu->AttachFrameBudget(run.budget.get());
+  EXPECT_EQ(run.rig.cpu->RunUntilHalt(100000).reason, Cpu::HaltReason::Halt);
+  return run;
+}
+
+}  // namespace
+
+TEST(FrameBudgetTest, CountsWorkPerPresentedFrame) {
+  BudgetRun run = RunWithBudget(kBudget);
+  const auto& frames = run.budget->frames();
+  ASSERT_EQ(frames.size(), 2u);
+
+  const FrameBudget::Frame& drawn = frames[0];
+  EXPECT_EQ(drawn.index, 1u);
+  EXPECT_EQ(drawn.start_cycle, 0u);
+  EXPECT_EQ(drawn.commands, 2u);
+  EXPECT_EQ(drawn.lines, 1u);
+  EXPECT_EQ(drawn.mmio_writes, 6u);
+  EXPECT_GT(drawn.draw_cycles, 0u);
+  EXPECT_LT(drawn.draw_cycles, drawn.cycles);
+  EXPECT_FALSE(drawn.overrun);
+  EXPECT_TRUE(drawn.top_symbols.empty());
+
+  const FrameBudget::Frame& slow = frames[1];
+  EXPECT_EQ(slow.index, 2u);
+  EXPECT_EQ(slow.start_cycle, drawn.start_cycle + drawn.cycles);
+  EXPECT_EQ(slow.commands, 0u);
+  EXPECT_EQ(slow.lines, 0u);
+  EXPECT_EQ(slow.mmio_writes, 1u);
+  EXPECT_EQ(slow.draw_cycles, 0u);
+  EXPECT_TRUE(slow.overrun);
+  ASSERT_FALSE(slow.top_symbols.empty());
+  EXPECT_EQ(slow.top_symbols.front().name, "slow");
+  EXPECT_GT(slow.top_symbols.front().cycles, kBudget / 2);
+
+  EXPECT_EQ(run.budget->overruns(), 1u);
+  EXPECT_EQ(run.budget->frame_cycles().count(), 2u);
+  EXPECT_EQ(run.budget->frame_cycles().max(), slow.cycles);
+}
+
+TEST(FrameBudgetTest, ReportsOverrunsAndWritesCsv) {
+  BudgetRun run = RunWithBudget(kBudget);
+
+  std::ostringstream text;
+  run.budget->WriteText(text);
+  EXPECT_NE(text.str().find("frames=2 budget=300 overruns=1 (50.0%)"),
+            std::string::npos);
+  EXPECT_NE(text.str().find("frame_cycles: count=2"), std::string::npos);
+  EXPECT_NE(text.str().find("overrun frame 2: cycles="), std::string::npos);
+  EXPECT_EQ(text.str().find("overrun frame 1:"), std::string::npos);
+  EXPECT_NE(text.str().find("  slow\n"), std::string::npos);
+
+  std::ostringstream csv;
+  run.budget->WriteCsv(csv);
+  std::istringstream lines(csv.str());
+  std::string header;
+  std::string first;
+  std::string second;
+  std::getline(lines, header);
+  std::getline(lines, first);
+  std::getline(lines, second);
+  EXPECT_EQ(header,
+            "frame,start_cycle,cycles,draw_cycles,commands,lines,mmio_writes,"
+            "overrun,top_symbol");
+  EXPECT_EQ(first.substr(0, 4), "1,0,");
+  EXPECT_EQ(first.substr(first.size() - 2), "0,");
+  EXPECT_EQ(second.substr(second.size() - 7), ",1,slow");
+}
+
+TEST(FrameBudgetTest, GenerousBudgetHasNoOverruns) {
+  BudgetRun run = RunWithBudget(100000);
+  ASSERT_EQ(run.budget->frames().size(), 2u);
+  EXPECT_EQ(run.budget->overruns(), 0u);
+  for (const auto& frame : run.budget->frames()) {
+    EXPECT_FALSE(frame.overrun);
+    EXPECT_TRUE(frame.top_symbols.empty());
+  }
+}
+
+TEST(FrameBudgetTest, RejectsZeroBudget) {
+  EXPECT_THROW(FrameBudget(0), SimError);
+}
@@ -0,0 +1,126 @@
+#include "irata2/sim/frame_pacer.h"
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <vector>
+
+using irata2::sim::FrameClock;
+using irata2::sim::FramePacer;
+using irata2::sim::PacingMode;
+using std::chrono::milliseconds;
+
+namespace {
+
+/// Clock that only moves when told to, or when a wait reaches its deadline.
+class ManualClock final : public FrameClock {
+ public:
+  Clock::time_point Now() const override { return now_; }
+
+  void WaitUntil(Clock::time_point deadline) override {
+    waits.push_back(deadline);
+    if (deadline > now_) {
+      now_ = deadline;
+    }
+  }
+
+  void Advance(Clock::duration duration) { now_ += duration; }
+  Clock::time_point start() const { return Clock::time_point{}; }
+
+  std::vector<Clock::time_point> waits;
+
+ private:
+  Clock::time_point now_{};
+};
+
+}  // namespace
+
+TEST(FramePacerTest, PacesSteadyFramesOnAbsoluteDeadlines) {
+  ManualClock clock;
+  FramePacer pacer(50, clock);
+
+  for (int frame = 1; frame <= 3; ++frame) {
+    clock.Advance(milliseconds(5));  // the frame's emulation work
+    pacer.WaitForNextFrame();
+    EXPECT_EQ(clock.Now(), clock.start() + milliseconds(20 * frame));
+  }
+
+  EXPECT_EQ(clock.waits.size(), 3u);
+  EXPECT_EQ(pacer.stats().frames, 3u);
+  EXPECT_EQ(pacer.stats().late_frames, 0u);
+  EXPECT_DOUBLE_EQ(pacer.stats().mean_ms, 20.0);
+  EXPECT_DOUBLE_EQ(pacer.stats().jitter_ms, 0.0);
+}
+
+TEST(FramePacerTest, CatchesUpAfterShortStall) {
+  ManualClock clock;
+  FramePacer pacer(50, clock);
+
+  clock.Advance(milliseconds(30));  // overruns the 20 ms deadline
+  pacer.WaitForNextFrame();
+  EXPECT_TRUE(clock.waits.empty());
+  EXPECT_EQ(pacer.stats().late_frames, 1u);
+
+  // The schedule keeps its original grid, so the next frame is short.
+  pacer.WaitForNextFrame();
+  EXPECT_EQ(clock.Now(), clock.start() + milliseconds(40));
+  EXPECT_DOUBLE_EQ(pacer.stats().min_ms, 10.0);
+}
+
+TEST(FramePacerTest, ResyncsAfterLongStall) {
+  ManualClock clock;
+  FramePacer pacer(50, clock);
+
+  // More than kMaxLagFrames periods behind.
+  clock.Advance(milliseconds(200));
+  pacer.WaitForNextFrame();
+  EXPECT_EQ(pacer.stats().late_frames, 1u);
+
+  // The schedule restarts from the stall instead of bursting through the
+  // missed deadlines.
+  pacer.WaitForNextFrame();
+  EXPECT_EQ(clock.Now(), clock.start() + milliseconds(220));
+  pacer.WaitForNextFrame();
+  EXPECT_EQ(clock.Now(), clock.start() + milliseconds(240));
+  EXPECT_EQ(pacer.stats().late_frames, 1u);
+}
+
+TEST(FramePacerTest, TurboFactorChangesApplyFromNextDeadline) {
+  ManualClock clock;
+  FramePacer pacer(50, clock);
+
+  pacer.WaitForNextFrame();
+  EXPECT_EQ(clock.Now(), clock.start() + milliseconds(20));
+
+  pacer.set_mode(PacingMode::Turbo);
+  pacer.set_turbo_factor(4);
+  // The deadline already scheduled at the realtime period stands.
+  pacer.WaitForNextFrame();
+  EXPECT_EQ(clock.Now(), clock.start() + milliseconds(40));
+  pacer.WaitForNextFrame();
+  EXPECT_EQ(clock.Now(), clock.start() + milliseconds(45));
+
+  pacer.set_turbo_factor(2);
+  pacer.WaitForNextFrame();
+  EXPECT_EQ(clock.Now(), clock.start() + milliseconds(50));
+  pacer.WaitForNextFrame();
+  EXPECT_EQ(clock.Now(), clock.start() + milliseconds(60));
+
+  pacer.set_turbo_factor(0);
+  EXPECT_EQ(pacer.turbo_factor(), 1);
+}
+
+TEST(FramePacerTest, UnthrottledNeverWaits) {
+  ManualClock clock;
+  FramePacer pacer(50, clock);
+  pacer.set_mode(PacingMode::Unthrottled);
+
+  for (int i = 0; i < 3; ++i) {
+    clock.Advance(milliseconds(1));
+    pacer.WaitForNextFrame();
+  }
+  EXPECT_TRUE(clock.waits.empty());
+  EXPECT_EQ(clock.Now(), clock.start() + milliseconds(3));
+  EXPECT_EQ(pacer.stats().frames, 3u);
+  EXPECT_EQ(pacer.stats().late_frames, 0u);
+}
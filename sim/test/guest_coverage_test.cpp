@@ -0,0 +1,98 @@
+#include "irata2/sim/guest_coverage.h"
+
+#include "irata2/sim.h"
+#include "test_helpers.h"
+
+#include <gtest/gtest.h>
+
+#include <sstream>
+
+using namespace irata2::sim;
+using irata2::base::Word;
+
+namespace {
+
+constexpr const char* kCoverageProgram = R"(
+start:
+    LDX #$03
+loop:
+    DEX
+    BNE loop
+    CPX #$00
+    BEQ done
+    LDA #$01
+done:
+    HLT
+never:
+    BCS start
+    HLT
+table:
+    .byte $01, $02
+)";
+
+struct CoverageRun {
+  GuestCoverage coverage;
+  DebugSymbols symbols;
+  Word entry;
+};
+
+void RunCoverage(CoverageRun& run) {
+  auto cpu = test::MakeAssembledCpu(kCoverageProgram);
+  run.symbols = *cpu->debug_symbols();
+  run.entry = cpu->pc().value();
+
+  cpu->AttachCoverage(&run.coverage);
+  EXPECT_EQ(cpu->RunUntilHalt(100000).reason, Cpu::HaltReason::Halt);
+}
+
+Word SymbolAddress(const CoverageRun& run, const std::string& name) {
+  return run.symbols.symbols.at(name);
+}
+
+}  // namespace
+
+TEST(GuestCoverageTest, RecordsInstructionStartsAndBranchDirections) {
+  CoverageRun run;
+  RunCoverage(run);
+  const GuestCoverage& coverage = run.coverage;
+
+  EXPECT_TRUE(coverage.executed(run.entry));
+  EXPECT_TRUE(coverage.executed(SymbolAddress(run, "loop")));
+  EXPECT_TRUE(coverage.executed(SymbolAddress(run, "done")));
+  EXPECT_FALSE(coverage.executed(SymbolAddress(run, "never")));
+  // LDX, DEX, BNE, CPX, BEQ, HLT; the LDA is skipped.
+  EXPECT_EQ(coverage.executed_count(), 6u);
+
+  const auto& branches = coverage.branches();
+  ASSERT_EQ(branches.size(), 2u);
+  const uint16_t bne = SymbolAddress(run, "loop").value() + 1;
+  ASSERT_TRUE(branches.count(bne));
+  EXPECT_EQ(branches.at(bne).taken, 2u);
+  EXPECT_EQ(branches.at(bne).not_taken, 1u);
+  const GuestCoverage::BranchCounts& beq = std::next(branches.begin())->second;
+  EXPECT_EQ(beq.taken, 1u);
+  EXPECT_EQ(beq.not_taken, 0u);
+}
+
+TEST(GuestCoverageTest, WritesLcovAgainstSource) {
+  CoverageRun run;
+  RunCoverage(run);
+
+  std::ostringstream out;
+  run.coverage.WriteLcov(out, run.symbols, "unit");
+  const std::string lcov = out.str();
+
+  EXPECT_EQ(lcov.rfind("TN:unit\nSF:", 0), 0u);
+  EXPECT_NE(lcov.find("test.asm\n"), std::string::npos);
+  // Source lines count from the raw string's leading newline.
+  EXPECT_NE(lcov.find("DA:3,1\n"), std::string::npos);   // LDX
+  EXPECT_NE(lcov.find("DA:9,0\n"), std::string::npos);   // LDA
+  EXPECT_NE(lcov.find("DA:13,0\n"), std::string::npos);  // BCS
+  EXPECT_EQ(lcov.find("DA:17,"), std::string::npos);     // .byte
+  EXPECT_NE(lcov.find("BRDA:6,0,0,2\nBRDA:6,0,1,1\n"), std::string::npos);
+  EXPECT_NE(lcov.find("BRDA:8,0,0,1\nBRDA:8,0,1,0\n"), std::string::npos);
+  EXPECT_NE(lcov.find("BRDA:13,0,0,-\nBRDA:13,0,1,-\n"), std::string::npos);
+  EXPECT_NE(lcov.find("BRF:6\nBRH:3\n"), std::string::npos);
+  EXPECT_NE(lcov.find("LF:9\nLH:6\n"), std::string::npos);
+  EXPECT_NE(lcov.find("end_of_record\n"), std::string::npos);
+}
@@ -0,0 +1,121 @@
+#include "irata2/sim/guest_profiler.h"
+
+#include "irata2/sim.h"
+#include "test_helpers.h"
+
+#include <gtest/gtest.h>
+
+#include <sstream>
+
+using namespace irata2::sim;
+using irata2::base::Word;
+
+namespace {
+
+struct ProfiledRun {
+  std::unique_ptr<Cpu> cpu;
+  std::unique_ptr<GuestProfiler> profiler;
+};
+
+ProfiledRun RunProfiled(const std::string& program) {
+  ProfiledRun run;
+  run.cpu = test::MakeAssembledCpu(program);
+  run.profiler = std::make_unique<GuestProfiler>();
+  run.profiler->SetSymbols(run.cpu->debug_symbols());
+  run.cpu->AttachProfiler(run.profiler.get());
+  const auto result = run.cpu->RunUntilHalt(100000);
+  EXPECT_EQ(result.reason, Cpu::HaltReason::Halt);
+  return run;
+}
+
+const GuestProfiler::FunctionStats* FindFunction(
+    const std::vector<GuestProfiler::FunctionStats>& functions,
+    const std::string& name) {
+  for (const auto& function : functions) {
+    if (function.name == name) {
+      return &function;
+    }
+  }
+  return nullptr;
+}
+
+constexpr const char* kCallProgram = R"(
+start:
+    JSR outer
+    JSR leaf
+    HLT
+outer:
+    JSR leaf
+    JSR leaf
+    RTS
+leaf:
+    NOP
+    NOP
+    RTS
+)";
+
+}  // namespace
+
+TEST(GuestProfilerTest, EveryCycleIsAttributed) {
+  ProfiledRun run = RunProfiled(kCallProgram);
+  const GuestProfiler& profiler = *run.profiler;
+
+  EXPECT_EQ(profiler.total_cycles(), run.cpu->cycle_count());
+  uint64_t sum = 0;
+  for (size_t address = 0; address < GuestProfiler::kAddressSpace; ++address) {
+    sum += profiler.cycles_at(Word{static_cast<uint16_t>(address)});
+  }
+  EXPECT_EQ(sum, profiler.total_cycles());
+  EXPECT_GT(profiler.total_instructions(), 0u);
+}
+
+TEST(GuestProfilerTest, CallTreeCountsCallsAndInclusiveCycles) {
+  ProfiledRun run = RunProfiled(kCallProgram);
+  const auto functions = run.profiler->Functions();
+
+  const auto* start = FindFunction(functions, "start");
+  const auto* outer = FindFunction(functions, "outer");
+  const auto* leaf = FindFunction(functions, "leaf");
+  ASSERT_NE(start, nullptr);
+  ASSERT_NE(outer, nullptr);
+  ASSERT_NE(leaf, nullptr);
+
+  EXPECT_EQ(start->calls, 1u);
+  EXPECT_EQ(outer->calls, 1u);
+  EXPECT_EQ(leaf->calls, 3u);
+
+  // The root frame covers the whole run; outer includes its two leaf calls.
+  EXPECT_EQ(start->inclusive_cycles, run.profiler->total_cycles());
+  EXPECT_EQ(outer->inclusive_cycles,
+            outer->self_cycles + leaf->self_cycles * 2 / 3);
+  EXPECT_EQ(leaf->inclusive_cycles, leaf->self_cycles);
+}
+
+TEST(GuestProfilerTest, WritesCollapsedStacksAndListing) {
+  ProfiledRun run = RunProfiled(kCallProgram);
+
+  std::ostringstream folded;
+  run.profiler->WriteCollapsedStacks(folded);
+  const std::string stacks = folded.str();
+  EXPECT_NE(stacks.find("start;outer;leaf "), std::string::npos);
+  EXPECT_NE(stacks.find("start;leaf "), std::string::npos);
+
+  std::ostringstream listing;
+  run.profiler->WriteAnnotatedListing(listing);
+  EXPECT_NE(listing.str().find("outer:\n"), std::string::npos);
+  EXPECT_NE(listing.str().find("jsr leaf"), std::string::npos);
+
+  std::ostringstream json;
+  run.profiler->WriteJson(json, 2);
+  EXPECT_NE(json.str().find("\"functions\""), std::string::npos);
+  EXPECT_NE(json.str().find("\"cycles_per_frame\""), std::string::npos);
+}
+
+TEST(GuestProfilerTest, NamesUseNearestSymbol) {
+  ProfiledRun run = RunProfiled(kCallProgram);
+  const Word leaf = run.cpu->debug_symbols()->symbols.at("leaf");
+  EXPECT_EQ(run.profiler->NameFor(leaf), "leaf");
+  EXPECT_EQ(run.profiler->NameFor(Word{static_cast<uint16_t>(leaf.value() + 1)}),
+            "leaf+1");
+  EXPECT_EQ(run.profiler->NameFor(Word{0x0010}), "$0010");
+}
@@ -0,0 +1,71 @@
+#include "irata2/sim/guest_timeline.h"
+
+#include "irata2/sim.h"
+#include "test_helpers.h"
+
+#include <gtest/gtest.h>
+
+#include <sstream>
+
+using namespace irata2::sim;
+
+namespace {
+
+constexpr const char* kCallProgram = R"(
+start:
+    JSR outer
+    JSR leaf
+    HLT
+outer:
+    JSR leaf
+    RTS
+leaf:
+    NOP
+    RTS
+)";
+
+std::string RunTimeline(const std::string& program, size_t max_events) {
+  auto owned = test::MakeAssembledCpu(program);
+  Cpu& cpu = *owned;
+  GuestTimeline timeline;
+  timeline.SetSymbols(cpu.debug_symbols());
+  timeline.set_max_events(max_events);
+  cpu.AttachTimeline(&timeline);
+  EXPECT_EQ(cpu.RunUntilHalt(100000).reason, Cpu::HaltReason::Halt);
+
+  std::ostringstream out;
+  timeline.WriteChromeTrace(out);
+  return out.str();
+}
+
+size_t Count(const std::string& text, const std::string& needle) {
+  size_t count = 0;
+  for (size_t pos = text.find(needle); pos != std::string::npos;
+       pos = text.find(needle, pos + 1)) {
+    ++count;
+  }
+  return count;
+}
+
+}  // namespace
+
+TEST(GuestTimelineTest, WritesCallSpansNamedBySymbol) {
+  const std::string trace =
+      RunTimeline(kCallProgram, GuestTimeline::kDefaultMaxEvents);
+
+  EXPECT_EQ(trace.rfind("{\n  \"traceEvents\": [", 0), 0u);
+  EXPECT_NE(trace.find("\"thread_name\""), std::string::npos);
+  EXPECT_EQ(Count(trace, "\"name\": \"outer\", \"cat\": \"call\", \"ph\": \"X\""),
+            1u);
+  EXPECT_EQ(Count(trace, "\"name\": \"leaf\", \"cat\": \"call\", \"ph\": \"X\""),
+            2u);
+  EXPECT_NE(trace.find("\"dropped_events\": 0"), std::string::npos);
+}
+
+TEST(GuestTimelineTest, StopsRecordingAtMaxEvents) {
+  const std::string trace = RunTimeline(kCallProgram, 1);
+
+  EXPECT_EQ(Count(trace, "\"cat\": \"call\""), 1u);
+  EXPECT_NE(trace.find("\"events\": 1, \"dropped_events\": 2"),
+            std::string::npos);
+}
@@ -0,0 +1,65 @@
+#include "irata2/sim/host_profile.h"
+
+#include "irata2/sim.h"
+#include "test_helpers.h"
+
+#include <gtest/gtest.h>
+
+#include <sstream>
+
+using namespace irata2::sim;
+using irata2::base::TickPhase;
+
+namespace {
+
+constexpr const char* kLoopProgram = R"(
+  loop:
+    JMP loop
+)";
+
+}  // namespace
+
+TEST(HostProfileTest, RecordsPhasesOnlyWhenBuiltIn) {
+  auto cpu = test::MakeAssembledCpu(kLoopProgram);
+  cpu->RunUntilHalt(200);
+  const HostProfile& profile = cpu->host_profile();
+
+  if constexpr (HostProfile::kEnabled) {
+    EXPECT_EQ(profile.ticks(), 200u);
+    EXPECT_GT(profile.phase_ns(TickPhase::Control), 0u);
+    EXPECT_GT(profile.total_ns(), 0u);
+  } else {
+    EXPECT_EQ(profile.ticks(), 0u);
+    EXPECT_EQ(profile.total_ns(), 0u);
+  }
+  EXPECT_TRUE(profile.components().empty());
+}
+
+TEST(HostProfileTest, ComponentBreakdownGroupsChildrenByType) {
+  auto cpu = test::MakeAssembledCpu(kLoopProgram);
+  cpu->host_profile().set_component_breakdown(true);
+  cpu->RunUntilHalt(200);
+  const HostProfile& profile = cpu->host_profile();
+
+  if constexpr (!HostProfile::kEnabled) {
+    EXPECT_TRUE(profile.components().empty());
+    return;
+  }
+  bool found_memory = false;
+  for (const auto& component : profile.components()) {
+    found_memory = found_memory || component.type == "Memory";
+  }
+  EXPECT_TRUE(found_memory);
+
+  std::ostringstream table;
+  profile.WriteTable(table);
+  EXPECT_NE(table.str().find("Process"), std::string::npos);
+  EXPECT_NE(table.str().find("Memory"), std::string::npos);
+
+  cpu->host_profile().Reset();
+  EXPECT_EQ(cpu->host_profile().ticks(), 0u);
+  EXPECT_EQ(cpu->host_profile().total_ns(), 0u);
+  // Reset keeps the type slots, so the breakdown resumes in place.
+  cpu->RunUntilHalt(10);
+  EXPECT_EQ(cpu->host_profile().ticks(), 10u);
+}
@@ -2,7 +2,10 @@
 
 #include <gtest/gtest.h>
 
+#include <atomic>
+#include <cstring>
 #include <memory>
+#include <thread>
 
 #include "irata2/sim.h"
 #include "irata2/sim/memory/memory.h"
@@ -441,3 +444,120 @@ TEST_F(InputDeviceTest, AllKeyStateBits) {
   device_->set_key_up(key_state_bits::SPACE);
   EXPECT_EQ(device_->key_state(), 0);
 }
+
+TEST_F(InputDeviceTest, HostEventsApplyOnNextTick) {
+  EXPECT_TRUE(device_->PostHostEvent({HostInputEvent::Kind::KeyPress, 0x41}));
+  EXPECT_TRUE(device_->PostHostEvent(
+      {HostInputEvent::Kind::KeyDown, key_state_bits::UP}));
+
+  // Nothing is visible until the device drains the ring.
+  EXPECT_TRUE(device_->empty());
+  EXPECT_EQ(device_->key_state(), 0);
+
+  cpu_->Tick();
+  EXPECT_EQ(device_->count(), 1);
+  EXPECT_EQ(device_->key_state(), key_state_bits::UP);
+
+  EXPECT_TRUE(device_->PostHostEvent(
+      {HostInputEvent::Kind::KeyUp, key_state_bits::UP}));
+  cpu_->Tick();
+  EXPECT_EQ(device_->key_state(), 0);
+}
+
+TEST_F(InputDeviceTest, AppliedHostEventsStartInputLatencySamples) {
+  cpu_->set_latency_tracking(true);
+  device_->PostHostEvent({HostInputEvent::Kind::KeyPress, 0x41});
+  cpu_->Tick();
+  cpu_->Tick();
+  cpu_->Tick();
+  cpu_->NotifyFramePresented();
+
+  const auto& histogram = cpu_->latency_stats().input_to_present;
+  ASSERT_EQ(histogram.count(), 1u);
+  EXPECT_EQ(histogram.max(), 3u);
+}
+
+TEST_F(InputDeviceTest, HostEventsWaitForTheirCycle) {
+  const uint64_t due = cpu_->cycle_count() + 3;
+  device_->PostHostEvent({HostInputEvent::Kind::KeyPress, 0x01, due});
+  // Stamped earlier, but queued behind the future event.
+  device_->PostHostEvent({HostInputEvent::Kind::KeyPress, 0x02, 0});
+
+  while (cpu_->cycle_count() < due) {
+    cpu_->Tick();
+    EXPECT_TRUE(device_->empty());
+  }
+  cpu_->Tick();
+  ASSERT_EQ(device_->count(), 2);
+  EXPECT_EQ(device_->Read(Word{input_reg::DATA}).value(), 0x01);
+  EXPECT_EQ(device_->Read(Word{input_reg::DATA}).value(), 0x02);
+}
+
+TEST_F(InputDeviceTest, DisabledHostEventsStayQueued) {
+  device_->set_host_events_enabled(false);
+  device_->PostHostEvent({HostInputEvent::Kind::KeyPress, 0x41});
+  cpu_->Tick();
+  EXPECT_TRUE(device_->empty());
+
+  device_->set_host_events_enabled(true);
+  cpu_->Tick();
+  EXPECT_EQ(device_->count(), 1);
+}
+
+TEST_F(InputDeviceTest, HostEventsFromAnotherThreadArriveInOrder) {
+  constexpr int kEvents = 500;
+  // The guest queue drops keys once it holds 16, so the producer stays at
+  // most that far ahead of what the CPU side has consumed.
+  std::atomic<int> received{0};
+  std::thread producer([this, &received] {
+    for (int i = 0; i < kEvents; ++i) {
+      while (i - received.load() >= static_cast<int>(InputDevice::QUEUE_SIZE)) {
+        std::this_thread::yield();
+      }
+      const HostInputEvent event{HostInputEvent::Kind::KeyPress,
+                                 static_cast<uint8_t>(i)};
+      while (!device_->PostHostEvent(event)) {
+        std::this_thread::yield();
+      }
+    }
+  });
+
+  while (received.load() < kEvents) {
+    cpu_->Tick();
+    while (!device_->empty()) {
+      ASSERT_EQ(device_->Read(Word{input_reg::DATA}).value(),
+                static_cast<uint8_t>(received.load()));
+      received.fetch_add(1);
+    }
+  }
+  producer.join();
+}
+
+TEST_F(InputDeviceTest, LoadStateRejectsQueueIndicesOutOfRange) {
+  device_->inject_key(0x41);
+  std::vector<uint8_t> saved;
+  SnapshotWriter out(saved);
+  device_->SaveState(out);
+
+  // The state ends with read_idx, write_idx and count (size_t each), then
+  // irq_enabled and key_state (one byte each).
+  const size_t count_offset = saved.size() - 2 - sizeof(size_t);
+  const size_t read_offset = count_offset - 2 * sizeof(size_t);
+  auto load = [this](const std::vector<uint8_t>& bytes) {
+    SnapshotReader in(bytes);
+    device_->LoadState(in);
+  };
+
+  EXPECT_NO_THROW(load(saved));
+  EXPECT_EQ(device_->count(), 1u);
+
+  auto bad_count = saved;
+  const size_t count = InputDevice::QUEUE_SIZE + 1;
+  std::memcpy(bad_count.data() + count_offset, &count, sizeof(count));
+  EXPECT_THROW(load(bad_count), SimError);
+
+  auto bad_index = saved;
+  const size_t index = InputDevice::QUEUE_SIZE;
+  std::memcpy(bad_index.data() + read_offset, &index, sizeof(index));
+  EXPECT_THROW(load(bad_index), SimError);
+}
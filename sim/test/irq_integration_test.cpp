@@ -1,12 +1,14 @@
 #include "irata2/assembler/assembler.h"
 #include "irata2/sim.h"
 #include "irata2/sim/control.h"
+#include "irata2/sim/guest_timeline.h"
 #include "irata2/sim/memory/module.h"
 #include "test_helpers.h"
 
 #include <gtest/gtest.h>
 
 #include <memory>
+#include <sstream>
 
 using irata2::assembler::Assemble;
 using irata2::assembler::AssemblerResult;
@@ -88,6 +90,39 @@ void InitializeCpu(Cpu& cpu, Word entry) {
   cpu.controller().sc().set_value(Byte{0});
   cpu.controller().ir().set_value(cpu.memory().ReadAt(entry));
 }
+
+// Spins in a NOP loop; the handler acknowledges the device with one MMIO
+// read and returns.
+const char* kIrqMmioProgram = R"(
+    .org $8000
+    JMP main
+
+    .org $8011
+  main:
+    NOP
+    JMP main
+
+    .org $9000
+  irq_handler:
+    LDA $5001
+    RTI
+
+    .org $FFFE
+    .byte $00, $90
+)";
+
+IrqRig MakeAssembledIrqRig() {
+  AssemblerResult assembled = Assemble(kIrqMmioProgram, "irq_mmio.asm");
+  std::vector<Byte> rom;
+  rom.reserve(assembled.rom.size());
+  for (uint8_t value : assembled.rom) {
+    rom.push_back(Byte{value});
+  }
+
+  IrqRig rig = MakeCpuWithIrqDevice(rom);
+  InitializeCpu(*rig.cpu, assembled.header.entry);
+  return rig;
+}
 }  // namespace
 
 TEST(IrqIntegrationTest, DeviceTriggersHandlerAndRtiReturns) {
@@ -134,3 +169,73 @@ TEST(IrqIntegrationTest, DeviceTriggersHandlerAndRtiReturns) {
   irata2::sim::test::SetPhase(*rig.cpu, irata2::base::TickPhase::Process);
   EXPECT_FALSE(rig.cpu->irq_line().asserted());
 }
+
+TEST(IrqIntegrationTest, PerfCountersTrackIrqsAndMmio) {
+  IrqRig rig = MakeAssembledIrqRig();
+  ASSERT_NE(rig.device, nullptr);
+  rig.cpu->RunUntilHalt(200);
+  EXPECT_EQ(rig.cpu->perf_counters().irqs_taken, 0u);
+  EXPECT_EQ(rig.cpu->perf_counters().irq_masked_cycles, 0u);
+
+  rig.cpu->ResetPerfCounters();
+  rig.device->Trigger();
+  rig.cpu->RunUntilHalt(500);
+
+  const auto perf = rig.cpu->perf_counters();
+  EXPECT_EQ(perf.irqs_taken, 1u);
+  EXPECT_GT(perf.irq_masked_cycles, 0u);
+  EXPECT_LT(perf.irq_masked_cycles, perf.cycles);
+  EXPECT_EQ(perf.mmio_accesses(), 1u);
+  for (const auto& region : perf.regions) {
+    if (region.name == "irq_device") {
+      EXPECT_TRUE(region.mmio);
+      EXPECT_EQ(region.reads, 1u);
+    }
+  }
+}
+
+TEST(IrqIntegrationTest, TimelineRecordsIrqLatencyAndMmio) {
+  IrqRig rig = MakeAssembledIrqRig();
+  ASSERT_NE(rig.device, nullptr);
+  irata2::sim::GuestTimeline timeline;
+  rig.cpu->AttachTimeline(&timeline);
+  rig.cpu->RunUntilHalt(200);
+  rig.device->Trigger();
+  rig.cpu->RunUntilHalt(500);
+
+  std::ostringstream out;
+  timeline.WriteChromeTrace(out);
+  const std::string trace = out.str();
+  EXPECT_NE(trace.find("\"name\": \"irq latency\""), std::string::npos);
+  EXPECT_NE(trace.find("\"handler\": \"$9000\""), std::string::npos);
+  EXPECT_NE(trace.find("\"name\": \"$9000\", \"cat\": \"irq\""),
+            std::string::npos);
+  EXPECT_NE(trace.find("\"name\": \"irq_device read\""), std::string::npos);
+  EXPECT_NE(trace.find("\"address\": \"0x5001\", \"value\": \"0xAA\""),
+            std::string::npos);
+  EXPECT_EQ(trace.find("irq pending"), std::string::npos);
+}
+
+TEST(IrqIntegrationTest, LatencyStatsMeasureIrqEntryAndHandler) {
+  IrqRig rig = MakeAssembledIrqRig();
+  ASSERT_NE(rig.device, nullptr);
+  rig.cpu->set_latency_tracking(true);
+  rig.cpu->RunUntilHalt(200);
+  const uint64_t triggered_at = rig.cpu->cycle_count();
+  rig.device->Trigger();
+  rig.cpu->RunUntilHalt(500);
+
+  // The device holds the line until the handler reads $5001; that is still
+  // one request.
+  const auto& latency = rig.cpu->latency_stats();
+  ASSERT_EQ(latency.irq_entry.count(), 1u);
+  ASSERT_EQ(latency.irq_handler.count(), 1u);
+  // At most one instruction of the main loop runs before the entry.
+  EXPECT_LT(latency.irq_entry.max(), 32u);
+  EXPECT_GT(latency.irq_handler.min(), latency.irq_entry.max());
+  EXPECT_LT(latency.irq_entry.max() + latency.irq_handler.max(),
+            rig.cpu->cycle_count() - triggered_at);
+
+  rig.cpu->ResetLatencyStats();
+  EXPECT_EQ(rig.cpu->latency_stats().irq_entry.count(), 0u);
+}
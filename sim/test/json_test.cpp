@@ -0,0 +1,17 @@
+#include "irata2/sim/json.h"
+
+#include <gtest/gtest.h>
+
+#include <string>
+
+using irata2::sim::EscapeJson;
+
+TEST(JsonTest, EscapesQuotesBackslashesAndControlCharacters) {
+  EXPECT_EQ(EscapeJson("main+4"), "main+4");
+  EXPECT_EQ(EscapeJson("a\"b\\c"), "a\\\"b\\\\c");
+  EXPECT_EQ(EscapeJson("line\nnext\ttab\rret"),
+            "line\\u000anext\\u0009tab\\u000dret");
+  EXPECT_EQ(EscapeJson(std::string("\x01\x1f", 2)), "\\u0001\\u001f");
+  EXPECT_EQ(EscapeJson(std::string(1, '\0')), "\\u0000");
+  EXPECT_EQ(EscapeJson("caf\xc3\xa9"), "caf\xc3\xa9");
+}
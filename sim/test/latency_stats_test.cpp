@@ -0,0 +1,109 @@
+#include "irata2/sim/latency_stats.h"
+
+#include "irata2/sim.h"
+#include "test_helpers.h"
+
+#include <gtest/gtest.h>
+
+#include <sstream>
+
+using namespace irata2::sim;
+
+namespace {
+
+constexpr const char* kLoopProgram = R"(
+  loop:
+    NOP
+    JMP loop
+)";
+
+}  // namespace
+
+TEST(LatencyHistogramTest, BucketsByPowerOfTwo) {
+  LatencyHistogram histogram;
+  histogram.Record(0);
+  histogram.Record(1);
+  histogram.Record(5);
+  histogram.Record(7);
+  histogram.Record(8);
+
+  EXPECT_EQ(histogram.count(), 5u);
+  EXPECT_EQ(histogram.min(), 0u);
+  EXPECT_EQ(histogram.max(), 8u);
+  EXPECT_DOUBLE_EQ(histogram.mean(), 4.2);
+  EXPECT_EQ(histogram.buckets()[0], 1u);
+  EXPECT_EQ(histogram.buckets()[1], 1u);
+  EXPECT_EQ(histogram.buckets()[3], 2u);  // 4..7
+  EXPECT_EQ(histogram.buckets()[4], 1u);  // 8..15
+  EXPECT_EQ(LatencyHistogram::BucketLow(3), 4u);
+  EXPECT_EQ(LatencyHistogram::BucketHigh(3), 7u);
+}
+
+TEST(LatencyHistogramTest, PercentilesUseBucketUpperBoundClampedToMax) {
+  LatencyHistogram histogram;
+  EXPECT_EQ(histogram.Percentile(0.5), 0u);
+  for (uint64_t cycles = 1; cycles <= 100; ++cycles) {
+    histogram.Record(cycles);
+  }
+  EXPECT_EQ(histogram.Percentile(0.5), 63u);
+  EXPECT_EQ(histogram.Percentile(0.99), 100u);
+  EXPECT_EQ(histogram.Percentile(0.0), 1u);
+
+  std::ostringstream out;
+  histogram.WriteText(out, "sample");
+  EXPECT_EQ(out.str().rfind("sample: count=100 min=1", 0), 0u);
+}
+
+TEST(LatencyStatsTest, InputToPresentCountsEveryPendingInput) {
+  auto cpu = test::MakeAssembledCpu(kLoopProgram);
+  cpu->set_latency_tracking(true);
+  cpu->NotifyHostInput();
+  for (int i = 0; i < 5; ++i) {
+    cpu->Tick();
+  }
+  cpu->NotifyHostInput();
+  for (int i = 0; i < 3; ++i) {
+    cpu->Tick();
+  }
+  cpu->NotifyFramePresented();
+
+  const auto& histogram = cpu->latency_stats().input_to_present;
+  ASSERT_EQ(histogram.count(), 2u);
+  EXPECT_EQ(histogram.min(), 3u);
+  EXPECT_EQ(histogram.max(), 8u);
+
+  // A present with no input in flight adds nothing.
+  cpu->NotifyFramePresented();
+  EXPECT_EQ(histogram.count(), 2u);
+}
+
+TEST(LatencyStatsTest, TrackingIsOffByDefault) {
+  auto cpu = test::MakeAssembledCpu(kLoopProgram);
+  EXPECT_FALSE(cpu->latency_tracking());
+  cpu->NotifyHostInput();
+  cpu->Tick();
+  cpu->NotifyFramePresented();
+  EXPECT_EQ(cpu->latency_stats().input_to_present.count(), 0u);
+}
+
+TEST(LatencyStatsTest, DisabledTrackingRecordsNothing) {
+  auto cpu = test::MakeAssembledCpu(kLoopProgram);
+  cpu->set_latency_tracking(true);
+  cpu->set_latency_tracking(false);
+  cpu->NotifyHostInput();
+  cpu->Tick();
+  cpu->NotifyFramePresented();
+  cpu->set_latency_tracking(true);
+  cpu->NotifyFramePresented();
+  EXPECT_EQ(cpu->latency_stats().input_to_present.count(), 0u);
+}
+
+TEST(LatencyStatsTest, PendingInputsAreCapped) {
+  auto cpu = test::MakeAssembledCpu(kLoopProgram);
+  cpu->set_latency_tracking(true);
+  for (int i = 0; i < 1000; ++i) {
+    cpu->NotifyHostInput();
+  }
+  cpu->NotifyFramePresented();
+  EXPECT_EQ(cpu->latency_stats().input_to_present.count(), 256u);
+}
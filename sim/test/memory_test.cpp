@@ -105,6 +105,34 @@ TEST(SimMemoryTest, WriteUnmappedThrows) {
                SimError);
 }
 
+TEST(SimMemoryTest, ContentsAtViewsRamBackingStore) {
+  Cpu sim = test::MakeTestCpu();
+  sim.memory().WriteAt(irata2::base::Word{0x0010}, irata2::base::Byte{0x42});
+
+  auto view = sim.memory().MutableContentsAt(irata2::base::Word{0x0010}, 4);
+  ASSERT_EQ(view.size(), 4u);
+  EXPECT_EQ(view[0], irata2::base::Byte{0x42});
+  view[1] = irata2::base::Byte{0x99};
+  EXPECT_EQ(sim.memory().ReadAt(irata2::base::Word{0x0011}),
+            irata2::base::Byte{0x99});
+}
+
+TEST(SimMemoryTest, ContentsAtRejectsRangesLeavingRegion) {
+  Cpu sim = test::MakeTestCpu();
+  EXPECT_TRUE(
+      sim.memory().ContentsAt(irata2::base::Word{0x1FFE}, 4).empty());
+  EXPECT_TRUE(
+      sim.memory().ContentsAt(irata2::base::Word{0x4000}, 1).empty());
+}
+
+TEST(SimMemoryTest, RomContentsAreReadOnly) {
+  Cpu sim = test::MakeTestCpu();
+  EXPECT_EQ(sim.memory().ContentsAt(irata2::base::Word{0x8000}, 16).size(),
+            16u);
+  EXPECT_TRUE(
+      sim.memory().MutableContentsAt(irata2::base::Word{0x8000}, 16).empty());
+}
+
 TEST(SimMemoryTest, WritesThroughBusToRam) {
   Cpu sim = test::MakeTestCpu();
 
@@ -0,0 +1,108 @@
+#include "irata2/sim/perf_counters.h"
+
+#include "irata2/sim.h"
+#include "test_helpers.h"
+
+#include <gtest/gtest.h>
+
+#include <sstream>
+
+using namespace irata2::sim;
+using irata2::base::Byte;
+using irata2::base::Word;
+
+namespace {
+
+const PerfCounters::RegionAccesses* FindRegion(const PerfCounters& perf,
+                                               const std::string& name) {
+  for (const auto& region : perf.regions) {
+    if (region.name == name) {
+      return &region;
+    }
+  }
+  return nullptr;
+}
+
+constexpr const char* kProgram = R"(
+    LDA $0200
+    STA $0201
+    STA $0202
+    HLT
+)";
+
+}  // namespace
+
+TEST(PerfCountersTest, CountsInstructionsAndCycles) {
+  auto cpu = test::MakeAssembledCpu(kProgram);
+  const auto result = cpu->RunUntilHalt(1000);
+  ASSERT_EQ(result.reason, Cpu::HaltReason::Halt);
+
+  const PerfCounters perf = cpu->perf_counters();
+  EXPECT_EQ(perf.cycles, cpu->cycle_count());
+  EXPECT_EQ(perf.instructions, 4u);
+  EXPECT_DOUBLE_EQ(perf.cycles_per_instruction(),
+                   static_cast<double>(perf.cycles) / 4.0);
+  EXPECT_GT(perf.data_bus_cycles, 0u);
+  EXPECT_LE(perf.data_bus_cycles, perf.cycles);
+  EXPECT_GT(perf.address_bus_cycles, 0u);
+  EXPECT_LE(perf.address_bus_cycles, perf.cycles);
+  EXPECT_EQ(perf.irqs_taken, 0u);
+  EXPECT_EQ(perf.irq_masked_cycles, 0u);
+}
+
+TEST(PerfCountersTest, CountsBusAccessesPerRegion) {
+  auto cpu = test::MakeAssembledCpu(kProgram);
+  cpu->RunUntilHalt(1000);
+  // Host-side accesses are not counted.
+  cpu->memory().ReadAt(Word{0x0200});
+  cpu->memory().WriteAt(Word{0x0203}, Byte{0x01});
+
+  const PerfCounters perf = cpu->perf_counters();
+  const auto* ram = FindRegion(perf, "ram");
+  const auto* cartridge = FindRegion(perf, "cartridge");
+  ASSERT_NE(ram, nullptr);
+  ASSERT_NE(cartridge, nullptr);
+  EXPECT_FALSE(ram->mmio);
+  EXPECT_EQ(ram->reads, 1u);
+  EXPECT_EQ(ram->writes, 2u);
+  EXPECT_EQ(cartridge->writes, 0u);
+  // Opcodes and operands are fetched from the cartridge.
+  EXPECT_GE(cartridge->reads, 4u + 3u * 2u);
+  EXPECT_EQ(perf.memory_writes(), 2u);
+  EXPECT_EQ(perf.memory_reads(), ram->reads + cartridge->reads);
+}
+
+TEST(PerfCountersTest, ResetStartsAFreshSample) {
+  auto cpu = test::MakeAssembledCpu(kProgram);
+  cpu->RunUntilHalt(1000);
+  ASSERT_GT(cpu->perf_counters().instructions, 0u);
+
+  cpu->ResetPerfCounters();
+  const PerfCounters perf = cpu->perf_counters();
+  EXPECT_EQ(perf.cycles, 0u);
+  EXPECT_EQ(perf.instructions, 0u);
+  EXPECT_EQ(perf.data_bus_cycles, 0u);
+  EXPECT_EQ(perf.memory_reads(), 0u);
+  EXPECT_EQ(perf.memory_writes(), 0u);
+  EXPECT_DOUBLE_EQ(perf.cycles_per_instruction(), 0.0);
+  EXPECT_DOUBLE_EQ(perf.data_bus_utilization(), 0.0);
+  // The cycle counter itself is architectural state and is not reset.
+  EXPECT_GT(cpu->cycle_count(), 0u);
+}
+
+TEST(PerfCountersTest, ReportsTextAndJson) {
+  auto cpu = test::MakeAssembledCpu(kProgram);
+  cpu->RunUntilHalt(1000);
+  const PerfCounters perf = cpu->perf_counters();
+
+  std::ostringstream text;
+  perf.WriteText(text);
+  EXPECT_NE(text.str().find("instructions: 4\n"), std::string::npos);
+  EXPECT_NE(text.str().find("ram @0x0000: reads=1 writes=2"),
+            std::string::npos);
+
+  std::ostringstream json;
+  perf.WriteJson(json);
+  EXPECT_NE(json.str().find("\"instructions\": 4,"), std::string::npos);
+  EXPECT_NE(json.str().find("\"name\": \"ram\""), std::string::npos);
+}
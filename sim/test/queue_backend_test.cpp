@@ -0,0 +1,73 @@
+#include "irata2/sim/io/queue_backend.h"
+
+#include <gtest/gtest.h>
+
+#include <vector>
+
+using namespace irata2::sim::io;
+
+TEST(QueueBackendTest, PresentPushesFrameInOrder) {
+  QueueBackend::FrameQueue queue;
+  QueueBackend backend(queue);
+
+  backend.clear(0x00);
+  backend.draw_line(1, 2, 3, 4, 0x03);
+  backend.present();
+  backend.draw_point(5, 6, 0x01);
+  backend.present();
+
+  auto first = queue.TryPop();
+  ASSERT_TRUE(first.has_value());
+  EXPECT_EQ(first->sequence, 0u);
+  EXPECT_EQ(first->commands,
+            (std::vector<VgcCommand>{{VgcOp::Clear, 0, 0, 0, 0, 0x00},
+                                     {VgcOp::Line, 1, 2, 3, 4, 0x03}}));
+
+  auto second = queue.TryPop();
+  ASSERT_TRUE(second.has_value());
+  EXPECT_EQ(second->sequence, 1u);
+  EXPECT_EQ(second->commands,
+            (std::vector<VgcCommand>{{VgcOp::Point, 5, 6, 0, 0, 0x01}}));
+  EXPECT_EQ(backend.frames_pushed(), 2u);
+}
+
+TEST(QueueBackendTest, ClearInBatchDiscardsEarlierCommands) {
+  QueueBackend::FrameQueue queue;
+  QueueBackend backend(queue);
+
+  const std::vector<VgcCommand> batch = {
+      {VgcOp::Point, 1, 1, 0, 0, 0x03},
+      {VgcOp::Clear, 0, 0, 0, 0, 0x00},
+      {VgcOp::Point, 2, 2, 0, 0, 0x02},
+  };
+  backend.submit(batch);
+  backend.present();
+
+  auto frame = queue.TryPop();
+  ASSERT_TRUE(frame.has_value());
+  EXPECT_EQ(frame->commands.size(), 2u);
+  EXPECT_EQ(frame->commands.front().op, VgcOp::Clear);
+}
+
+TEST(QueueBackendTest, FullQueueDropsNewFrameWithoutBlocking) {
+  QueueBackend::FrameQueue queue;
+  QueueBackend backend(queue);
+
+  for (size_t i = 0; i < QueueBackend::kQueueDepth + 2; ++i) {
+    backend.draw_point(static_cast<uint8_t>(i), 0, 0x01);
+    backend.present();
+  }
+  EXPECT_EQ(backend.frames_pushed(), QueueBackend::kQueueDepth);
+  EXPECT_EQ(backend.frames_dropped(), 2u);
+
+  // The queued frames are the oldest ones; the dropped frame's commands do
+  // not leak into the next frame.
+  while (queue.TryPop()) {
+  }
+  backend.draw_point(9, 9, 0x02);
+  backend.present();
+  auto frame = queue.TryPop();
+  ASSERT_TRUE(frame.has_value());
+  EXPECT_EQ(frame->commands.size(), 1u);
+  EXPECT_EQ(frame->sequence, QueueBackend::kQueueDepth + 2);
+}
@@ -0,0 +1,58 @@
+#include "irata2/sim/retired_instruction.h"
+
+#include "irata2/sim.h"
+#include "test_helpers.h"
+
+#include <gtest/gtest.h>
+
+#include <vector>
+
+using namespace irata2::sim;
+using Kind = RetiredInstruction::Kind;
+
+namespace {
+
+std::vector<Kind> RetiredKinds(std::string_view program) {
+  auto cpu = test::MakeAssembledCpu(program);
+  RetiredInstructionTracker tracker;
+  std::vector<Kind> kinds;
+  for (int cycle = 0; cycle < 10000 && !cpu->halted(); ++cycle) {
+    cpu->Tick();
+    if (cpu->instruction_started()) {
+      kinds.push_back(
+          tracker.OnInstructionStart(cpu->controller().ir()).kind);
+    }
+  }
+  EXPECT_TRUE(cpu->halted());
+  return kinds;
+}
+
+}  // namespace
+
+TEST(RetiredInstructionTest, ReportsCallsAndReturns) {
+  const auto kinds = RetiredKinds(R"(
+    JSR sub
+    HLT
+sub:
+    LDA #$01
+    RTS
+)");
+  const std::vector<Kind> expected = {Kind::None, Kind::Jsr, Kind::Other,
+                                      Kind::Rts};
+  EXPECT_EQ(kinds, expected);
+}
+
+TEST(RetiredInstructionTest, FirstStartHasNothingRetired) {
+  RetiredInstruction retired;
+  EXPECT_EQ(retired.kind, Kind::None);
+  EXPECT_FALSE(retired.is_instruction());
+  EXPECT_FALSE(retired.opens_frame());
+  EXPECT_FALSE(retired.closes_frame());
+}
+
+TEST(RetiredInstructionTest, IrqEntryOpensFrameWithoutOpcode) {
+  RetiredInstruction retired;
+  retired.kind = Kind::IrqEntry;
+  EXPECT_FALSE(retired.is_instruction());
+  EXPECT_TRUE(retired.opens_frame());
+}
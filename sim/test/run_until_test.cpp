@@ -0,0 +1,96 @@
+#include "irata2/sim.h"
+#include "test_helpers.h"
+
+#include <gtest/gtest.h>
+
+#include <memory>
+
+using irata2::base::Byte;
+using irata2::base::Word;
+using irata2::sim::Cpu;
+using irata2::sim::memory::AddressRange;
+using irata2::sim::test::MakeAssembledVgcRig;
+
+namespace {
+
+// Offsets: LDA #imm is 2 bytes, STA/LDA abs are 3 bytes.
+constexpr uint16_t kTargetOffset = 5;
+
+const char* kProgram = R"(
+    LDA #$01
+    STA $0200
+  target:
+    LDA #$02
+    STA $4107
+    LDA $0300
+    HLT
+)";
+
+}  // namespace
+
+TEST(RunUntilTest, StopsOnFramePresented) {
+  auto cpu = MakeAssembledVgcRig(kProgram).cpu;
+
+  Cpu::StopConditions conditions;
+  conditions.frame_presented = true;
+  conditions.max_cycles = 1000;
+  const auto result = cpu->RunUntil(conditions);
+
+  EXPECT_EQ(result.reason, Cpu::HaltReason::FramePresented);
+  EXPECT_EQ(cpu->frames_presented(), 1u);
+  EXPECT_EQ(cpu->memory().ReadAt(Word{0x0200}), Byte{0x01});
+  EXPECT_FALSE(cpu->halted());
+
+  const auto rest = cpu->RunUntil(conditions);
+  EXPECT_EQ(rest.reason, Cpu::HaltReason::Halt);
+  EXPECT_EQ(result.cycles + rest.cycles, cpu->cycle_count());
+}
+
+TEST(RunUntilTest, StopsWhenInstructionStartsAtTargetPc) {
+  auto cpu = MakeAssembledVgcRig(kProgram).cpu;
+  const Word entry = cpu->pc().value();
+  const Word target = entry + Word{kTargetOffset};
+
+  Cpu::StopConditions conditions;
+  conditions.target_pc = target;
+  conditions.capture_state = true;
+  const auto result = cpu->RunUntil(conditions);
+
+  EXPECT_EQ(result.reason, Cpu::HaltReason::TargetPc);
+  EXPECT_EQ(cpu->instruction_address(), target);
+  EXPECT_EQ(cpu->frames_presented(), 0u);
+  ASSERT_TRUE(result.state.has_value());
+  EXPECT_EQ(result.state->a, Byte{0x01});
+}
+
+TEST(RunUntilTest, StopsAfterBusAccessToWatchedRange) {
+  auto cpu = MakeAssembledVgcRig(kProgram).cpu;
+
+  Cpu::StopConditions conditions;
+  conditions.memory_access = AddressRange{Word{0x0300}, Word{0x0300}};
+  const auto result = cpu->RunUntil(conditions);
+
+  EXPECT_EQ(result.reason, Cpu::HaltReason::MemoryAccess);
+  EXPECT_EQ(cpu->frames_presented(), 1u);
+  EXPECT_FALSE(cpu->halted());
+  EXPECT_FALSE(cpu->memory().access_watch_hit());
+}
+
+TEST(RunUntilTest, HostReadsDoNotTriggerWatch) {
+  auto cpu = MakeAssembledVgcRig(kProgram).cpu;
+  cpu->memory().set_access_watch(AddressRange{Word{0x0300}, Word{0x03FF}});
+  cpu->memory().ReadAt(Word{0x0300});
+  cpu->memory().WriteAt(Word{0x0301}, Byte{0x01});
+  EXPECT_FALSE(cpu->memory().access_watch_hit());
+}
+
+TEST(RunUntilTest, CycleBudgetTimesOut) {
+  auto cpu = MakeAssembledVgcRig(kProgram).cpu;
+
+  Cpu::StopConditions conditions;
+  conditions.max_cycles = 3;
+  const auto result = cpu->RunUntil(conditions);
+
+  EXPECT_EQ(result.reason, Cpu::HaltReason::Timeout);
+  EXPECT_EQ(result.cycles, 3u);
+}
@@ -0,0 +1,223 @@
+#include "irata2/sim/snapshot.h"
+
+#include <gtest/gtest.h>
+
+#include <cstring>
+#include <memory>
+
+#include "irata2/sim.h"
+#include "irata2/sim/error.h"
+#include "irata2/sim/io/input_device.h"
+#include "irata2/sim/io/vector_graphics_coprocessor.h"
+#include "irata2/sim/io/vgc_backend.h"
+#include "test_helpers.h"
+
+using namespace irata2::sim;
+using namespace irata2::sim::io;
+using namespace irata2::base;
+
+namespace {
+
+const char* kProgram = R"(
+  loop:
+    INC $0200
+    LDA $4005
+    STA $0201
+    LDA $0200
+    STA $4101
+    LDA #$02
+    STA $4100
+    STA $4105
+    LDA #$01
+    STA $4106
+    LDA #$02
+    STA $4107
+    JSR bump
+    JMP loop
+  bump:
+    INX
+    RTS
+)";
+
+struct Rig {
+  std::unique_ptr<Cpu> cpu;
+  InputDevice* input = nullptr;
+  VectorGraphicsCoprocessor* vgc = nullptr;
+  ImageBackend* backend = nullptr;
+};
+
+Rig MakeRig(bool with_input = true) {
+  Rig rig;
+  std::vector<memory::Memory::RegionFactory> factories;
+  if (with_input) {
+    factories.push_back([&rig](memory::Memory& m, LatchedProcessControl& irq)
+                            -> std::unique_ptr<memory::Region> {
+      return std::make_unique<memory::Region>(
+          "input", m, Word{INPUT_DEVICE_BASE},
+          [&rig, &irq](memory::Region& r) -> std::unique_ptr<memory::Module> {
+            auto device = std::make_unique<InputDevice>("input", r, irq);
+            rig.input = device.get();
+            return device;
+          });
+    });
+  }
+  factories.push_back([&rig](memory::Memory& m, LatchedProcessControl&)
+                          -> std::unique_ptr<memory::Region> {
+    return std::make_unique<memory::Region>(
+        "vgc", m, Word{VGC_BASE},
+        [&rig](memory::Region& r) -> std::unique_ptr<memory::Module> {
+          auto backend = std::make_unique<ImageBackend>();
+          rig.backend = backend.get();
+          auto vgc = std::make_unique<VectorGraphicsCoprocessor>(
+              "vgc", r, std::move(backend));
+          rig.vgc = vgc.get();
+          return vgc;
+        });
+  });
+
+  rig.cpu = test::MakeAssembledCpu(kProgram, std::move(factories));
+  return rig;
+}
+
+void ExpectSameState(const Cpu::CpuState& a, const Cpu::CpuState& b) {
+  EXPECT_EQ(a.a, b.a);
+  EXPECT_EQ(a.x, b.x);
+  EXPECT_EQ(a.y, b.y);
+  EXPECT_EQ(a.sp, b.sp);
+  EXPECT_EQ(a.tmp, b.tmp);
+  EXPECT_EQ(a.pc, b.pc);
+  EXPECT_EQ(a.ir, b.ir);
+  EXPECT_EQ(a.sc, b.sc);
+  EXPECT_EQ(a.status, b.status);
+  EXPECT_EQ(a.cycle_count, b.cycle_count);
+}
+
+}  // namespace
+
+TEST(SnapshotTest, WriterAndReaderRoundTrip) {
+  std::vector<uint8_t> buffer;
+  SnapshotWriter out(buffer);
+  out.Write(uint16_t{0x1234});
+  out.Write(true);
+  const Byte bytes[] = {Byte{1}, Byte{2}, Byte{3}};
+  out.WriteSpan(std::span<const Byte>(bytes));
+
+  SnapshotReader in(buffer);
+  uint16_t word = 0;
+  bool flag = false;
+  Byte back[3];
+  in.Read(word);
+  in.Read(flag);
+  in.ReadSpan(std::span<Byte>(back));
+  EXPECT_EQ(word, 0x1234);
+  EXPECT_TRUE(flag);
+  EXPECT_EQ(back[2], Byte{3});
+  EXPECT_TRUE(in.at_end());
+
+  uint8_t extra = 0;
+  EXPECT_THROW(in.Read(extra), SimError);
+}
+
+TEST(SnapshotTest, RestoreReplaysIdentically) {
+  Rig rig = MakeRig();
+  rig.cpu->RunUntilHalt(500);
+  rig.input->set_key_down(key_state_bits::LEFT);
+
+  Cpu::Snapshot snapshot;
+  rig.cpu->SaveSnapshot(snapshot);
+  const uint64_t frames_before = rig.cpu->frames_presented();
+
+  rig.cpu->RunUntilHalt(1500);
+  const auto first = rig.cpu->CaptureState();
+  const Byte counter = rig.cpu->memory().ReadAt(Word{0x0200});
+  const uint64_t frames_after = rig.cpu->frames_presented();
+  EXPECT_GT(frames_after, frames_before);
+  EXPECT_EQ(rig.cpu->memory().ReadAt(Word{0x0201}),
+            Byte{key_state_bits::LEFT});
+
+  rig.cpu->RestoreSnapshot(snapshot);
+  EXPECT_EQ(rig.cpu->frames_presented(), frames_before);
+  rig.cpu->RunUntilHalt(1500);
+  ExpectSameState(rig.cpu->CaptureState(), first);
+  EXPECT_EQ(rig.cpu->memory().ReadAt(Word{0x0200}), counter);
+  EXPECT_EQ(rig.cpu->frames_presented(), frames_after);
+}
+
+TEST(SnapshotTest, RestoreRewindsDeviceState) {
+  Rig rig = MakeRig();
+  Cpu::Snapshot snapshot;
+  rig.cpu->SaveSnapshot(snapshot);
+
+  rig.input->inject_key(0x41);
+  rig.input->set_key_down(key_state_bits::SPACE);
+  rig.vgc->Write(Word{vgc_reg::COLOR}, Byte{0x03});
+  EXPECT_EQ(rig.input->count(), 1u);
+
+  rig.cpu->RestoreSnapshot(snapshot);
+  EXPECT_EQ(rig.input->count(), 0u);
+  EXPECT_EQ(rig.input->key_state(), 0u);
+  EXPECT_EQ(rig.vgc->Read(Word{vgc_reg::COLOR}), Byte{0x00});
+}
+
+TEST(SnapshotTest, RejectsSnapshotFromDifferentMachine) {
+  Rig with_input = MakeRig(true);
+  Rig without_input = MakeRig(false);
+
+  Cpu::Snapshot snapshot;
+  with_input.cpu->SaveSnapshot(snapshot);
+  EXPECT_THROW(without_input.cpu->RestoreSnapshot(snapshot), SimError);
+
+  snapshot.bytes.pop_back();
+  EXPECT_THROW(with_input.cpu->RestoreSnapshot(snapshot), SimError);
+}
+
+TEST(SnapshotTest, DisabledVgcOutputStillCountsFrames) {
+  Rig rig = MakeRig();
+  rig.vgc->set_output_enabled(false);
+
+  Cpu::StopConditions conditions;
+  conditions.frame_presented = true;
+  conditions.max_cycles = 5000;
+  EXPECT_EQ(rig.cpu->RunUntil(conditions).reason,
+            Cpu::HaltReason::FramePresented);
+  EXPECT_EQ(rig.backend->recorded_commands(), 0u);
+
+  rig.vgc->set_output_enabled(true);
+  EXPECT_EQ(rig.cpu->RunUntil(conditions).reason,
+            Cpu::HaltReason::FramePresented);
+  EXPECT_EQ(rig.backend->recorded_commands(), 1u);
+}
+
+TEST(SnapshotTest, RejectsVgcStreamFillOutOfRange) {
+  Rig rig = MakeRig();
+  auto save = [&rig] {
+    std::vector<uint8_t> bytes;
+    SnapshotWriter out(bytes);
+    rig.vgc->SaveState(out);
+    return bytes;
+  };
+  auto load = [&rig](const std::vector<uint8_t>& bytes) {
+    SnapshotReader in(bytes);
+    rig.vgc->LoadState(in);
+  };
+
+  // A zero byte on the stream port only advances the fill count, so the
+  // first differing byte is the low byte of stream_fill_.
+  const auto empty = save();
+  rig.vgc->Write(Word{vgc_reg::STREAM}, Byte{0x00});
+  const auto saved = save();
+  ASSERT_EQ(empty.size(), saved.size());
+  size_t fill_offset = 0;
+  while (fill_offset < saved.size() &&
+         empty[fill_offset] == saved[fill_offset]) {
+    ++fill_offset;
+  }
+  ASSERT_LT(fill_offset, saved.size());
+
+  EXPECT_NO_THROW(load(saved));
+
+  auto bad_fill = saved;
+  const size_t fill = vgc_packed::kCommandSize;
+  std::memcpy(bad_fill.data() + fill_offset, &fill, sizeof(fill));
+  EXPECT_THROW(load(bad_fill), SimError);
+}
@@ -0,0 +1,189 @@
+#include "irata2/sim.h"
+#include "irata2/sim/io/sound_device.h"
+#include "test_helpers.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <memory>
+#include <string>
+#include <vector>
+
+using irata2::base::Byte;
+using irata2::base::Word;
+using irata2::sim::Cpu;
+using irata2::sim::LatchedProcessControl;
+using irata2::sim::io::BufferSoundBackend;
+using irata2::sim::io::SOUND_BASE;
+using irata2::sim::io::SoundConfig;
+using irata2::sim::io::SoundDevice;
+using irata2::sim::io::WavSoundBackend;
+using irata2::sim::memory::Memory;
+using irata2::sim::memory::Region;
+namespace sound_reg = irata2::sim::io::sound_reg;
+
+namespace {
+// 8 kHz output from a 100 kHz CPU keeps the arithmetic easy to follow:
+// 12.5 cycles per sample, and a 1 kHz tone is 4 samples high, 4 low.
+constexpr SoundConfig kConfig{100000, 8000, 60};
+
+struct SoundRig {
+  std::unique_ptr<Cpu> cpu;
+  SoundDevice* sound = nullptr;
+  BufferSoundBackend* backend = nullptr;
+};
+
+SoundRig MakeCpuWithSound(const std::string& program) {
+  SoundRig rig;
+  std::vector<Memory::RegionFactory> factories;
+  factories.push_back([&rig](Memory& mem, LatchedProcessControl&)
+                          -> std::unique_ptr<Region> {
+    return std::make_unique<Region>(
+        "sound", mem, Word{SOUND_BASE},
+        [&rig](Region& region)
+            -> std::unique_ptr<irata2::sim::memory::Module> {
+          auto backend = std::make_unique<BufferSoundBackend>();
+          rig.backend = backend.get();
+          auto sound = std::make_unique<SoundDevice>(
+              "sound", region, std::move(backend), kConfig);
+          rig.sound = sound.get();
+          return sound;
+        });
+  });
+
+  rig.cpu = irata2::sim::test::MakeAssembledCpu(program, std::move(factories));
+  return rig;
+}
+
+void RunCycles(Cpu& cpu, uint64_t cycles) {
+  Cpu::StopConditions conditions;
+  conditions.max_cycles = cycles;
+  cpu.RunUntil(conditions);
+}
+
+constexpr const char* kSpin = R"(
+loop:
+    JMP loop
+)";
+}  // namespace
+
+TEST(SoundDeviceTest, GuestProgramPlaysSquareWave) {
+  SoundRig rig = MakeCpuWithSound(R"(
+    LDA #$E8
+    STA $4200
+    LDA #$03
+    STA $4201
+    LDA #$0F
+    STA $4203
+    LDA #$01
+    STA $4204
+loop:
+    JMP loop
+  )");
+  ASSERT_NE(rig.sound, nullptr);
+
+  RunCycles(*rig.cpu, 10000);
+  rig.sound->Sync();
+
+  const auto& samples = rig.backend->samples();
+  ASSERT_EQ(samples.size(), 800u);
+  EXPECT_EQ(rig.sound->samples_generated(), 800u);
+  EXPECT_EQ(samples.front(), 0);
+
+  const auto first = std::find_if(samples.begin(), samples.end(),
+                                  [](int16_t s) { return s != 0; });
+  ASSERT_NE(first, samples.end());
+  const size_t start = static_cast<size_t>(first - samples.begin());
+  for (size_t i = start; i < samples.size(); ++i) {
+    const bool high = ((i - start) % 8) < 4;
+    ASSERT_EQ(samples[i], high ? SoundDevice::kMaxAmplitude
+                               : -SoundDevice::kMaxAmplitude)
+        << "sample " << i;
+  }
+  EXPECT_TRUE(rig.sound->playing());
+}
+
+TEST(SoundDeviceTest, DurationEndsPlaybackWithoutTicking) {
+  SoundRig rig = MakeCpuWithSound(kSpin);
+  ASSERT_NE(rig.sound, nullptr);
+
+  rig.sound->Write(Word{sound_reg::FREQ_LO}, Byte{0xE8});
+  rig.sound->Write(Word{sound_reg::FREQ_HI}, Byte{0x03});
+  rig.sound->Write(Word{sound_reg::VOLUME}, Byte{0x0F});
+  rig.sound->Write(Word{sound_reg::DURATION}, Byte{6});  // 10000 cycles
+  rig.sound->Write(Word{sound_reg::CONTROL}, Byte{0x01});
+  EXPECT_EQ(rig.sound->Read(Word{sound_reg::STATUS}).value(), 0x01);
+
+  RunCycles(*rig.cpu, 20000);
+  EXPECT_EQ(rig.sound->Read(Word{sound_reg::STATUS}).value(), 0x00);
+  // Nothing is synthesized until the host asks for it.
+  EXPECT_EQ(rig.sound->samples_generated(), 0u);
+
+  rig.sound->Sync();
+  const auto& samples = rig.backend->samples();
+  ASSERT_EQ(samples.size(), 1600u);
+  const auto audible = std::count_if(samples.begin(), samples.end(),
+                                     [](int16_t s) { return s != 0; });
+  EXPECT_EQ(audible, 800);
+  EXPECT_EQ(samples[799], -SoundDevice::kMaxAmplitude);
+  EXPECT_EQ(samples[800], 0);
+}
+
+TEST(SoundDeviceTest, SubmitsFullBlocksThenRemainderOnSync) {
+  SoundRig rig = MakeCpuWithSound(kSpin);
+  ASSERT_NE(rig.sound, nullptr);
+
+  RunCycles(*rig.cpu, 10000);
+  // A register write catches up, handing over the complete block only.
+  rig.sound->Write(Word{sound_reg::VOLUME}, Byte{0x08});
+  EXPECT_EQ(rig.backend->blocks(), 1u);
+  EXPECT_EQ(rig.backend->samples().size(), SoundDevice::kBlockSize);
+
+  rig.sound->Sync();
+  EXPECT_EQ(rig.backend->blocks(), 2u);
+  EXPECT_EQ(rig.backend->samples().size(), 800u);
+}
+
+TEST(SoundDeviceTest, DisabledOutputKeepsTimingButDropsSamples) {
+  SoundRig rig = MakeCpuWithSound(kSpin);
+  ASSERT_NE(rig.sound, nullptr);
+
+  rig.sound->set_output_enabled(false);
+  RunCycles(*rig.cpu, 1000);
+  rig.sound->Sync();
+  EXPECT_EQ(rig.sound->samples_generated(), 80u);
+  EXPECT_TRUE(rig.backend->samples().empty());
+
+  rig.sound->set_output_enabled(true);
+  RunCycles(*rig.cpu, 1000);
+  rig.sound->Sync();
+  EXPECT_EQ(rig.backend->samples().size(), 80u);
+}
+
+TEST(SoundDeviceTest, WavBackendWritesPcmHeader) {
+  const std::string path = ::testing::TempDir() + "sound_device_test.wav";
+  {
+    WavSoundBackend wav(path, 8000);
+    const int16_t samples[] = {1, -1, 2, -2};
+    wav.submit(samples);
+    wav.Close();
+    EXPECT_EQ(wav.samples_written(), 4u);
+  }
+
+  std::ifstream input(path, std::ios::binary);
+  std::vector<uint8_t> data((std::istreambuf_iterator<char>(input)),
+                            std::istreambuf_iterator<char>());
+  std::remove(path.c_str());
+  ASSERT_EQ(data.size(), 44u + 8u);
+  EXPECT_EQ(std::string(data.begin(), data.begin() + 4), "RIFF");
+  EXPECT_EQ(std::string(data.begin() + 8, data.begin() + 12), "WAVE");
+  EXPECT_EQ(data[4], 44u);  // RIFF size = 36 + data
+  EXPECT_EQ(data[24], 0x40);  // 8000 Hz = 0x1F40
+  EXPECT_EQ(data[25], 0x1F);
+  EXPECT_EQ(data[40], 8u);  // data size
+  EXPECT_EQ(data[44], 1u);
+  EXPECT_EQ(data[46], 0xFFu);
+}
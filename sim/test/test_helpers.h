@@ -2,8 +2,14 @@
 #define IRATA2_SIM_TEST_HELPERS_H
 
 #include <memory>
+#include <string_view>
+#include <utility>
+#include <vector>
 
+#include "irata2/assembler/assembler.h"
 #include "irata2/sim.h"
+#include "irata2/sim/io/vector_graphics_coprocessor.h"
+#include "irata2/sim/io/vgc_backend.h"
 #include "irata2/microcode/encoder/control_encoder.h"
 #include "irata2/microcode/output/program.h"
 
@@ -28,6 +34,58 @@ inline Cpu MakeTestCpu() {
   return Cpu(DefaultHdl(), MakeNoopProgram());
 }
 
+/// Assembles @p source and builds a CPU on its ROM with @p factories
+/// mapped and the assembler's debug symbols loaded, ready to run from the
+/// entry point.
+inline std::unique_ptr<Cpu> MakeAssembledCpu(
+    std::string_view source,
+    std::vector<memory::Memory::RegionFactory> factories = {}) {
+  const auto assembled = assembler::Assemble(source, "test.asm");
+  std::vector<base::Byte> rom;
+  rom.reserve(assembled.rom.size());
+  for (uint8_t value : assembled.rom) {
+    rom.push_back(base::Byte{value});
+  }
+  auto cpu = std::make_unique<Cpu>(DefaultHdl(), DefaultMicrocodeProgram(),
+                                   std::move(rom), std::move(factories));
+  cpu->LoadDebugSymbols(ParseDebugSymbols(assembled.debug_json));
+  const base::Word entry = assembled.header.entry;
+  cpu->pc().set_value(entry);
+  cpu->controller().sc().set_value(base::Byte{0});
+  cpu->controller().ir().set_value(cpu->memory().ReadAt(entry));
+  return cpu;
+}
+
+/// CPU with a VGC mapped at VGC_BASE drawing into an ImageBackend.
+struct VgcRig {
+  std::unique_ptr<Cpu> cpu;
+  io::VectorGraphicsCoprocessor* vgc = nullptr;
+  io::ImageBackend* backend = nullptr;
+};
+
+/// MakeAssembledCpu() for @p source with a VGC mapped alongside any other
+/// @p factories.
+inline VgcRig MakeAssembledVgcRig(
+    std::string_view source,
+    std::vector<memory::Memory::RegionFactory> factories = {}) {
+  VgcRig rig;
+  factories.push_back([&rig](memory::Memory& mem, LatchedProcessControl&)
+                          -> std::unique_ptr<memory::Region> {
+    return std::make_unique<memory::Region>(
+        "vgc", mem, base::Word{io::VGC_BASE},
+        [&rig](memory::Region& region) -> std::unique_ptr<memory::Module> {
+          auto backend = std::make_unique<io::ImageBackend>();
+          rig.backend = backend.get();
+          auto vgc = std::make_unique<io::VectorGraphicsCoprocessor>(
+              "vgc", region, std::move(backend));
+          rig.vgc = vgc.get();
+          return vgc;
+        });
+  });
+  rig.cpu = MakeAssembledCpu(source, std::move(factories));
+  return rig;
+}
+
 inline void SetPhase(Cpu& cpu, base::TickPhase phase) {
   cpu.SetCurrentPhaseForTest(phase);
 }
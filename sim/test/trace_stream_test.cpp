@@ -0,0 +1,171 @@
+#include "irata2/sim/trace_stream.h"
+
+#include "irata2/isa/isa.h"
+#include "irata2/sim.h"
+#include "irata2/sim/error.h"
+#include "irata2/sim/varint.h"
+#include "test_helpers.h"
+
+#include <gtest/gtest.h>
+
+#include <sstream>
+
+using namespace irata2::sim;
+using irata2::base::Byte;
+using irata2::base::Word;
+
+namespace {
+
+TraceRecord Instruction(uint64_t cycle, uint16_t address, uint8_t opcode,
+                        uint8_t a) {
+  TraceRecord record;
+  record.cycle = cycle;
+  record.address = Word{address};
+  record.value = Byte{opcode};
+  record.a = Byte{a};
+  record.sp = Byte{0xFF};
+  return record;
+}
+
+TraceRecord Access(TraceRecord::Kind kind, uint64_t cycle, uint16_t address,
+                   uint8_t value) {
+  TraceRecord record;
+  record.kind = kind;
+  record.cycle = cycle;
+  record.address = Word{address};
+  record.value = Byte{value};
+  return record;
+}
+
+std::vector<TraceRecord> ReadAll(const std::string& data) {
+  std::istringstream in(data);
+  TraceStreamReader reader(in);
+  std::vector<TraceRecord> records;
+  while (auto record = reader.Next()) {
+    records.push_back(*record);
+  }
+  return records;
+}
+
+void ExpectSame(const TraceRecord& actual, const TraceRecord& expected) {
+  EXPECT_EQ(actual.kind, expected.kind);
+  EXPECT_EQ(actual.cycle, expected.cycle);
+  EXPECT_EQ(actual.address, expected.address);
+  EXPECT_EQ(actual.value, expected.value);
+  if (expected.kind == TraceRecord::Kind::Instruction) {
+    EXPECT_EQ(actual.a, expected.a);
+    EXPECT_EQ(actual.x, expected.x);
+    EXPECT_EQ(actual.y, expected.y);
+    EXPECT_EQ(actual.sp, expected.sp);
+    EXPECT_EQ(actual.status, expected.status);
+  }
+}
+
+}  // namespace
+
+TEST(TraceStreamTest, RoundTripsRecordsThroughTheWriterThread) {
+  std::vector<TraceRecord> records;
+  for (uint64_t i = 0; i < 50000; ++i) {
+    records.push_back(Instruction(i * 7, static_cast<uint16_t>(0x8000 + i % 64),
+                                  static_cast<uint8_t>(i), static_cast<uint8_t>(i / 3)));
+    records.push_back(Access(i % 2 ? TraceRecord::Kind::Write
+                                   : TraceRecord::Kind::Read,
+                             i * 7 + 3, static_cast<uint16_t>(0x0200 + i % 256),
+                             static_cast<uint8_t>(i * 5)));
+  }
+  // A snapshot restore can move the clock backwards.
+  records.push_back(Instruction(10, 0x8000, 0xEA, 0));
+
+  std::ostringstream out;
+  {
+    TraceStreamWriter writer(out);
+    for (const auto& record : records) {
+      writer.Append(record);
+    }
+    writer.Close();
+    EXPECT_EQ(writer.records_appended(), records.size());
+    EXPECT_EQ(writer.bytes_written(), out.str().size());
+  }
+
+  const auto decoded = ReadAll(out.str());
+  ASSERT_EQ(decoded.size(), records.size());
+  for (size_t i = 0; i < records.size(); ++i) {
+    ExpectSame(decoded[i], records[i]);
+  }
+  // Delta encoding keeps typical records far below their in-memory size.
+  EXPECT_LT(out.str().size(), records.size() * 8);
+}
+
+TEST(TraceStreamTest, VarintsRoundTripExtremes) {
+  const int64_t values[] = {0, 1, -1, 63, -64, 64, INT64_MAX, INT64_MIN};
+  for (const int64_t value : values) {
+    std::vector<uint8_t> bytes;
+    varint::Put(bytes, varint::ZigZag(value));
+    EXPECT_LE(bytes.size(), varint::kMaxBytes);
+    size_t offset = 0;
+    const uint64_t decoded =
+        varint::Read([&] { return bytes.at(offset++); }, "too long");
+    EXPECT_EQ(varint::UnZigZag(decoded), value);
+    EXPECT_EQ(offset, bytes.size());
+  }
+
+  const std::vector<uint8_t> endless(varint::kMaxBytes + 1, 0x80);
+  size_t offset = 0;
+  EXPECT_THROW(varint::Read([&] { return endless.at(offset++); }, "too long"),
+               SimError);
+}
+
+TEST(TraceStreamTest, RejectsMalformedTraces) {
+  EXPECT_THROW(ReadAll("I2T"), SimError);
+  EXPECT_THROW(ReadAll(std::string("XXXX\x01\x00\x00\x00", 8)), SimError);
+  EXPECT_THROW(ReadAll(std::string("I2TR\x09\x00\x00\x00", 8)), SimError);
+
+  std::ostringstream out;
+  {
+    TraceStreamWriter writer(out);
+    writer.Append(Instruction(100, 0x8000, 0xEA, 1));
+    writer.Close();
+  }
+  const std::string data = out.str();
+  EXPECT_THROW(ReadAll(data.substr(0, data.size() - 1)), SimError);
+}
+
+TEST(TraceStreamTest, CpuStreamsRetiredInstructionsAndAccesses) {
+  auto owned = test::MakeAssembledCpu(R"(
+    LDA #$42
+    STA $0200
+    HLT
+  )");
+  Cpu& cpu = *owned;
+  const Word entry = cpu.pc().value();
+
+  std::ostringstream out;
+  TraceStreamWriter writer(out);
+  cpu.AttachTraceWriter(&writer);
+  ASSERT_EQ(cpu.RunUntilHalt(1000).reason, Cpu::HaltReason::Halt);
+  cpu.AttachTraceWriter(nullptr);
+  writer.Close();
+
+  std::vector<TraceRecord> instructions;
+  std::vector<TraceRecord> writes;
+  for (const auto& record : ReadAll(out.str())) {
+    if (record.kind == TraceRecord::Kind::Instruction) {
+      instructions.push_back(record);
+    } else if (record.kind == TraceRecord::Kind::Write) {
+      writes.push_back(record);
+    }
+  }
+  ASSERT_EQ(instructions.size(), 3u);
+  EXPECT_EQ(instructions.size(), cpu.perf_counters().instructions);
+  EXPECT_EQ(instructions[0].address, entry);
+  EXPECT_EQ(instructions[0].value.value(),
+            static_cast<uint8_t>(irata2::isa::Opcode::LDA_IMM));
+  EXPECT_EQ(instructions[0].a, Byte{0x42});
+  EXPECT_EQ(instructions[2].value.value(),
+            static_cast<uint8_t>(irata2::isa::Opcode::HLT_IMP));
+
+  ASSERT_EQ(writes.size(), 1u);
+  EXPECT_EQ(writes[0].address, Word{0x0200});
+  EXPECT_EQ(writes[0].value, Byte{0x42});
+  EXPECT_GT(writes[0].cycle, instructions[1].cycle);
+}
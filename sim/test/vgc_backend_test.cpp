@@ -2,6 +2,8 @@
 
 #include <gtest/gtest.h>
 
+#include <vector>
+
 using irata2::sim::io::ImageBackend;
 
 TEST(ImageBackendTest, ClearFillsFramebuffer) {
@@ -32,3 +34,199 @@ TEST(ImageBackendTest, DrawLineTouchesEndpoints) {
   EXPECT_EQ(fb[0], 0x01);
   EXPECT_EQ(fb[5 * ImageBackend::kWidth + 5], 0x01);
 }
+
+namespace {
+
+using irata2::sim::io::VgcBackend;
+using irata2::sim::io::VgcCommand;
+using irata2::sim::io::VgcOp;
+
+struct RecordingBackend final : VgcBackend {
+  void clear(uint8_t intensity) override {
+    calls.push_back({VgcOp::Clear, 0, 0, 0, 0, intensity});
+  }
+  void draw_point(uint8_t x, uint8_t y, uint8_t intensity) override {
+    calls.push_back({VgcOp::Point, x, y, 0, 0, intensity});
+  }
+  void draw_line(uint8_t x0, uint8_t y0, uint8_t x1, uint8_t y1,
+                 uint8_t intensity) override {
+    calls.push_back({VgcOp::Line, x0, y0, x1, y1, intensity});
+  }
+  void present() override {}
+
+  std::vector<VgcCommand> calls;
+};
+
+const std::vector<VgcCommand> kBatch = {
+    {VgcOp::Clear, 0, 0, 0, 0, 0x01},
+    {VgcOp::Point, 255, 255, 0, 0, 0x02},
+    {VgcOp::Line, 10, 200, 250, 3, 0x03},
+    {VgcOp::Line, 0, 128, 255, 128, 0x02},
+};
+
+}  // namespace
+
+TEST(VgcBackendTest, DefaultSubmitForwardsInOrder) {
+  RecordingBackend backend;
+  backend.submit(kBatch);
+  EXPECT_EQ(backend.calls, kBatch);
+}
+
+TEST(ImageBackendTest, SubmitMatchesPerPrimitiveCalls) {
+  ImageBackend batched;
+  batched.submit(kBatch);
+
+  ImageBackend direct;
+  for (const auto& command : kBatch) {
+    switch (command.op) {
+      case VgcOp::Clear:
+        direct.clear(command.intensity);
+        break;
+      case VgcOp::Point:
+        direct.draw_point(command.x0, command.y0, command.intensity);
+        break;
+      case VgcOp::Line:
+        direct.draw_line(command.x0, command.y0, command.x1, command.y1,
+                         command.intensity);
+        break;
+    }
+  }
+
+  EXPECT_EQ(batched.framebuffer(), direct.framebuffer());
+}
+
+TEST(ImageBackendTest, FastPathLinesMatchEndpointsAndLength) {
+  ImageBackend backend;
+  backend.draw_line(200, 7, 3, 7, 0x01);    // horizontal, right to left
+  backend.draw_line(9, 250, 9, 20, 0x02);   // vertical, bottom to top
+  backend.draw_line(40, 40, 10, 70, 0x03);  // diagonal, up-right to down-left
+
+  const auto& fb = backend.framebuffer();
+  for (size_t x = 3; x <= 200; ++x) {
+    EXPECT_EQ(fb[7 * ImageBackend::kWidth + x], 0x01) << x;
+  }
+  EXPECT_EQ(fb[7 * ImageBackend::kWidth + 2], 0x00);
+  EXPECT_EQ(fb[7 * ImageBackend::kWidth + 201], 0x00);
+  for (size_t y = 20; y <= 250; ++y) {
+    EXPECT_EQ(fb[y * ImageBackend::kWidth + 9], 0x02) << y;
+  }
+  for (size_t i = 0; i <= 30; ++i) {
+    EXPECT_EQ(fb[(40 + i) * ImageBackend::kWidth + (40 - i)], 0x03) << i;
+  }
+}
+
+TEST(ImageBackendTest, SteepLineIsContinuous) {
+  ImageBackend backend;
+  backend.draw_line(0, 0, 3, 200, 0x01);
+
+  const auto& fb = backend.framebuffer();
+  for (size_t y = 0; y <= 200; ++y) {
+    size_t lit = 0;
+    for (size_t x = 0; x <= 3; ++x) {
+      lit += fb[y * ImageBackend::kWidth + x] == 0x01;
+    }
+    EXPECT_EQ(lit, 1u) << y;
+  }
+}
+
+TEST(ImageBackendTest, DirtyTrackingCoversDrawnPixels) {
+  ImageBackend backend;
+  backend.reset_dirty();
+  EXPECT_TRUE(backend.dirty_rect().empty());
+
+  backend.draw_line(10, 20, 30, 25, 0x02);
+  backend.draw_point(5, 100, 0x01);
+
+  EXPECT_EQ(backend.dirty_rect(),
+            (irata2::sim::io::DirtyRect{5, 20, 31, 101}));
+  EXPECT_TRUE(backend.row_dirty(20));
+  EXPECT_TRUE(backend.row_dirty(25));
+  EXPECT_TRUE(backend.row_dirty(100));
+  EXPECT_FALSE(backend.row_dirty(26));
+  EXPECT_EQ(backend.dirty_rows().count(), 7u);
+}
+
+TEST(ImageBackendTest, ClearToSameBackgroundOnlyTouchesDrawnRows) {
+  ImageBackend backend;
+  backend.clear(0x00);
+  backend.draw_line(0, 50, 255, 50, 0x03);
+  backend.reset_dirty();
+
+  backend.clear(0x00);
+  EXPECT_EQ(backend.dirty_rows().count(), 1u);
+  EXPECT_TRUE(backend.row_dirty(50));
+  EXPECT_EQ(backend.dirty_rect(),
+            (irata2::sim::io::DirtyRect{0, 50, ImageBackend::kWidth, 51}));
+  for (uint8_t value : backend.framebuffer()) {
+    ASSERT_EQ(value, 0x00);
+  }
+
+  backend.reset_dirty();
+  backend.clear(0x00);
+  EXPECT_TRUE(backend.dirty_rect().empty());
+
+  backend.clear(0x01);
+  EXPECT_TRUE(backend.dirty_rows().all());
+  for (uint8_t value : backend.framebuffer()) {
+    ASSERT_EQ(value, 0x01);
+  }
+}
+
+TEST(ImageBackendTest, RasterizesOnlyWhenFramebufferIsRead) {
+  ImageBackend backend;
+  backend.clear(0x00);
+  backend.draw_line(0, 0, 10, 0, 0x03);
+  backend.draw_point(4, 4, 0x01);
+  EXPECT_EQ(backend.recorded_commands(), 3u);
+
+  const auto& fb = backend.framebuffer();
+  EXPECT_EQ(backend.recorded_commands(), 0u);
+  EXPECT_EQ(fb[10], 0x03);
+  EXPECT_EQ(fb[4 * ImageBackend::kWidth + 4], 0x01);
+}
+
+TEST(ImageBackendTest, ClearDropsEarlierRecordedCommands) {
+  ImageBackend backend;
+  backend.draw_line(0, 0, 255, 255, 0x03);
+  backend.draw_point(1, 1, 0x02);
+  backend.clear(0x01);
+  EXPECT_EQ(backend.recorded_commands(), 1u);
+
+  for (uint8_t value : backend.framebuffer()) {
+    ASSERT_EQ(value, 0x01);
+  }
+}
+
+TEST(ImageBackendTest, RasterizeIntervalDrawsEveryNthPresent) {
+  ImageBackend backend;
+  backend.set_rasterize_interval(2);
+
+  backend.draw_point(1, 1, 0x03);
+  backend.present();
+  EXPECT_EQ(backend.recorded_commands(), 1u);
+
+  backend.draw_point(2, 2, 0x03);
+  backend.present();
+  EXPECT_EQ(backend.recorded_commands(), 0u);
+  EXPECT_EQ(backend.frames_presented(), 2u);
+}
+
+TEST(ImageBackendTest, StreamHashIdentifiesFrameWithoutRasterizing) {
+  ImageBackend a;
+  ImageBackend b;
+  for (ImageBackend* backend : {&a, &b}) {
+    backend->draw_point(9, 9, 0x02);  // discarded by the clear below
+    backend->clear(0x00);
+    backend->draw_line(3, 4, 100, 50, 0x03);
+  }
+  EXPECT_EQ(a.stream_hash(), b.stream_hash());
+  EXPECT_EQ(a.recorded_commands(), 2u);
+
+  b.draw_point(0, 0, 0x01);
+  EXPECT_NE(a.stream_hash(), b.stream_hash());
+
+  const uint64_t before = a.stream_hash();
+  a.clear(0x00);
+  a.draw_line(3, 4, 100, 50, 0x03);
+  EXPECT_EQ(a.stream_hash(), before);
+}
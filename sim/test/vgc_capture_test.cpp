@@ -0,0 +1,195 @@
+#include "irata2/sim.h"
+#include "irata2/sim/error.h"
+#include "irata2/sim/io/vector_graphics_coprocessor.h"
+#include "irata2/sim/io/vgc_capture.h"
+#include "test_helpers.h"
+
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using irata2::base::Byte;
+using irata2::base::Word;
+using irata2::sim::Cpu;
+using irata2::sim::SimError;
+using irata2::sim::io::ImageBackend;
+using irata2::sim::io::ReplayVgcCapture;
+using irata2::sim::io::VgcCaptureReader;
+using irata2::sim::io::VgcCaptureRecord;
+using irata2::sim::io::VgcCaptureWriter;
+using irata2::sim::io::VgcCommand;
+using irata2::sim::io::VgcOp;
+using irata2::sim::test::MakeAssembledVgcRig;
+using irata2::sim::test::VgcRig;
+
+namespace {
+std::vector<uint8_t> Bytes(const std::string& data) {
+  return std::vector<uint8_t>(data.begin(), data.end());
+}
+}  // namespace
+
+TEST(VgcCaptureTest, RoundTripsRecords) {
+  std::ostringstream out;
+  {
+    VgcCaptureWriter writer(out);
+    writer.WriteCommand(10, {VgcOp::Clear, 0, 0, 0, 0, 1});
+    writer.WriteCommand(500, {VgcOp::Point, 7, 9, 0, 0, 2});
+    writer.WriteCommand(100000, {VgcOp::Line, 1, 2, 250, 251, 3});
+    writer.WritePresent(100004);
+    // A restored snapshot can rewind the clock.
+    writer.WritePresent(90);
+    EXPECT_EQ(writer.commands_written(), 3u);
+    EXPECT_EQ(writer.frames_written(), 2u);
+  }
+
+  VgcCaptureReader reader(Bytes(out.str()));
+  auto record = reader.Next();
+  ASSERT_TRUE(record);
+  EXPECT_EQ(record->kind, VgcCaptureRecord::Kind::Command);
+  EXPECT_EQ(record->cycle, 10u);
+  EXPECT_EQ(record->command, (VgcCommand{VgcOp::Clear, 0, 0, 0, 0, 1}));
+
+  record = reader.Next();
+  ASSERT_TRUE(record);
+  EXPECT_EQ(record->cycle, 500u);
+  EXPECT_EQ(record->command, (VgcCommand{VgcOp::Point, 7, 9, 0, 0, 2}));
+
+  record = reader.Next();
+  ASSERT_TRUE(record);
+  EXPECT_EQ(record->cycle, 100000u);
+  EXPECT_EQ(record->command, (VgcCommand{VgcOp::Line, 1, 2, 250, 251, 3}));
+
+  record = reader.Next();
+  ASSERT_TRUE(record);
+  EXPECT_EQ(record->kind, VgcCaptureRecord::Kind::Present);
+  EXPECT_EQ(record->cycle, 100004u);
+
+  record = reader.Next();
+  ASSERT_TRUE(record);
+  EXPECT_EQ(record->cycle, 90u);
+
+  EXPECT_TRUE(reader.at_end());
+  EXPECT_FALSE(reader.Next());
+}
+
+TEST(VgcCaptureTest, RejectsMalformedInput) {
+  EXPECT_THROW(VgcCaptureReader(Bytes("IVG")), SimError);
+  EXPECT_THROW(VgcCaptureReader(Bytes(std::string("XVGC\x01\0\0\0", 8))),
+               SimError);
+  EXPECT_THROW(VgcCaptureReader(Bytes(std::string("IVGC\x02\0\0\0", 8))),
+               SimError);
+
+  // A line record cut off after its first coordinate.
+  VgcCaptureReader truncated(
+      Bytes(std::string("IVGC\x01\0\0\0\x02\x00\x05", 11)));
+  EXPECT_THROW(truncated.Next(), SimError);
+}
+
+TEST(VgcCaptureTest, ReplayStopsAfterMaxFrames) {
+  std::ostringstream out;
+  {
+    VgcCaptureWriter writer(out);
+    for (uint8_t frame = 0; frame < 5; ++frame) {
+      writer.WriteCommand(frame * 100u, {VgcOp::Clear, 0, 0, 0, 0, 0});
+      writer.WriteCommand(frame * 100u + 1, {VgcOp::Point, frame, 0, 0, 0, 3});
+      writer.WritePresent(frame * 100u + 2);
+    }
+  }
+
+  VgcCaptureReader reader(Bytes(out.str()));
+  ImageBackend backend;
+  std::vector<uint64_t> cycles;
+  const auto result = ReplayVgcCapture(
+      reader, backend, 3,
+      [&cycles](uint64_t, uint64_t cycle) { cycles.push_back(cycle); });
+
+  EXPECT_EQ(result.frames, 3u);
+  EXPECT_EQ(result.commands, 6u);
+  EXPECT_EQ(cycles, (std::vector<uint64_t>{2, 102, 202}));
+  EXPECT_EQ(backend.frames_presented(), 3u);
+  EXPECT_EQ(backend.framebuffer()[2], 0x03);
+  EXPECT_EQ(backend.framebuffer()[1], 0x00);
+}
+
+TEST(VgcCaptureTest, SkipsCommandsDroppedByClear) {
+  VgcRig rig = MakeAssembledVgcRig("HLT");
+  ASSERT_NE(rig.vgc, nullptr);
+  auto& vgc = *rig.vgc;
+
+  std::ostringstream out;
+  VgcCaptureWriter writer(out);
+  vgc.set_capture(&writer);
+
+  auto exec = [&vgc](uint8_t cmd, uint8_t x0) {
+    vgc.Write(Word{irata2::sim::io::vgc_reg::CMD}, Byte{cmd});
+    vgc.Write(Word{irata2::sim::io::vgc_reg::X0}, Byte{x0});
+    vgc.Write(Word{irata2::sim::io::vgc_reg::COLOR}, Byte{0x03});
+    vgc.Write(Word{irata2::sim::io::vgc_reg::EXEC}, Byte{0x01});
+  };
+  exec(irata2::sim::io::vgc_cmd::POINT, 1);
+  exec(irata2::sim::io::vgc_cmd::CLEAR, 0);
+  exec(irata2::sim::io::vgc_cmd::POINT, 2);
+  EXPECT_EQ(writer.commands_written(), 0u);
+
+  vgc.Write(Word{irata2::sim::io::vgc_reg::CONTROL},
+            Byte{irata2::sim::io::vgc_control::PRESENT});
+  vgc.set_capture(nullptr);
+  writer.Flush();
+  EXPECT_EQ(writer.commands_written(), 2u);
+
+  VgcCaptureReader reader(Bytes(out.str()));
+  auto record = reader.Next();
+  ASSERT_TRUE(record);
+  EXPECT_EQ(record->command.op, VgcOp::Clear);
+  record = reader.Next();
+  ASSERT_TRUE(record);
+  EXPECT_EQ(record->command.op, VgcOp::Point);
+  EXPECT_EQ(record->command.x0, 2);
+}
+
+TEST(VgcCaptureTest, ReplayReproducesLiveFrame) {
+  const std::string program = R"(
+    LDA #$00
+    STA $410A
+    LDA #$90
+    STA $410B
+    LDA #$03
+    STA $410C
+    LDA #$02
+    STA $4107
+    HLT
+
+    .org $9000
+    .byte $01, $00, $00, $00, $00, $00
+    .byte $03, $00, $00, $0A, $0A, $03
+    .byte $02, $20, $30, $00, $00, $02
+  )";
+
+  VgcRig rig = MakeAssembledVgcRig(program);
+  ASSERT_NE(rig.vgc, nullptr);
+
+  std::ostringstream out;
+  VgcCaptureWriter writer(out);
+  rig.vgc->set_capture(&writer);
+
+  auto result = rig.cpu->RunUntilHalt(3000);
+  ASSERT_EQ(result.reason, Cpu::HaltReason::Halt);
+  rig.vgc->set_capture(nullptr);
+  writer.Flush();
+
+  EXPECT_EQ(writer.commands_written(), 3u);
+  EXPECT_EQ(writer.frames_written(), 1u);
+
+  VgcCaptureReader reader(Bytes(out.str()));
+  ImageBackend replayed;
+  const auto replay = ReplayVgcCapture(reader, replayed);
+
+  EXPECT_EQ(replay.frames, 1u);
+  EXPECT_GT(replay.last_cycle, 0u);
+  EXPECT_LE(replay.last_cycle, rig.cpu->cycle_count());
+  EXPECT_EQ(replayed.stream_hash(), rig.backend->stream_hash());
+  EXPECT_EQ(replayed.framebuffer(), rig.backend->framebuffer());
+}
@@ -0,0 +1,45 @@
+#include "irata2/sim/io/vgc_font.h"
+
+#include <gtest/gtest.h>
+
+#include <string>
+
+using irata2::sim::io::VgcGlyphStrokes;
+namespace vgc_font = irata2::sim::io::vgc_font;
+
+TEST(VgcFontTest, GlyphsStayInsideTheirCell) {
+  for (int code = 0; code < 128; ++code) {
+    const auto strokes = VgcGlyphStrokes(static_cast<char>(code));
+    size_t start = 0;
+    while (start < strokes.size()) {
+      size_t end = strokes.find(' ', start);
+      if (end == std::string_view::npos) {
+        end = strokes.size();
+      }
+      const auto stroke = strokes.substr(start, end - start);
+      ASSERT_FALSE(stroke.empty()) << "glyph " << code;
+      ASSERT_EQ(stroke.size() % 2, 0u) << "glyph " << code;
+      for (size_t i = 0; i < stroke.size(); i += 2) {
+        EXPECT_GE(stroke[i], '0') << "glyph " << code;
+        EXPECT_LE(stroke[i], '0' + vgc_font::kGlyphWidth) << "glyph " << code;
+        EXPECT_GE(stroke[i + 1], '0') << "glyph " << code;
+        EXPECT_LE(stroke[i + 1], '0' + vgc_font::kGlyphHeight)
+            << "glyph " << code;
+      }
+      start = end + 1;
+    }
+  }
+}
+
+TEST(VgcFontTest, CoversDigitsAndLetters) {
+  for (char c = '0'; c <= '9'; ++c) {
+    EXPECT_FALSE(VgcGlyphStrokes(c).empty()) << c;
+  }
+  for (char c = 'A'; c <= 'Z'; ++c) {
+    EXPECT_FALSE(VgcGlyphStrokes(c).empty()) << c;
+    EXPECT_EQ(VgcGlyphStrokes(static_cast<char>(c - 'A' + 'a')),
+              VgcGlyphStrokes(c));
+  }
+  EXPECT_TRUE(VgcGlyphStrokes(' ').empty());
+  EXPECT_TRUE(VgcGlyphStrokes('~').empty());
+}
@@ -1,62 +1,22 @@
-#include "irata2/assembler/assembler.h"
 #include "irata2/sim.h"
+#include "irata2/sim/guest_timeline.h"
+#include "irata2/sim/io/input_device.h"
 #include "irata2/sim/io/vector_graphics_coprocessor.h"
 #include "irata2/sim/io/vgc_backend.h"
+#include "test_helpers.h"
 
 #include <gtest/gtest.h>
 
 #include <memory>
+#include <sstream>
 
-using irata2::assembler::Assemble;
-using irata2::assembler::AssemblerResult;
 using irata2::base::Byte;
 using irata2::base::Word;
 using irata2::sim::Cpu;
-using irata2::sim::DefaultHdl;
-using irata2::sim::DefaultMicrocodeProgram;
-using irata2::sim::LatchedProcessControl;
 using irata2::sim::io::ImageBackend;
 using irata2::sim::io::VectorGraphicsCoprocessor;
-using irata2::sim::io::VGC_BASE;
-using irata2::sim::memory::Memory;
-using irata2::sim::memory::Region;
-
-namespace {
-struct VgcRig {
-  std::unique_ptr<Cpu> cpu;
-  VectorGraphicsCoprocessor* vgc = nullptr;
-  ImageBackend* backend = nullptr;
-};
-
-VgcRig MakeCpuWithVgc(const std::vector<Byte>& rom) {
-  VgcRig rig;
-  std::vector<Memory::RegionFactory> factories;
-  factories.push_back([&rig](Memory& mem,
-                             LatchedProcessControl&)
-                           -> std::unique_ptr<Region> {
-    return std::make_unique<Region>(
-        "vgc", mem, Word{VGC_BASE},
-        [&rig](Region& region) -> std::unique_ptr<irata2::sim::memory::Module> {
-          auto backend = std::make_unique<ImageBackend>();
-          rig.backend = backend.get();
-          auto vgc = std::make_unique<VectorGraphicsCoprocessor>(
-              "vgc", region, std::move(backend));
-          rig.vgc = vgc.get();
-          return vgc;
-        });
-  });
-
-  rig.cpu = std::make_unique<Cpu>(
-      DefaultHdl(), DefaultMicrocodeProgram(), rom, std::move(factories));
-  return rig;
-}
-
-void InitializeCpu(Cpu& cpu, Word entry) {
-  cpu.pc().set_value(entry);
-  cpu.controller().sc().set_value(Byte{0});
-  cpu.controller().ir().set_value(cpu.memory().ReadAt(entry));
-}
-}  // namespace
+using irata2::sim::test::MakeAssembledVgcRig;
+using irata2::sim::test::VgcRig;
 
 TEST(VgcIntegrationTest, ProgramDrawsLineToFramebuffer) {
   const std::string program = R"(
@@ -87,21 +47,331 @@ TEST(VgcIntegrationTest, ProgramDrawsLineToFramebuffer) {
     HLT
   )";
 
-  AssemblerResult assembled = Assemble(program, "vgc_integration.asm");
-  std::vector<Byte> rom;
-  rom.reserve(assembled.rom.size());
-  for (uint8_t value : assembled.rom) {
-    rom.push_back(Byte{value});
-  }
+  VgcRig rig = MakeAssembledVgcRig(program);
+  ASSERT_NE(rig.backend, nullptr);
 
-  VgcRig rig = MakeCpuWithVgc(rom);
+  auto result = rig.cpu->RunUntilHalt(3000);
+  ASSERT_EQ(result.reason, Cpu::HaltReason::Halt);
+
+  const auto& fb = rig.backend->framebuffer();
+  EXPECT_EQ(fb[0], 0x03);
+  EXPECT_EQ(fb[10 * ImageBackend::kWidth + 10], 0x03);
+}
+
+TEST(VgcIntegrationTest, TimelineMarksPresentedFrames) {
+  const std::string program = R"(
+    LDA #$02
+    STA $4107
+    LDA #$02
+    STA $4107
+    HLT
+  )";
+
+  VgcRig rig = MakeAssembledVgcRig(program);
+  irata2::sim::GuestTimeline timeline;
+  rig.cpu->AttachTimeline(&timeline);
+  ASSERT_EQ(rig.cpu->RunUntilHalt(3000).reason, Cpu::HaltReason::Halt);
+  ASSERT_EQ(rig.cpu->frames_presented(), 2u);
+
+  std::ostringstream out;
+  timeline.WriteChromeTrace(out);
+  const std::string trace = out.str();
+  EXPECT_NE(trace.find("\"name\": \"frame 1\""), std::string::npos);
+  EXPECT_NE(trace.find("\"name\": \"frame 2\""), std::string::npos);
+  EXPECT_NE(trace.find("\"name\": \"present\", \"cat\": \"frame\", "
+                       "\"ph\": \"i\""),
+            std::string::npos);
+  EXPECT_NE(trace.find("\"name\": \"vgc write\""), std::string::npos);
+  EXPECT_NE(trace.find("\"address\": \"0x4107\", \"value\": \"0x02\""),
+            std::string::npos);
+}
+
+TEST(VgcIntegrationTest, DisplayListDrawsFrameFromRom) {
+  const std::string program = R"(
+    LDA #$00
+    STA $410A
+    LDA #$90
+    STA $410B
+    LDA #$03
+    STA $410C
+    LDA #$02
+    STA $4107
+    HLT
+
+    .org $9000
+    .byte $01, $00, $00, $00, $00, $00
+    .byte $03, $00, $00, $0A, $0A, $03
+    .byte $02, $20, $30, $00, $00, $02
+  )";
+
+  VgcRig rig = MakeAssembledVgcRig(program);
   ASSERT_NE(rig.backend, nullptr);
 
-  InitializeCpu(*rig.cpu, assembled.header.entry);
   auto result = rig.cpu->RunUntilHalt(3000);
   ASSERT_EQ(result.reason, Cpu::HaltReason::Halt);
 
   const auto& fb = rig.backend->framebuffer();
   EXPECT_EQ(fb[0], 0x03);
   EXPECT_EQ(fb[10 * ImageBackend::kWidth + 10], 0x03);
+  EXPECT_EQ(fb[0x30 * ImageBackend::kWidth + 0x20], 0x02);
+}
+
+TEST(VgcIntegrationTest, DisplayListReadsRamWithoutTouchingRegisters) {
+  VgcRig rig = MakeAssembledVgcRig("HLT");
+  ASSERT_NE(rig.vgc, nullptr);
+
+  const uint8_t list[] = {
+      0x03, 0x05, 0x05, 0x05, 0x0F, 0x01,
+  };
+  for (uint16_t i = 0; i < sizeof(list); ++i) {
+    rig.cpu->memory().WriteAt(Word{static_cast<uint16_t>(0x0300 + i)},
+                              Byte{list[i]});
+  }
+
+  // Latch a discrete POINT command, run the list, then EXEC the latched one.
+  rig.vgc->Write(Word{irata2::sim::io::vgc_reg::CMD}, Byte{0x02});
+  rig.vgc->Write(Word{irata2::sim::io::vgc_reg::X0}, Byte{0x40});
+  rig.vgc->Write(Word{irata2::sim::io::vgc_reg::Y0}, Byte{0x40});
+  rig.vgc->Write(Word{irata2::sim::io::vgc_reg::COLOR}, Byte{0x02});
+  rig.vgc->Write(Word{irata2::sim::io::vgc_reg::DL_ADDR_LO}, Byte{0x00});
+  rig.vgc->Write(Word{irata2::sim::io::vgc_reg::DL_ADDR_HI}, Byte{0x03});
+  rig.vgc->Write(Word{irata2::sim::io::vgc_reg::DL_COUNT}, Byte{1});
+  rig.vgc->Write(Word{irata2::sim::io::vgc_reg::EXEC}, Byte{0x01});
+  rig.vgc->Flush();
+
+  const auto& fb = rig.backend->framebuffer();
+  EXPECT_EQ(fb[0x05 * ImageBackend::kWidth + 0x05], 0x01);
+  EXPECT_EQ(fb[0x0F * ImageBackend::kWidth + 0x05], 0x01);
+  EXPECT_EQ(fb[0x40 * ImageBackend::kWidth + 0x40], 0x02);
+}
+
+TEST(VgcIntegrationTest, CommandsAreBatchedUntilPresent) {
+  VgcRig rig = MakeAssembledVgcRig("HLT");
+  ASSERT_NE(rig.vgc, nullptr);
+
+  rig.vgc->Write(Word{irata2::sim::io::vgc_reg::CMD}, Byte{0x02});
+  rig.vgc->Write(Word{irata2::sim::io::vgc_reg::X0}, Byte{0x10});
+  rig.vgc->Write(Word{irata2::sim::io::vgc_reg::Y0}, Byte{0x10});
+  rig.vgc->Write(Word{irata2::sim::io::vgc_reg::COLOR}, Byte{0x03});
+  rig.vgc->Write(Word{irata2::sim::io::vgc_reg::EXEC}, Byte{0x01});
+
+  EXPECT_EQ(rig.vgc->pending_commands(), 1u);
+  EXPECT_EQ(rig.backend->framebuffer()[0x10 * ImageBackend::kWidth + 0x10],
+            0x00);
+
+  rig.vgc->Write(Word{irata2::sim::io::vgc_reg::CONTROL}, Byte{0x02});
+  EXPECT_EQ(rig.vgc->pending_commands(), 0u);
+  EXPECT_EQ(rig.backend->framebuffer()[0x10 * ImageBackend::kWidth + 0x10],
+            0x03);
+}
+
+namespace {
+void WriteRam(Cpu& cpu, uint16_t address, std::initializer_list<uint8_t> bytes) {
+  for (uint8_t value : bytes) {
+    cpu.memory().WriteAt(Word{address++}, Byte{value});
+  }
+}
+
+void LoadShape(VectorGraphicsCoprocessor& vgc, uint8_t id, uint16_t address) {
+  vgc.Write(Word{irata2::sim::io::vgc_reg::SHAPE_ADDR_LO},
+            Byte{static_cast<uint8_t>(address & 0xFF)});
+  vgc.Write(Word{irata2::sim::io::vgc_reg::SHAPE_ADDR_HI},
+            Byte{static_cast<uint8_t>(address >> 8)});
+  vgc.Write(Word{irata2::sim::io::vgc_reg::SHAPE_LOAD}, Byte{id});
+}
+
+void DrawShape(VectorGraphicsCoprocessor& vgc,
+               uint8_t x,
+               uint8_t y,
+               uint8_t id,
+               uint8_t rotation) {
+  vgc.Write(Word{irata2::sim::io::vgc_reg::CMD},
+            Byte{irata2::sim::io::vgc_cmd::DRAW_SHAPE});
+  vgc.Write(Word{irata2::sim::io::vgc_reg::X0}, Byte{x});
+  vgc.Write(Word{irata2::sim::io::vgc_reg::Y0}, Byte{y});
+  vgc.Write(Word{irata2::sim::io::vgc_reg::X1}, Byte{id});
+  vgc.Write(Word{irata2::sim::io::vgc_reg::Y1}, Byte{rotation});
+  vgc.Write(Word{irata2::sim::io::vgc_reg::COLOR}, Byte{0x03});
+  vgc.Write(Word{irata2::sim::io::vgc_reg::EXEC}, Byte{0x01});
+}
+
+uint8_t Pixel(const ImageBackend& backend, size_t x, size_t y) {
+  return backend.framebuffer()[y * ImageBackend::kWidth + x];
+}
+}  // namespace
+
+TEST(VgcIntegrationTest, DrawShapeRotatesScalesAndTranslates) {
+  VgcRig rig = MakeAssembledVgcRig("HLT");
+  ASSERT_NE(rig.vgc, nullptr);
+
+  // Closed triangle with its nose pointing up.
+  WriteRam(*rig.cpu, 0x0300, {0x83, 0x00, 0xF8, 0x06, 0x06, 0xFA, 0x06});
+  LoadShape(*rig.vgc, 5, 0x0300);
+
+  DrawShape(*rig.vgc, 100, 100, 5, 0);
+  // A quarter turn clockwise points the nose east.
+  DrawShape(*rig.vgc, 50, 50, 5, 64);
+  rig.vgc->Write(Word{irata2::sim::io::vgc_reg::SCALE}, Byte{0x20});
+  DrawShape(*rig.vgc, 200, 100, 5, 0);
+  rig.vgc->Flush();
+
+  EXPECT_EQ(Pixel(*rig.backend, 100, 92), 0x03);
+  EXPECT_EQ(Pixel(*rig.backend, 106, 106), 0x03);
+  EXPECT_EQ(Pixel(*rig.backend, 94, 106), 0x03);
+  EXPECT_EQ(Pixel(*rig.backend, 100, 106), 0x03);  // closing edge
+
+  EXPECT_EQ(Pixel(*rig.backend, 58, 50), 0x03);
+  EXPECT_EQ(Pixel(*rig.backend, 44, 56), 0x03);
+  EXPECT_EQ(Pixel(*rig.backend, 44, 44), 0x03);
+  EXPECT_EQ(Pixel(*rig.backend, 50, 42), 0x00);
+
+  EXPECT_EQ(Pixel(*rig.backend, 200, 84), 0x03);
+  EXPECT_EQ(Pixel(*rig.backend, 212, 112), 0x03);
+}
+
+TEST(VgcIntegrationTest, DrawShapeClipsInsteadOfWrapping) {
+  VgcRig rig = MakeAssembledVgcRig("HLT");
+  ASSERT_NE(rig.vgc, nullptr);
+
+  // Open horizontal bar from -10 to +10.
+  WriteRam(*rig.cpu, 0x0300, {0x02, 0xF6, 0x00, 0x0A, 0x00});
+  LoadShape(*rig.vgc, 0, 0x0300);
+  DrawShape(*rig.vgc, 2, 128, 0, 0);
+  rig.vgc->Flush();
+
+  EXPECT_EQ(Pixel(*rig.backend, 0, 128), 0x03);
+  EXPECT_EQ(Pixel(*rig.backend, 12, 128), 0x03);
+  EXPECT_EQ(Pixel(*rig.backend, 13, 128), 0x00);
+  EXPECT_EQ(Pixel(*rig.backend, 248, 128), 0x00);
+  EXPECT_EQ(Pixel(*rig.backend, 255, 128), 0x00);
+}
+
+TEST(VgcIntegrationTest, DisplayListDrawsShapes) {
+  VgcRig rig = MakeAssembledVgcRig("HLT");
+  ASSERT_NE(rig.vgc, nullptr);
+
+  WriteRam(*rig.cpu, 0x0300, {0x01, 0x03, 0x04});  // single point
+  LoadShape(*rig.vgc, 7, 0x0300);
+  WriteRam(*rig.cpu, 0x0400,
+           {0x04, 0x30, 0x30, 0x07, 0x00, 0x02,
+            0x04, 0x60, 0x60, 0x07, 0x80, 0x01});
+  rig.vgc->Write(Word{irata2::sim::io::vgc_reg::DL_ADDR_LO}, Byte{0x00});
+  rig.vgc->Write(Word{irata2::sim::io::vgc_reg::DL_ADDR_HI}, Byte{0x04});
+  rig.vgc->Write(Word{irata2::sim::io::vgc_reg::DL_COUNT}, Byte{2});
+  rig.vgc->Flush();
+
+  EXPECT_EQ(Pixel(*rig.backend, 0x33, 0x34), 0x02);
+  // A half turn mirrors the offset through the origin.
+  EXPECT_EQ(Pixel(*rig.backend, 0x5D, 0x5C), 0x01);
+}
+
+TEST(VgcIntegrationTest, GlyphDrawsStrokeFontAtScale) {
+  VgcRig rig = MakeAssembledVgcRig("HLT");
+  ASSERT_NE(rig.vgc, nullptr);
+
+  // 'L' at unit scale is an 8x12 cell.
+  rig.vgc->Write(Word{irata2::sim::io::vgc_reg::CMD},
+                 Byte{irata2::sim::io::vgc_cmd::GLYPH});
+  rig.vgc->Write(Word{irata2::sim::io::vgc_reg::X0}, Byte{10});
+  rig.vgc->Write(Word{irata2::sim::io::vgc_reg::Y0}, Byte{10});
+  rig.vgc->Write(Word{irata2::sim::io::vgc_reg::X1}, Byte{'L'});
+  rig.vgc->Write(Word{irata2::sim::io::vgc_reg::COLOR}, Byte{0x02});
+  rig.vgc->Write(Word{irata2::sim::io::vgc_reg::EXEC}, Byte{0x01});
+  rig.vgc->Flush();
+
+  EXPECT_EQ(Pixel(*rig.backend, 10, 10), 0x02);
+  EXPECT_EQ(Pixel(*rig.backend, 10, 22), 0x02);
+  EXPECT_EQ(Pixel(*rig.backend, 18, 22), 0x02);
+  EXPECT_EQ(Pixel(*rig.backend, 18, 10), 0x00);
+
+  // Doubling SCALE doubles the cell.
+  rig.vgc->Write(Word{irata2::sim::io::vgc_reg::SCALE}, Byte{0x20});
+  rig.vgc->Write(Word{irata2::sim::io::vgc_reg::X0}, Byte{100});
+  rig.vgc->Write(Word{irata2::sim::io::vgc_reg::EXEC}, Byte{0x01});
+  rig.vgc->Flush();
+
+  EXPECT_EQ(Pixel(*rig.backend, 100, 34), 0x02);
+  EXPECT_EQ(Pixel(*rig.backend, 116, 34), 0x02);
+}
+
+TEST(VgcIntegrationTest, TextDrawsStringFromMemory) {
+  const std::string program = R"(
+    LDA #$06
+    STA $4100
+    LDA #$14
+    STA $4101
+    LDA #$14
+    STA $4102
+    LDA #$00
+    STA $4103
+    LDA #$90
+    STA $4104
+    LDA #$03
+    STA $4105
+    LDA #$01
+    STA $4106
+    LDA #$02
+    STA $4107
+    HLT
+
+    .org $9000
+    .byte $48, $49, $0A, $31, $00, $45
+  )";
+
+  VgcRig rig = MakeAssembledVgcRig(program);
+  ASSERT_NE(rig.backend, nullptr);
+
+  auto result = rig.cpu->RunUntilHalt(3000);
+  ASSERT_EQ(result.reason, Cpu::HaltReason::Halt);
+
+  // "HI" on the first line, 10 pixels apart.
+  EXPECT_EQ(Pixel(*rig.backend, 20, 20), 0x03);   // H left stroke
+  EXPECT_EQ(Pixel(*rig.backend, 24, 26), 0x03);   // H crossbar
+  EXPECT_EQ(Pixel(*rig.backend, 34, 20), 0x03);   // I top bar
+  EXPECT_EQ(Pixel(*rig.backend, 34, 32), 0x03);   // I bottom bar
+  // "1" on the next line, 16 pixels down.
+  EXPECT_EQ(Pixel(*rig.backend, 24, 42), 0x03);
+  EXPECT_EQ(Pixel(*rig.backend, 24, 36), 0x03);
+  // The NUL stops the string before the 'E'.
+  EXPECT_EQ(Pixel(*rig.backend, 30, 36), 0x00);
+}
+
+TEST(VgcIntegrationTest, TextDoesNotReadThroughDeviceRegisters) {
+  using irata2::sim::io::InputDevice;
+  InputDevice* input = nullptr;
+  std::vector<irata2::sim::memory::Memory::RegionFactory> factories;
+  factories.push_back([&input](irata2::sim::memory::Memory& mem,
+                               irata2::sim::LatchedProcessControl& irq)
+                          -> std::unique_ptr<irata2::sim::memory::Region> {
+    return std::make_unique<irata2::sim::memory::Region>(
+        "input", mem, Word{irata2::sim::io::INPUT_DEVICE_BASE},
+        [&input, &irq](irata2::sim::memory::Region& region)
+            -> std::unique_ptr<irata2::sim::memory::Module> {
+          auto device = std::make_unique<InputDevice>("input", region, irq);
+          input = device.get();
+          return device;
+        });
+  });
+  VgcRig rig = MakeAssembledVgcRig("HLT", std::move(factories));
+  ASSERT_NE(input, nullptr);
+  input->inject_key('A');
+
+  // Point TEXT at the input device's popping DATA register.
+  const uint16_t data = irata2::sim::io::INPUT_DEVICE_BASE +
+                        irata2::sim::io::input_reg::DATA;
+  rig.vgc->Write(Word{irata2::sim::io::vgc_reg::CMD},
+                 Byte{irata2::sim::io::vgc_cmd::TEXT});
+  rig.vgc->Write(Word{irata2::sim::io::vgc_reg::X0}, Byte{10});
+  rig.vgc->Write(Word{irata2::sim::io::vgc_reg::Y0}, Byte{10});
+  rig.vgc->Write(Word{irata2::sim::io::vgc_reg::X1},
+                 Byte{static_cast<uint8_t>(data & 0xFF)});
+  rig.vgc->Write(Word{irata2::sim::io::vgc_reg::Y1},
+                 Byte{static_cast<uint8_t>(data >> 8)});
+  rig.vgc->Write(Word{irata2::sim::io::vgc_reg::COLOR}, Byte{0x03});
+  rig.vgc->Write(Word{irata2::sim::io::vgc_reg::EXEC}, Byte{0x01});
+  rig.vgc->Flush();
+
+  EXPECT_EQ(input->count(), 1u);
+  EXPECT_EQ(rig.vgc->pending_commands(), 0u);
+  EXPECT_EQ(rig.backend->recorded_commands(), 0u);
 }
@@ -0,0 +1,8 @@
+if(NOT DEFINED COVERAGE_DIR)
+  message(FATAL_ERROR "COVERAGE_DIR must be set")
+endif()
+
+# Start each ctest run with an empty directory, so reruns and removed tests
+# do not pile up in the merged report.
+file(REMOVE_RECURSE "${COVERAGE_DIR}")
+file(MAKE_DIRECTORY "${COVERAGE_DIR}")